@@ -33,7 +33,7 @@ namespace RexVM {
 
 
     std::unique_ptr<AttributeInfo>
-    parseAttribute(std::istream &is, const std::vector<std::unique_ptr<ConstantInfo>> &constantInfoPool) {
+    parseAttribute(ClassFileStream &is, const std::vector<std::unique_ptr<ConstantInfo>> &constantInfoPool) {
         const StreamByteType auto attributeNameIndex = peek<u2>(is);
         const auto attributeName = getConstantStringFromPool(constantInfoPool, (const size_t) attributeNameIndex);
         const auto attrPtr = ATTRIBUTE_NAME_TAG_MAP.try_get(attributeName);
@@ -48,7 +48,7 @@ namespace RexVM {
                 return std::make_unique<ConstantValueAttribute>(is);
 
             case AttributeTagEnum::CODE:
-                return std::make_unique<CodeAttribute>(is, constantInfoPool);
+                return std::make_unique<CodeAttribute>(is);
 
             case AttributeTagEnum::STACK_MAP_TABLE:
                 //return std::make_unique<StackMapTableAttribute>(is);
@@ -151,7 +151,7 @@ namespace RexVM {
         return nullptr;
     }
 
-    ElementValue::ElementValue(std::istream &is) {
+    ElementValue::ElementValue(ClassFileStream &is) {
         read(tag, is);
         switch ((char) tag) {
             case 'B':
@@ -191,7 +191,7 @@ namespace RexVM {
     }
 
     std::unique_ptr<StackMapTableAttribute::VerificationTypeInfo>
-    StackMapTableAttribute::createVerificationTypeInfo(std::istream &is) {
+    StackMapTableAttribute::createVerificationTypeInfo(ClassFileStream &is) {
         const StreamByteType auto verificationTag = peek<u1>(is);
         const auto verificationTagEnum = static_cast<VerificationTypeTagEnum>(verificationTag);
 
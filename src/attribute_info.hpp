@@ -50,13 +50,13 @@ namespace RexVM {
     );
 
     std::unique_ptr<AttributeInfo>
-    parseAttribute(std::istream &is, const std::vector<std::unique_ptr<ConstantInfo>> &constantInfoPool);
+    parseAttribute(ClassFileStream &is, const std::vector<std::unique_ptr<ConstantInfo>> &constantInfoPool);
 
     struct AttributeInfo {
         u2 attributeNameIndex{};
         u4 attributeLength{};
 
-        explicit AttributeInfo(std::istream &is) {
+        explicit AttributeInfo(ClassFileStream &is) {
             read(attributeNameIndex, is);
             read(attributeLength, is);
         }
@@ -65,8 +65,8 @@ namespace RexVM {
     };
 
     struct SkipAttribute : public AttributeInfo {
-        explicit SkipAttribute(std::istream &is) : AttributeInfo(is) {
-            is.seekg(attributeLength, std::ios::cur);
+        explicit SkipAttribute(ClassFileStream &is) : AttributeInfo(is) {
+            is.skip(attributeLength);
         }
     };
 
@@ -76,7 +76,7 @@ namespace RexVM {
         u2 handlerPC{};
         u2 catchType{};
 
-        explicit ExceptionTable(std::istream &is) {
+        explicit ExceptionTable(ClassFileStream &is) {
             read(startPC, is);
             read(endPC, is);
             read(handlerPC, is);
@@ -84,51 +84,40 @@ namespace RexVM {
         }
     };
 
+    //只读取头部 code指向类保留的class字节 不复制
+    //紧跟在字节码后面的异常表和LineNumberTable等属性 在方法第一次执行时才解析(Method::initCodeBody)
     struct CodeAttribute : public AttributeInfo {
 
         u2 maxStack{};
         u2 maxLocals{};
         u4 codeLength{};
-        std::unique_ptr<u1[]> code;
-        u2 exceptionTableLength{};
-        std::vector<std::unique_ptr<ExceptionTable>> exceptionTables;
-        u2 attributesCount{};
-        std::vector<std::unique_ptr<AttributeInfo>> attributes;
-
-        explicit CodeAttribute(std::istream &is, const std::vector<std::unique_ptr<ConstantInfo>> &constantInfoPool)
-                : AttributeInfo(is) {
+        const u1 *code{};
+
+        explicit CodeAttribute(ClassFileStream &is) : AttributeInfo(is) {
+            const auto attributeEnd = is.peekBytes(attributeLength) + attributeLength;
             read(maxStack, is);
             read(maxLocals, is);
             read(codeLength, is);
-            if (codeLength > 0) {
-                code = readBuffer(is, codeLength);
-            }
-            read(exceptionTableLength, is);
-            for (auto i = 0; i < exceptionTableLength; ++i) {
-                exceptionTables.emplace_back(std::make_unique<ExceptionTable>(is));
-            }
-            read(attributesCount, is);
-            for (auto i = 0; i < attributesCount; ++i) {
-                attributes.emplace_back(parseAttribute(is, constantInfoPool));
-            }
+            code = is.readBytes(codeLength);
+            is.skip(CAST_SIZE_T(attributeEnd - is.ptr));
         }
     };
 
     struct ConstantValueAttribute : public AttributeInfo {
         u2 constantValueIndex{};
 
-        explicit ConstantValueAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit ConstantValueAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(constantValueIndex, is);
         }
     };
 
     struct DeprecatedAttribute : public AttributeInfo {
-        explicit DeprecatedAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit DeprecatedAttribute(ClassFileStream &is) : AttributeInfo(is) {
         }
     };
 
     struct SyntheticAttribute : public AttributeInfo {
-        explicit SyntheticAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit SyntheticAttribute(ClassFileStream &is) : AttributeInfo(is) {
         }
     };
 
@@ -136,7 +125,7 @@ namespace RexVM {
         u2 numberOfExceptions{};
         std::vector<u2> exceptionIndexTable;
 
-        explicit ExceptionsAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit ExceptionsAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfExceptions, is);
             for (auto i = 0; i < numberOfExceptions; ++i) {
                 exceptionIndexTable.emplace_back(read<u2>(is));
@@ -148,7 +137,7 @@ namespace RexVM {
         u2 classIndex{};
         u2 methodIndex{};
 
-        explicit EnclosingMethodAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit EnclosingMethodAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(classIndex, is);
             read(methodIndex, is);
         }
@@ -161,7 +150,7 @@ namespace RexVM {
             u2 innerNameIndex{};
             u2 innerClassAccessFlags{};
 
-            explicit InnerClassesInfo(std::istream &is) {
+            explicit InnerClassesInfo(ClassFileStream &is) {
                 read(innerClassInfoIndex, is);
                 read(outerClassInfoIndex, is);
                 read(innerNameIndex, is);
@@ -172,7 +161,7 @@ namespace RexVM {
         u2 numberOfInnerClasses{};
         std::vector<std::unique_ptr<InnerClassesInfo>> classes;
 
-        explicit InnerClassesAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit InnerClassesAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfInnerClasses, is);
             for (auto i = 0; i < numberOfInnerClasses; ++i) {
                 classes.emplace_back(std::make_unique<InnerClassesInfo>(is));
@@ -184,7 +173,7 @@ namespace RexVM {
         u2 startPC{};
         u2 lineNumber{};
 
-        explicit LineNumberInfo(std::istream &is) {
+        explicit LineNumberInfo(ClassFileStream &is) {
             read(startPC, is);
             read(lineNumber, is);
         }
@@ -194,7 +183,7 @@ namespace RexVM {
         u2 lineNumberTableLength{};
         std::vector<std::unique_ptr<LineNumberInfo>> lineNumberTables;
 
-        explicit LineNumberTableAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit LineNumberTableAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(lineNumberTableLength, is);
             for (auto i = 0; i < lineNumberTableLength; ++i) {
                 lineNumberTables.emplace_back(std::make_unique<LineNumberInfo>(is));
@@ -210,7 +199,7 @@ namespace RexVM {
             u2 descriptorIndex{};
             u2 index{};
 
-            explicit LocalVariableInfo(std::istream &is) {
+            explicit LocalVariableInfo(ClassFileStream &is) {
                 read(startPC, is);
                 read(length, is);
                 read(nameIndex, is);
@@ -222,7 +211,7 @@ namespace RexVM {
         u2 localVariableTableLength{};
         std::vector<std::unique_ptr<LocalVariableInfo>> localVariableTables;
 
-        explicit LocalVariableTableAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit LocalVariableTableAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(localVariableTableLength, is);
             for (auto i = 0; i < localVariableTableLength; ++i) {
                 localVariableTables.emplace_back(std::make_unique<LocalVariableInfo>(is));
@@ -238,7 +227,7 @@ namespace RexVM {
             u2 signatureIndex{};
             u2 index{};
 
-            explicit LocalVariableTypeInfo(std::istream &is) {
+            explicit LocalVariableTypeInfo(ClassFileStream &is) {
                 read(startPC, is);
                 read(length, is);
                 read(nameIndex, is);
@@ -250,7 +239,7 @@ namespace RexVM {
         u2 localVariableTypeTableLength{};
         std::vector<std::unique_ptr<LocalVariableTypeInfo>> localVariableTypeTables;
 
-        explicit LocalVariableTypeTableAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit LocalVariableTypeTableAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(localVariableTypeTableLength, is);
             for (auto i = 0; i < localVariableTypeTableLength; ++i) {
                 localVariableTypeTables.emplace_back(std::make_unique<LocalVariableTypeInfo>(is));
@@ -261,7 +250,7 @@ namespace RexVM {
     struct SignatureAttribute : public AttributeInfo {
         u2 signatureIndex{};
 
-        explicit SignatureAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit SignatureAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(signatureIndex, is);
         }
     };
@@ -269,7 +258,7 @@ namespace RexVM {
     struct SourceFileAttribute : public AttributeInfo {
         u2 sourceFileIndex{};
 
-        explicit SourceFileAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit SourceFileAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(sourceFileIndex, is);
         }
     };
@@ -277,7 +266,7 @@ namespace RexVM {
     struct SourceDebugExtensionAttribute : public AttributeInfo {
         std::unique_ptr<u1[]> debugExtension;
 
-        explicit SourceDebugExtensionAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit SourceDebugExtensionAttribute(ClassFileStream &is) : AttributeInfo(is) {
             if (attributeLength > 0) {
                 debugExtension = readBuffer(is, attributeLength);
             }
@@ -290,7 +279,7 @@ namespace RexVM {
             u2 numberOfBootstrapArguments{};
             std::vector<u2> bootstrapArguments;
 
-            explicit BootstrapMethod(std::istream &is) {
+            explicit BootstrapMethod(ClassFileStream &is) {
                 read(bootstrapMethodRef, is);
                 read(numberOfBootstrapArguments, is);
                 for (auto i = 0l; i < numberOfBootstrapArguments; ++i) {
@@ -302,7 +291,7 @@ namespace RexVM {
         u2 numberOfBootstrapMethods{};
         std::vector<std::unique_ptr<BootstrapMethod>> bootstrapMethods;
 
-        explicit BootstrapMethodsAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit BootstrapMethodsAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfBootstrapMethods, is);
             for (auto i = 0; i < numberOfBootstrapMethods; ++i) {
                 bootstrapMethods.emplace_back(std::make_unique<BootstrapMethod>(is));
@@ -315,7 +304,7 @@ namespace RexVM {
             u2 nameIndex{};
             u2 accessFlags{};
 
-            explicit Parameter(std::istream &is) {
+            explicit Parameter(ClassFileStream &is) {
                 read(nameIndex, is);
                 read(accessFlags, is);
             }
@@ -324,7 +313,7 @@ namespace RexVM {
         u1 numberOfParameters{};
         std::vector<std::unique_ptr<Parameter>> parameters;
 
-        explicit MethodParametersAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit MethodParametersAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfParameters, is);
             for (auto i = 0; i < numberOfParameters; ++i) {
                 parameters.emplace_back(std::make_unique<Parameter>(is));
@@ -350,7 +339,7 @@ namespace RexVM {
         struct VerificationTypeInfo {
             u1 tag{};
 
-            explicit VerificationTypeInfo(std::istream &is) {
+            explicit VerificationTypeInfo(ClassFileStream &is) {
                 read(tag, is);
             }
 
@@ -358,47 +347,47 @@ namespace RexVM {
 
         };
 
-        static std::unique_ptr<VerificationTypeInfo> createVerificationTypeInfo(std::istream &is);
+        static std::unique_ptr<VerificationTypeInfo> createVerificationTypeInfo(ClassFileStream &is);
 
         struct TopVariableInfo : public VerificationTypeInfo {
-            explicit TopVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit TopVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct IntegerVariableInfo : public VerificationTypeInfo {
-            explicit IntegerVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit IntegerVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct FloatVariableInfo : public VerificationTypeInfo {
-            explicit FloatVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit FloatVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct DoubleVariableInfo : public VerificationTypeInfo {
-            explicit DoubleVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit DoubleVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct LongVariableInfo : public VerificationTypeInfo {
-            explicit LongVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit LongVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct NullVariableInfo : public VerificationTypeInfo {
-            explicit NullVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit NullVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct UninitializedThisVariableInfo : public VerificationTypeInfo {
-            explicit UninitializedThisVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit UninitializedThisVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
             }
         };
 
         struct ObjectVariableInfo : public VerificationTypeInfo {
             u2 cPoolIndex{};
 
-            explicit ObjectVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit ObjectVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
                 read(cPoolIndex, is);
             }
         };
@@ -406,7 +395,7 @@ namespace RexVM {
         struct UninitializedVariableInfo : public VerificationTypeInfo {
             u2 offset{};
 
-            explicit UninitializedVariableInfo(std::istream &is) : VerificationTypeInfo(is) {
+            explicit UninitializedVariableInfo(ClassFileStream &is) : VerificationTypeInfo(is) {
                 read(offset, is);
             }
         };
@@ -415,7 +404,7 @@ namespace RexVM {
         struct StackMapFrame {
             u1 frameType{};
 
-            explicit StackMapFrame(std::istream &is) {
+            explicit StackMapFrame(ClassFileStream &is) {
                 read(frameType, is);
             }
 
@@ -424,13 +413,13 @@ namespace RexVM {
         };
 
         struct SameFrame : public StackMapFrame {
-            explicit SameFrame(std::istream &is) : StackMapFrame(is) {}
+            explicit SameFrame(ClassFileStream &is) : StackMapFrame(is) {}
         };
 
         struct SameLocals1StackItemFrame : public StackMapFrame {
             std::vector<std::unique_ptr<VerificationTypeInfo>> stack;
 
-            explicit SameLocals1StackItemFrame(std::istream &is) : StackMapFrame(is) {
+            explicit SameLocals1StackItemFrame(ClassFileStream &is) : StackMapFrame(is) {
                 stack.emplace_back(createVerificationTypeInfo(is));
             }
         };
@@ -439,7 +428,7 @@ namespace RexVM {
             u2 offsetDelta{};
             std::vector<std::unique_ptr<VerificationTypeInfo>> stack;
 
-            explicit SameLocals1StackItemFrameExtended(std::istream &is) : StackMapFrame(is) {
+            explicit SameLocals1StackItemFrameExtended(ClassFileStream &is) : StackMapFrame(is) {
                 read(offsetDelta, is);
                 stack.emplace_back(createVerificationTypeInfo(is));
             }
@@ -448,7 +437,7 @@ namespace RexVM {
         struct ChopFrame : public StackMapFrame {
             u2 offsetDelta{};
 
-            explicit ChopFrame(std::istream &is) : StackMapFrame(is) {
+            explicit ChopFrame(ClassFileStream &is) : StackMapFrame(is) {
                 read(offsetDelta, is);
             }
         };
@@ -456,7 +445,7 @@ namespace RexVM {
         struct SameFrameExtended : public StackMapFrame {
             u2 offsetDelta{};
 
-            explicit SameFrameExtended(std::istream &is) : StackMapFrame(is) {
+            explicit SameFrameExtended(ClassFileStream &is) : StackMapFrame(is) {
                 read(offsetDelta, is);
             }
         };
@@ -465,7 +454,7 @@ namespace RexVM {
             u2 offsetDelta{};
             std::vector<std::unique_ptr<VerificationTypeInfo>> locals;
 
-            explicit AppendFrame(std::istream &is) : StackMapFrame(is) {
+            explicit AppendFrame(ClassFileStream &is) : StackMapFrame(is) {
                 read(offsetDelta, is);
                 for (auto i = 0; i < frameType - 251; ++i) {
                     locals.emplace_back(createVerificationTypeInfo(is));
@@ -480,7 +469,7 @@ namespace RexVM {
             u2 numberOfStackItems{};
             std::vector<std::unique_ptr<VerificationTypeInfo>> stack;
 
-            explicit FullFrame(std::istream &is) : StackMapFrame(is) {
+            explicit FullFrame(ClassFileStream &is) : StackMapFrame(is) {
                 read(offsetDelta, is);
                 read(numberOfLocals, is);
                 if (numberOfLocals > 0) {
@@ -500,7 +489,7 @@ namespace RexVM {
         u2 numberOfEntries{};
         std::vector<std::unique_ptr<StackMapFrame>> entities;
 
-        static std::unique_ptr<StackMapFrame> parseStackMapFrame(std::istream &is) {
+        static std::unique_ptr<StackMapFrame> parseStackMapFrame(ClassFileStream &is) {
             const StreamByteType auto frameType = peek<u1>(is);
             if (frameType >= 0 && frameType <= 63) {
                 return std::make_unique<SameFrame>(is);
@@ -523,7 +512,7 @@ namespace RexVM {
             return nullptr;
         }
 
-        explicit StackMapTableAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit StackMapTableAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfEntries, is);
             if (numberOfEntries > 0) {
                 for (auto i = 0; i < numberOfEntries; ++i) {
@@ -558,13 +547,13 @@ namespace RexVM {
         u1 tag{};
         std::unique_ptr<Value> value;
 
-        explicit ElementValue(std::istream &is);
+        explicit ElementValue(ClassFileStream &is);
     };
 
     struct ConstValue : public Value {
         u2 constValueIndex{};
 
-        explicit ConstValue(std::istream &is) {
+        explicit ConstValue(ClassFileStream &is) {
             read(constValueIndex, is);
             push(constValueIndex);
         }
@@ -574,7 +563,7 @@ namespace RexVM {
         u2 typeNameIndex{};
         u2 constNameIndex{};
 
-        explicit EnumConstValue(std::istream &is) {
+        explicit EnumConstValue(ClassFileStream &is) {
             read(typeNameIndex, is);
             read(constNameIndex, is);
             push(typeNameIndex);
@@ -585,7 +574,7 @@ namespace RexVM {
     struct ClassInfoValue : public Value {
         u2 classInfoIndex{};
 
-        explicit ClassInfoValue(std::istream &is) {
+        explicit ClassInfoValue(ClassFileStream &is) {
             read(classInfoIndex, is);
             push(classInfoIndex);
         }
@@ -595,7 +584,7 @@ namespace RexVM {
         u2 numberOfValues{};
         std::vector<std::unique_ptr<ElementValue>> values;
 
-        explicit ArrayValue(std::istream &is) {
+        explicit ArrayValue(ClassFileStream &is) {
             read(numberOfValues, is);
             push(numberOfValues);
             for (auto i = 0; i < numberOfValues; ++i) {
@@ -611,7 +600,7 @@ namespace RexVM {
             u2 elementNameIndex{};
             std::unique_ptr<ElementValue> value;
 
-            explicit ElementValuePairs(std::istream &is) {
+            explicit ElementValuePairs(ClassFileStream &is) {
                 read(elementNameIndex, is);
                 push(elementNameIndex);
 
@@ -624,7 +613,7 @@ namespace RexVM {
         u2 numberOfElementValuePairs{};
         std::vector<std::unique_ptr<ElementValuePairs>> elementValuePairs;
 
-        explicit Annotation(std::istream &is) {
+        explicit Annotation(ClassFileStream &is) {
             read(typeIndex, is);
             read(numberOfElementValuePairs, is);
             push(typeIndex);
@@ -646,7 +635,7 @@ namespace RexVM {
         struct TypeParameterTarget : public TargetInfo {
             u1 typeParameterIndex{};
 
-            explicit TypeParameterTarget(std::istream &is) {
+            explicit TypeParameterTarget(ClassFileStream &is) {
                 read(typeParameterIndex, is);
                 push(typeParameterIndex);
             }
@@ -655,7 +644,7 @@ namespace RexVM {
         struct SuperTypeTarget : public TargetInfo {
             u2 superTypeIndex{};
 
-            explicit SuperTypeTarget(std::istream &is) {
+            explicit SuperTypeTarget(ClassFileStream &is) {
                 read(superTypeIndex, is);
                 push(superTypeIndex);
             }
@@ -665,7 +654,7 @@ namespace RexVM {
             u1 typeParameterIndex{};
             u1 boundIndex{};
 
-            explicit TypeParameterBoundTarget(std::istream &is) {
+            explicit TypeParameterBoundTarget(ClassFileStream &is) {
                 read(typeParameterIndex, is);
                 read(boundIndex, is);
                 push(typeParameterIndex);
@@ -674,14 +663,14 @@ namespace RexVM {
         };
 
         struct EmptyTarget : public TargetInfo {
-            explicit EmptyTarget(std::istream &) {
+            explicit EmptyTarget(ClassFileStream &) {
             }
         };
 
         struct FormalParameterTarget : public TargetInfo {
             u1 formalParameterIndex{};
 
-            explicit FormalParameterTarget(std::istream &is) {
+            explicit FormalParameterTarget(ClassFileStream &is) {
                 read(formalParameterIndex, is);
                 push(formalParameterIndex);
             }
@@ -690,7 +679,7 @@ namespace RexVM {
         struct ThrowsTarget : public TargetInfo {
             u2 throwsTypeIndex{};
 
-            explicit ThrowsTarget(std::istream &is) {
+            explicit ThrowsTarget(ClassFileStream &is) {
                 read(throwsTypeIndex, is);
                 push(throwsTypeIndex);
             }
@@ -702,7 +691,7 @@ namespace RexVM {
                 u2 length{};
                 u2 index{};
 
-                explicit Table(std::istream &is) {
+                explicit Table(ClassFileStream &is) {
                     read(startPC, is);
                     read(length, is);
                     read(index, is);
@@ -715,7 +704,7 @@ namespace RexVM {
             u2 tableLength{};
             std::vector<std::unique_ptr<Table>> tables;
 
-            explicit LocalVarTarget(std::istream &is) {
+            explicit LocalVarTarget(ClassFileStream &is) {
                 read(tableLength, is);
                 push(tableLength);
                 for (auto i = 0; i < tableLength; ++i) {
@@ -729,7 +718,7 @@ namespace RexVM {
         struct CatchTarget : public TargetInfo {
             u2 exceptionTableIndex{};
 
-            explicit CatchTarget(std::istream &is) {
+            explicit CatchTarget(ClassFileStream &is) {
                 read(exceptionTableIndex, is);
                 push(exceptionTableIndex);
             }
@@ -738,7 +727,7 @@ namespace RexVM {
         struct OffsetTarget : public TargetInfo {
             u2 offset{};
 
-            explicit OffsetTarget(std::istream &is) {
+            explicit OffsetTarget(ClassFileStream &is) {
                 read(offset, is);
                 push(offset);
             }
@@ -748,7 +737,7 @@ namespace RexVM {
             u2 offset{};
             u1 typeArgumentIndex{};
 
-            explicit TypeArgumentTarget(std::istream &is) {
+            explicit TypeArgumentTarget(ClassFileStream &is) {
                 read(offset, is);
                 read(typeArgumentIndex, is);
                 push(offset);
@@ -761,7 +750,7 @@ namespace RexVM {
                 u1 typePathKind{};
                 u1 typeArgumentIndex{};
 
-                explicit Path(std::istream &is) {
+                explicit Path(ClassFileStream &is) {
                     read(typePathKind, is);
                     read(typeArgumentIndex, is);
                     push(typePathKind);
@@ -772,7 +761,7 @@ namespace RexVM {
             u1 pathLength{};
             std::vector<std::unique_ptr<Path>> paths;
 
-            explicit TypePath(std::istream &is) {
+            explicit TypePath(ClassFileStream &is) {
                 read(pathLength, is);
                 push(pathLength);
                 for (auto i = 0; i < pathLength; ++i) {
@@ -788,7 +777,7 @@ namespace RexVM {
         std::unique_ptr<TypePath> targetPath;
         std::unique_ptr<Annotation> annotation;
 
-        explicit TypeAnnotation(std::istream &is) {
+        explicit TypeAnnotation(ClassFileStream &is) {
             read(targetType, is);
             if (targetType == 0x00 || targetType == 0x01) {
                 targetInfo = std::make_unique<TypeParameterTarget>(is);
@@ -828,7 +817,7 @@ namespace RexVM {
         u2 numberOfAnnotations{};
         std::vector<std::unique_ptr<Annotation>> annotations;
 
-        explicit ParameterAnnotations(std::istream &is) {
+        explicit ParameterAnnotations(ClassFileStream &is) {
             read(numberOfAnnotations, is);
             push(numberOfAnnotations);
             for (auto i = 0; i < numberOfAnnotations; ++i) {
@@ -842,18 +831,18 @@ namespace RexVM {
     struct AnnotationAttribute : public AttributeInfo {
         std::unique_ptr<ParameterAnnotations> parameterAnnotations;
 
-        explicit AnnotationAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit AnnotationAttribute(ClassFileStream &is) : AttributeInfo(is) {
             parameterAnnotations = std::make_unique<ParameterAnnotations>(is);
         }
     };
 
     struct RuntimeVisibleAnnotationsAttribute : public AnnotationAttribute {
-        explicit RuntimeVisibleAnnotationsAttribute(std::istream &is) : AnnotationAttribute(is) {
+        explicit RuntimeVisibleAnnotationsAttribute(ClassFileStream &is) : AnnotationAttribute(is) {
         }
     };
 
     struct RuntimeInvisibleAnnotationsAttribute : public AnnotationAttribute {
-        explicit RuntimeInvisibleAnnotationsAttribute(std::istream &is) : AnnotationAttribute(is) {
+        explicit RuntimeInvisibleAnnotationsAttribute(ClassFileStream &is) : AnnotationAttribute(is) {
         }
     };
 
@@ -861,7 +850,7 @@ namespace RexVM {
         u1 numberOfParameters{};
         std::vector<std::unique_ptr<ParameterAnnotations>> parameterAnnotations;
 
-        explicit RuntimeVisibleParameterAnnotationsAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit RuntimeVisibleParameterAnnotationsAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfParameters, is);
             for (auto i = 0; i < numberOfParameters; ++i) {
                 auto parameterAnnotation = std::make_unique<ParameterAnnotations>(is);
@@ -874,7 +863,7 @@ namespace RexVM {
         u1 numberOfParameters{};
         std::vector<std::unique_ptr<ParameterAnnotations>> parameterAnnotations;
 
-        explicit RuntimeInvisibleParameterAnnotationsAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit RuntimeInvisibleParameterAnnotationsAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfParameters, is);
             for (auto i = 0; i < numberOfParameters; ++i) {
                 auto parameterAnnotation = std::make_unique<ParameterAnnotations>(is);
@@ -887,7 +876,7 @@ namespace RexVM {
         u1 numberOfAnnotation{};
         std::vector<std::unique_ptr<TypeAnnotation>> typeAnnotations;
 
-        explicit RuntimeVisibleTypeAnnotationsAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit RuntimeVisibleTypeAnnotationsAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfAnnotation, is);
             for (auto i = 0; i < numberOfAnnotation; ++i) {
                 auto annotation = std::make_unique<TypeAnnotation>(is);
@@ -900,7 +889,7 @@ namespace RexVM {
         u1 numberOfAnnotation{};
         std::vector<std::unique_ptr<TypeAnnotation>> typeAnnotations;
 
-        explicit RuntimeInvisibleTypeAnnotationsAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit RuntimeInvisibleTypeAnnotationsAttribute(ClassFileStream &is) : AttributeInfo(is) {
             read(numberOfAnnotation, is);
             for (auto i = 0; i < numberOfAnnotation; ++i) {
                 auto annotation = std::make_unique<TypeAnnotation>(is);
@@ -912,17 +901,18 @@ namespace RexVM {
     struct AnnotationDefaultAttribute : public AttributeInfo {
         std::unique_ptr<ElementValue> defaultValue;
 
-        explicit AnnotationDefaultAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit AnnotationDefaultAttribute(ClassFileStream &is) : AttributeInfo(is) {
             defaultValue = std::make_unique<ElementValue>(is);
         }
     };
 
+    //注解等只在反射时使用的属性 只记录在类保留的class字节中的位置
     struct ByteStreamAttribute : public AttributeInfo {
-        std::unique_ptr<u1[]> bytes;
+        const u1 *bytes{};
 
-        explicit ByteStreamAttribute(std::istream &is) : AttributeInfo(is) {
+        explicit ByteStreamAttribute(ClassFileStream &is) : AttributeInfo(is) {
             if (attributeLength > 0) {
-                bytes = readBuffer(is, attributeLength);
+                bytes = is.readBytes(attributeLength);
             }
         }
     };
@@ -113,6 +113,8 @@ namespace RexVM {
     constexpr size_t THREAD_STACK_SLOT_SIZE = 16384;
     //128KB
     constexpr size_t THREAD_STACK_MEMORY_KB = THREAD_STACK_SLOT_SIZE * sizeof(Slot) / 1024;
+    //栈空间不足时抛出StackOverflowError 预留给异常对象构造使用的槽位
+    constexpr size_t THREAD_STACK_RESERVED_SLOT_SIZE = 512;
 
     struct Frame;
     struct VMThread;
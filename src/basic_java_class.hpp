@@ -34,6 +34,8 @@ namespace RexVM {
     inline constexpr cview JAVA_LANG_REFLECT_FIELD_NAME = "java/lang/reflect/Field";
     inline constexpr cview JAVA_LANG_INVOKE_MEMBER_NAME_NAME = "java/lang/invoke/MemberName";
     inline constexpr cview SUN_REFLECT_CONSTANT_POOL_NAME = "sun/reflect/ConstantPool";
+    inline constexpr cview JAVA_LANG_MATH_NAME = "java/lang/Math";
+    inline constexpr cview JAVA_UTIL_ARRAYS_NAME = "java/util/Arrays";
 
     enum class BasicJavaClassEnum : size_t {
         JAVA_LANG_OBJECT,
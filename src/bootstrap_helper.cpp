@@ -10,6 +10,7 @@
 #include "memory.hpp"
 #include "string_pool.hpp"
 #include "garbage_collect.hpp"
+#include "heap_snapshot.hpp"
 #include "utils/class_utils.hpp"
 
 namespace RexVM {
@@ -29,11 +30,20 @@ namespace RexVM {
             vm.garbageCollector->finalizeRunner.initFinalizeThread(vm.mainThread.get());
         };
 
-        //0是 initializeSystemClass
-        //1是 finalize
-        //2是 main or <clinit>
+        //0是 initializeSystemClass 从堆快照恢复时没有
+        //1是 写堆快照 只在dump时有
+        //2是 finalize
+        //3是 main or <clinit>
 
-        mainThread->addMethod(initializeSystemClassMethod, {});
+        if (!vm.heapSnapshotRestored) {
+            mainThread->addMethod(initializeSystemClassMethod, {});
+        }
+        if (vm.params.heapSnapshotDump) {
+            std::function<void()> dumpHeapSnapshot = [&vm]() {
+                writeHeapSnapshot(vm, *vm.mainThread, vm.params.heapSnapshotPath);
+            };
+            mainThread->addMethod(dumpHeapSnapshot);
+        }
         mainThread->addMethod(initFinalizeThread);
         return true;
     }
@@ -23,10 +23,11 @@ namespace RexVM {
     }
 
     void MethodCFG::build() {
+        method.initCodeBody();
         hasExceptionTable = !method.exceptionCatches.empty();
 
         ByteReader reader{};
-        const auto codePtr = method.code.get();
+        const auto codePtr = method.code;
         reader.init(codePtr, method.codeLength);
 
         std::vector<u4> leaders;
@@ -37,7 +38,7 @@ namespace RexVM {
 
         if (!method.exceptionCatches.empty()) {
             for (const auto &exception : method.exceptionCatches) {
-                const auto handlerPC = exception->handler;
+                const auto handlerPC = exception.handler;
                 leaders.emplace_back(handlerPC);
             }
         }
@@ -248,20 +249,20 @@ namespace RexVM {
         if (!method.exceptionCatches.empty()) {
             //添加异常
             for (const auto &exception : method.exceptionCatches) {
-                const auto handlerPC = exception->handler;
+                const auto handlerPC = exception.handler;
                 const auto handleBlockIndex = std::distance(leaders.begin(), std::ranges::lower_bound(leaders, handlerPC));
                 const auto handleMethodBlock = blocks[handleBlockIndex].get();
                 handleMethodBlock->exceptionHandlerBlock = true;
-                handleMethodBlock->catchStartPC = exception->start;
-                handleMethodBlock->catchEndPC = exception->end;
-                if (exception->catchType != 0) {
-                    if (exception->catchClass == nullptr) {
+                handleMethodBlock->catchStartPC = exception.start;
+                handleMethodBlock->catchEndPC = exception.end;
+                if (exception.catchType != 0) {
+                    if (exception.catchClass == nullptr) {
                         const auto &constantPool = method.klass.constantPool;
                         const auto exClassName =
-                                getConstantStringFromPoolByIndexInfo(constantPool, exception->catchType);
-                        exception->catchClass = method.klass.classLoader.getInstanceClass(exClassName);
+                                getConstantStringFromPoolByIndexInfo(constantPool, exception.catchType);
+                        exception.catchClass = method.klass.classLoader.getInstanceClass(exClassName);
                     }
-                    handleMethodBlock->catchClass = exception->catchClass;
+                    handleMethodBlock->catchClass = exception.catchClass;
                 }
             }
         }
@@ -14,10 +14,24 @@
 #include "exception.hpp"
 #include "attribute_info.hpp"
 #include "utils/class_utils.hpp"
+#include "utils/class_path.hpp"
 
 namespace RexVM {
 
     constexpr u2 CLASS_MEMBER_SORT_THREAHOLD = 32;
+    constexpr size_t CLASS_MEMBER_INDEX_THRESHOLD = 8;
+
+    template<typename T>
+    void buildMemberIndex(const std::vector<std::unique_ptr<T>> &members, MemberLookupMap<T> &index) {
+        //成员少时线性比较指针更快
+        if (members.size() <= CLASS_MEMBER_INDEX_THRESHOLD) {
+            return;
+        }
+        index.reserve(members.size());
+        for (const auto &item : members) {
+            index.emplace(MemberLookupKey{item->id.nameSymbol, item->id.descriptorSymbol, item->isStatic()}, item.get());
+        }
+    }
 
     Class::Class(const ClassTypeEnum type, const u2 accessFlags, cview name, ClassLoader &classLoader) :
             id(name, type),
@@ -77,6 +91,10 @@ namespace RexVM {
         return (accessFlags & CAST_U2(AccessFlagEnum::ACC_INTERFACE)) != 0;
     }
 
+    bool Class::isAbstract() const {
+        return (accessFlags & CAST_U2(AccessFlagEnum::ACC_ABSTRACT)) != 0;
+    }
+
     bool Class::isArray() const {
         return type == ClassTypeEnum::TYPE_ARRAY_CLASS || type == ClassTypeEnum::OBJ_ARRAY_CLASS;
     }
@@ -267,7 +285,8 @@ namespace RexVM {
 
 
     InstanceClass::InstanceClass(ClassLoader &classLoader, ClassFile &cf) :
-            Class(ClassTypeEnum::INSTANCE_CLASS, cf.accessFlags, cf.getThisClassName(), classLoader) {
+            Class(ClassTypeEnum::INSTANCE_CLASS, cf.accessFlags, cf.getThisClassName(), classLoader),
+            classBytes(std::move(cf.classBytes)) {
 
         sourceFile = cf.getSourceFile();
         initAttributes(cf);
@@ -278,10 +297,11 @@ namespace RexVM {
         calcFieldSlotId();
     }
 
+    InstanceClass::~InstanceClass() = default;
+
     void InstanceClass::initAttributes(ClassFile &cf) {
-        //对于ByteStreamAttribute类Attribute来说 只要把其中的字节流move出来即可
-        //basicAnnotationContainer就干了这件事 所以不怕cf释放后attribute不存在
-        //ByteStreamAttribute这个壳子不在了 里面的数据都被move了
+        //ByteStreamAttribute指向类保留的class字节(classBytes) cf释放后仍然有效
+        //basicAnnotationContainer只记录位置 反射访问时才创建byte数组
         ByteStreamAttribute *annotation = nullptr;
         ByteStreamAttribute *typeAnnotation = nullptr;
         //其他类型的atribute 需要直接move出来
@@ -354,6 +374,7 @@ namespace RexVM {
         if (fields.size() > CLASS_MEMBER_SORT_THREAHOLD) {
             std::sort(fields.begin(), fields.end(), Field::compare);
         }
+        buildMemberIndex(fields, fieldIndex);
     }
 
     void InstanceClass::initMethods(ClassFile &cf) {
@@ -372,6 +393,7 @@ namespace RexVM {
         for (const auto &item : methods) {
             item->slotId = index++;
         }
+        buildMemberIndex(methods, methodIndex);
     }
 
     void InstanceClass::initInterfaceAndSuperClass(ClassFile &cf) {
@@ -545,6 +567,12 @@ namespace RexVM {
         initStatus = ClassInitStatusEnum::INITED;
     }
 
+    void InstanceClass::markInitialized() {
+        //Thread子类的对象要创建成VMThread 分配快照中的对象之前设置
+        initSpecialType();
+        initStatus = ClassInitStatusEnum::INITED;
+    }
+
     BootstrapMethodsAttribute *InstanceClass::getBootstrapMethodAttr() const {
         return classAttributeContainer == nullptr ? nullptr :
                 CAST_BOOT_STRAP_METHODS_ATTRIBUTE(classAttributeContainer->bootstrapMethodsAttr.get());
@@ -586,6 +614,35 @@ namespace RexVM {
 
         return nullptr;
     }
+
+    template<typename T>
+    T *getClassMemberSelf(const MemberLookupKey &key, const std::vector<std::unique_ptr<T>> &members, const MemberLookupMap<T> &index) {
+        if (!index.empty()) {
+            const auto member = index.try_get(key);
+            return member == nullptr ? nullptr : *member;
+        }
+        for (const auto &item : members) {
+            if (item->is(key.name, key.descriptor, key.isStatic)) {
+                return item.get();
+            }
+        }
+        return nullptr;
+    }
+
+    //先查已解析的结果 没有再沿父类和接口查找 查找过程中不持有锁
+    template<typename T, typename Resolver>
+    T *getResolvedMember(SpinLock &lock, MemberLookupMap<T> &resolved, const MemberLookupKey &key, const Resolver &resolver) {
+        {
+            std::lock_guard guard(lock);
+            if (const auto member = resolved.try_get(key); member != nullptr) {
+                return *member;
+            }
+        }
+        T *member = resolver();
+        std::lock_guard guard(lock);
+        resolved[key] = member;
+        return member;
+    }
     
     Field *InstanceClass::getFieldSelf(cview id, bool isStatic) const {
         return getClassMemberSelf(id, isStatic, fields);
@@ -612,8 +669,41 @@ namespace RexVM {
     }
 
     Field *InstanceClass::getField(cview name, cview descriptor, bool isStatic) const {
-        rstring combineId(name, descriptor);
-        return getField(combineId.toStringView(), isStatic);
+        //没有驻留过的名字不可能是任何类的成员
+        auto &symbolTable = SymbolTable::instance();
+        const auto nameSymbol = symbolTable.find(name);
+        const auto descriptorSymbol = symbolTable.find(descriptor);
+        if (nameSymbol == nullptr || descriptorSymbol == nullptr) {
+            return nullptr;
+        }
+        return getField(nameSymbol, descriptorSymbol, isStatic);
+    }
+
+    Field *InstanceClass::getFieldSelf(const Symbol *name, const Symbol *descriptor, bool isStatic) const {
+        return getClassMemberSelf(MemberLookupKey{name, descriptor, isStatic}, fields, fieldIndex);
+    }
+
+    Field *InstanceClass::getField(const Symbol *name, const Symbol *descriptor, bool isStatic) const {
+        const MemberLookupKey key{name, descriptor, isStatic};
+        return getResolvedMember(resolvedMemberLock, resolvedFields, key, [&]() -> Field * {
+            if (const auto selfMember = getClassMemberSelf(key, fields, fieldIndex); selfMember != nullptr) {
+                return selfMember;
+            }
+
+            if (superClass != nullptr) {
+                if (const auto field = superClass->getField(name, descriptor, isStatic); field != nullptr) {
+                    return field;
+                }
+            }
+
+            for (const auto &interface : interfaces) {
+                if (const auto interfaceField = interface->getField(name, descriptor, isStatic); interfaceField != nullptr) {
+                    return interfaceField;
+                }
+            }
+
+            return nullptr;
+        });
     }
 
     Field *InstanceClass::getRefField(size_t refIndex, bool isStatic) const {
@@ -657,24 +747,56 @@ namespace RexVM {
     }
 
     Method *InstanceClass::getMethod(cview name, cview descriptor, bool isStatic) const {
-        rstring combineId(name, descriptor);
-        return getMethod(combineId.toStringView(), isStatic);
+        auto &symbolTable = SymbolTable::instance();
+        const auto nameSymbol = symbolTable.find(name);
+        const auto descriptorSymbol = symbolTable.find(descriptor);
+        if (nameSymbol == nullptr || descriptorSymbol == nullptr) {
+            return nullptr;
+        }
+        return getMethod(nameSymbol, descriptorSymbol, isStatic);
+    }
+
+    Method *InstanceClass::getMethodSelf(const Symbol *name, const Symbol *descriptor, bool isStatic) const {
+        return getClassMemberSelf(MemberLookupKey{name, descriptor, isStatic}, methods, methodIndex);
+    }
+
+    Method *InstanceClass::getMethod(const Symbol *name, const Symbol *descriptor, bool isStatic) const {
+        const MemberLookupKey key{name, descriptor, isStatic};
+        return getResolvedMember(resolvedMemberLock, resolvedMethods, key, [&]() -> Method * {
+            if (const auto selfMember = getClassMemberSelf(key, methods, methodIndex); selfMember != nullptr) {
+                return selfMember;
+            }
+
+            if (superClass != nullptr) {
+                if (const auto method = superClass->getMethod(name, descriptor, isStatic); method != nullptr) {
+                    return method;
+                }
+            }
+
+            for (const auto &interface : interfaces) {
+                if (const auto interfaceMethod = interface->getMethod(name, descriptor, isStatic);
+                        interfaceMethod != nullptr) {
+                    return interfaceMethod;
+                }
+            }
+
+            return nullptr;
+        });
     }
 
     ClassMember *InstanceClass::getMemberByRefIndex(size_t refIndex, ClassMemberTypeEnum type, bool isStatic) const {
-        const auto [className, memberName, memberDescriptor] = getConstantStringFromPoolByClassNameType(constantPool, refIndex);
+        const auto [className, memberName, memberDescriptor] = getConstantSymbolFromPoolByClassNameType(constantPool, refIndex);
         const auto memberClass = classLoader.getClass(className);
         const auto memberInstanceClass = 
             memberClass->isArray() ? 
                 classLoader.getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_OBJECT) :
                 CAST_INSTANCE_CLASS(memberClass);
 
-        rstring id(memberName, memberDescriptor);
-        
+        //常量池中的名字和描述符已经驻留 直接按指针查找
         if (type == ClassMemberTypeEnum::FIELD) {
-            return memberInstanceClass->getField(id.toStringView(), isStatic);
+            return memberInstanceClass->getField(memberName, memberDescriptor, isStatic);
         } else {
-            return memberInstanceClass->getMethod(id.toStringView(), isStatic);
+            return memberInstanceClass->getMethod(memberName, memberDescriptor, isStatic);
         }
     }
 
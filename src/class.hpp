@@ -6,20 +6,24 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <hash_table8.hpp>
 #include "composite_string.hpp"
 #include "utils/spin_lock.hpp"
+#include "utils/binary.hpp"
 #include "mirror_base.hpp"
 #include "class_attribute_container.hpp"
 
 namespace RexVM {
 
     struct ClassFile;
+    struct ClassBytes;
     struct ClassLoader;
     struct ConstantInfo;
     struct Oop;
     struct InstanceOop;
     struct MirrorOop;
     struct InstanceClass;
+    struct ArrayClass;
     struct Frame;
     struct OopManager;
     struct VMThread;
@@ -44,6 +48,8 @@ namespace RexVM {
         ClassLoader &classLoader;
         //std::atomic<ClassInitStatusEnum> initStatus{ClassInitStatusEnum::LOADED};
         volatile ClassInitStatusEnum initStatus{ClassInitStatusEnum::LOADED};
+        //高一维的数组类 第一次创建数组时链接 之后分配数组不需要再按名字查找
+        mutable std::atomic<ArrayClass *> higherDimension{};
 
         //flags: low[accessFlags(16), type(2), anonymous(1), special(3), dimension, basicType(elementType) ]high
 
@@ -62,6 +68,7 @@ namespace RexVM {
 
         [[nodiscard]] bool isInstanceClass() const;
         [[nodiscard]] bool isInterface() const;
+        [[nodiscard]] bool isAbstract() const;
         [[nodiscard]] bool isArray() const;
         [[nodiscard]] bool isJavaObjectClass() const;
         [[nodiscard]] bool isJavaCloneable() const;
@@ -94,11 +101,42 @@ namespace RexVM {
         [[nodiscard]] InstanceOop *getBoxingOopFromValue(Slot value, Frame &frame) const;
     };
 
+    //成员查找的key 名字和描述符都是驻留的符号 比较和hash只用指针
+    struct MemberLookupKey {
+        const Symbol *name;
+        const Symbol *descriptor;
+        bool isStatic;
+
+        bool operator==(const MemberLookupKey &other) const = default;
+    };
+
+    //符号按16字节对齐 指针的低位都是0 emhash8不会再打散hash 组合后用mixHash64打散
+    struct MemberLookupKeyHash {
+        size_t operator()(const MemberLookupKey &key) const {
+            auto hash = reinterpret_cast<std::uintptr_t>(key.name);
+            hash = hash * 31 + reinterpret_cast<std::uintptr_t>(key.descriptor);
+            return CAST_SIZE_T(mixHash64(hash * 2 + (key.isStatic ? 1 : 0)));
+        }
+    };
+
+    template<typename T>
+    using MemberLookupMap = emhash8::HashMap<MemberLookupKey, T *, MemberLookupKeyHash>;
+
     struct InstanceClass : Class {
         std::vector<std::unique_ptr<ConstantInfo>> constantPool;
         std::vector<std::unique_ptr<Field>> fields;
         std::vector<std::unique_ptr<Method>> methods;
+        //本类声明的成员 成员较多时才建立 创建后只读
+        MemberLookupMap<Field> fieldIndex;
+        MemberLookupMap<Method> methodIndex;
+        //包含继承成员的查找结果 找不到也缓存nullptr
+        //类不会卸载 继承关系创建后不再变化 结果一直有效
+        mutable SpinLock resolvedMemberLock;
+        mutable MemberLookupMap<Field> resolvedFields;
+        mutable MemberLookupMap<Method> resolvedMethods;
         SpinLock initLock;
+        //类的class字节 方法的字节码 异常表 行号表和注解都直接从这里读取 类不会卸载 一直保留
+        std::unique_ptr<ClassBytes> classBytes;
 
         cview sourceFile{};
         MirrorBase constantPoolMirrorBase{};
@@ -116,6 +154,7 @@ namespace RexVM {
         u2 staticSlotCount{};
         u2 signatureIndex{};
         bool overrideFinalize{false};
+        u8 classFileHash{}; //class字节码的hash 开启JIT代码缓存时才计算
 
         [[nodiscard]] MirOop *getConstantPoolMirror(Frame *frame, bool init = true);
         [[nodiscard]] BootstrapMethodsAttribute *getBootstrapMethodAttr() const;
@@ -137,20 +176,26 @@ namespace RexVM {
         explicit InstanceClass(ClassLoader &classLoader, ClassFile &cf);
         using Class::Class;
 
-        ~InstanceClass() = default;
+        ~InstanceClass();
 
         [[nodiscard]] bool notInitialize() const;
         void clinit(Frame &frame);
+        //从堆快照恢复时使用 静态字段的值由快照写入 不执行<clinit>
+        void markInitialized();
 
         [[nodiscard]] ClassMember *getMemberByRefIndex(size_t refIndex, ClassMemberTypeEnum type, bool isStatic) const;
         [[nodiscard]] Field *getFieldSelf(cview id, bool isStatic) const;
         [[nodiscard]] Field *getField(cview id, bool isStatic) const;
         [[nodiscard]] Field *getField(cview name, cview descriptor, bool isStatic) const;
+        [[nodiscard]] Field *getFieldSelf(const Symbol *name, const Symbol *descriptor, bool isStatic) const;
+        [[nodiscard]] Field *getField(const Symbol *name, const Symbol *descriptor, bool isStatic) const;
         [[nodiscard]] Field *getRefField(size_t refIndex, bool isStatic) const;
 
         [[nodiscard]] Method *getMethodSelf(cview id, bool isStatic) const;
         [[nodiscard]] Method *getMethod(cview id, bool isStatic) const;
         [[nodiscard]] Method *getMethod(cview name, cview descriptor, bool isStatic) const;
+        [[nodiscard]] Method *getMethodSelf(const Symbol *name, const Symbol *descriptor, bool isStatic) const;
+        [[nodiscard]] Method *getMethod(const Symbol *name, const Symbol *descriptor, bool isStatic) const;
         [[nodiscard]] Method *getRefMethod(size_t refIndex, bool isStatic) const;
         [[nodiscard]] cview getSignature() const;
 
@@ -163,8 +208,7 @@ namespace RexVM {
 
     struct ArrayClass : Class {
         size_t dimension{1};
-        ArrayClass *higherDimension{};
-        ArrayClass *lowerDimension{};
+        ArrayClass *lowerDimension{}; //元素是数组时指向元素的类 multianewarray逐层使用
 
         explicit ArrayClass(ClassTypeEnum type, cview name, ClassLoader &classLoader, size_t dimension);
 
@@ -6,11 +6,8 @@
 namespace RexVM {
 
     ByteTypeArrayOop *AnnotationContainer::createByteTypeArrayOop(Frame &frame) const {
-        if (composite.data.getPtr() != nullptr) {
-            return frame.mem.newByteArrayOop(
-                CAST_SIZE_T(composite.data.getData()), 
-                composite.data.getPtr()
-            );
+        if (bytes != nullptr) {
+            return frame.mem.newByteArrayOop(CAST_SIZE_T(length), bytes);
         }
         return nullptr;
     }
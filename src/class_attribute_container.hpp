@@ -2,6 +2,7 @@
 #define CLASS_ATTRIBUTE_CONTAINER_HPP
 #include "basic.hpp"
 #include "composite_string.hpp"
+#include "symbol_table.hpp"
 #include "attribute_info.hpp"
 #include "basic_type.hpp"
 
@@ -10,12 +11,15 @@ namespace RexVM {
     struct ByteTypeArrayOop;
     struct Frame;
 
+    //指向类保留的class字节 反射访问时才创建byte数组
     struct AnnotationContainer {
-        CompositeArray<u1> composite;
+        const u1 *bytes{};
+        u4 length{};
 
-        explicit AnnotationContainer(ByteStreamAttribute *stream) {
+        explicit AnnotationContainer(const ByteStreamAttribute *stream) {
             if (stream != nullptr) {
-                composite.data.reset(stream->bytes.release(), CAST_U2(stream->attributeLength));
+                bytes = stream->bytes;
+                length = stream->attributeLength;
             }
         }
 
@@ -62,6 +66,9 @@ namespace RexVM {
         cview nameView;
         cview descriptorView;
         cview idView;
+        //驻留的名字和描述符 成员查找和native方法查找按指针比较
+        const Symbol *nameSymbol{};
+        const Symbol *descriptorSymbol{};
 
         cview getId() const {
             return idView;
@@ -79,7 +86,9 @@ namespace RexVM {
             id(rstring(name.data(), name.size(), descriptor.data(), descriptor.size())),
             nameView(cview(id.c_str(), name.size())),
             descriptorView(cview(id.c_str() + name.size(), descriptor.size())),
-            idView(cview(id.c_str(), id.size())) {
+            idView(cview(id.c_str(), id.size())),
+            nameSymbol(internSymbol(name)),
+            descriptorSymbol(internSymbol(descriptor)) {
             //Method
         }
 
@@ -114,6 +123,8 @@ namespace RexVM {
                 descriptorView = nameView;
             }
             idView = cview(id.c_str(), id.size());
+            nameSymbol = internSymbol(nameView);
+            descriptorSymbol = internSymbol(descriptorView);
         }
 
         static bool compare(NameDescriptorIdentifier *id1, NameDescriptorIdentifier *id2) {
@@ -2,10 +2,11 @@
 #include "attribute_info.hpp"
 #include "constant_info.hpp"
 #include "class_file.hpp"
+#include "utils/class_path.hpp"
 
 namespace RexVM {
 
-    FMBaseInfo::FMBaseInfo(std::istream &is, ClassFile &cf) : cf(cf) {
+    FMBaseInfo::FMBaseInfo(ClassFileStream &is, ClassFile &cf) : cf(cf) {
         read(accessFlags, is);
         read(nameIndex, is);
         read(descriptorIndex, is);
@@ -29,19 +30,19 @@ namespace RexVM {
         return getAssignAttributeByConstantPool(cf.constantPool, attributes, tagEnum);
     }
 
-    ClassFile::ClassFile(std::istream &is) {
+    ClassFile::ClassFile(ClassFileStream &is) {
         parserAll(is);
     }
 
     ClassFile::~ClassFile() = default;
 
-    void ClassFile::parseHeader(std::istream &is) {
+    void ClassFile::parseHeader(ClassFileStream &is) {
         read(magic, is);
         read(minorVersion, is);
         read(majorVersion, is);
     }
 
-    void ClassFile::parseConstantPool(std::istream &is) {
+    void ClassFile::parseConstantPool(ClassFileStream &is) {
         read(constantPoolCount, is);
         //Class file specification, constantPool first empty
         constantPool.reserve(constantPoolCount);
@@ -117,13 +118,13 @@ namespace RexVM {
         }
     }
 
-    void ClassFile::parseClassInfo(std::istream &is) {
+    void ClassFile::parseClassInfo(ClassFileStream &is) {
         read(accessFlags, is);
         read(thisClass, is);
         read(superClass, is);
     }
 
-    void ClassFile::parseInterfaces(std::istream &is) {
+    void ClassFile::parseInterfaces(ClassFileStream &is) {
         read(interfaceCount, is);
         if (interfaceCount > 0) {
             for (auto i = 0; i < interfaceCount; ++i) {
@@ -132,28 +133,28 @@ namespace RexVM {
         }
     }
 
-    void ClassFile::parseFields(std::istream &is) {
+    void ClassFile::parseFields(ClassFileStream &is) {
         read(fieldCount, is);
         for (auto i = 0; i < fieldCount; ++i) {
             fields.emplace_back(std::make_unique<FieldInfo>(is, *this));
         }
     }
 
-    void ClassFile::parseMethods(std::istream &is) {
+    void ClassFile::parseMethods(ClassFileStream &is) {
         read(methodCount, is);
         for (auto i = 0; i < methodCount; ++i) {
             methods.emplace_back(std::make_unique<MethodInfo>(is, *this));
         }
     }
 
-    void ClassFile::parseClassAttributes(std::istream &is) {
+    void ClassFile::parseClassAttributes(ClassFileStream &is) {
         read(attributeCount, is);
         for (auto i = 0; i < attributeCount; ++i) {
             attributes.emplace_back(parseAttribute(is, constantPool));
         }
     }
 
-    void ClassFile::parserAll(std::istream &is) {
+    void ClassFile::parserAll(ClassFileStream &is) {
         parseHeader(is);
         parseConstantPool(is);
         parseClassInfo(is);
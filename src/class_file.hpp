@@ -13,6 +13,7 @@ namespace RexVM {
     struct ConstantInfo;
     struct AttributeInfo;
     struct ClassFile;
+    struct ClassBytes;
 
     struct FMBaseInfo {
         u2 accessFlags{};
@@ -22,7 +23,7 @@ namespace RexVM {
         std::vector<std::unique_ptr<AttributeInfo>> attributes;
         ClassFile &cf;
 
-        explicit FMBaseInfo(std::istream &is, ClassFile &cf);
+        explicit FMBaseInfo(ClassFileStream &is, ClassFile &cf);
 
         ~FMBaseInfo();
 
@@ -34,12 +35,12 @@ namespace RexVM {
     };
 
     struct FieldInfo : public FMBaseInfo {
-        explicit FieldInfo(std::istream &is, ClassFile &cf) : FMBaseInfo(is, cf) {
+        explicit FieldInfo(ClassFileStream &is, ClassFile &cf) : FMBaseInfo(is, cf) {
         }
     };
 
     struct MethodInfo : public FMBaseInfo {
-        explicit MethodInfo(std::istream &is, ClassFile &cf) : FMBaseInfo(is, cf) {
+        explicit MethodInfo(ClassFileStream &is, ClassFile &cf) : FMBaseInfo(is, cf) {
         }
     };
 
@@ -62,6 +63,8 @@ namespace RexVM {
         std::vector<std::unique_ptr<MethodInfo>> methods;
         u2 attributeCount{};
         std::vector<std::unique_ptr<AttributeInfo>> attributes;
+        //解析使用的字节 字节码和注解属性都指向这里 创建类时移交给InstanceClass
+        std::unique_ptr<ClassBytes> classBytes;
 
         explicit ClassFile() = default;
 
@@ -70,23 +73,23 @@ namespace RexVM {
         ClassFile(ClassFile &&) = delete;
 
 
-        void parseHeader(std::istream &is);
+        void parseHeader(ClassFileStream &is);
 
-        void parseConstantPool(std::istream &is);
+        void parseConstantPool(ClassFileStream &is);
 
-        void parseClassInfo(std::istream &is);
+        void parseClassInfo(ClassFileStream &is);
 
-        void parseInterfaces(std::istream &is);
+        void parseInterfaces(ClassFileStream &is);
 
-        void parseFields(std::istream &is);
+        void parseFields(ClassFileStream &is);
 
-        void parseMethods(std::istream &is);
+        void parseMethods(ClassFileStream &is);
 
-        void parseClassAttributes(std::istream &is);
+        void parseClassAttributes(ClassFileStream &is);
 
-        void parserAll(std::istream &is);
+        void parserAll(ClassFileStream &is);
 
-        explicit ClassFile(std::istream &is);
+        explicit ClassFile(ClassFileStream &is);
 
         ~ClassFile();
 
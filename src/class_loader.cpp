@@ -1,7 +1,8 @@
 #include "class_loader.hpp"
 #include <mutex>
 #include <memory>
-#include <sstream>
+#include <thread>
+#include <fstream>
 #include "basic_type.hpp"
 #include "utils/class_path.hpp"
 #include "constant_info.hpp"
@@ -12,58 +13,275 @@
 #include "basic_java_class.hpp"
 #include "key_slot_id.hpp"
 #include "native/rex/rex_classes.hpp"
+#include "utils/binary.hpp"
+#include "vm.hpp"
+#include "jit_manager.hpp"
+#include "class_prefetcher.hpp"
 
 namespace RexVM {
 
     ClassLoader::ClassLoader(VM &vm, ClassPath &classPath) : vm(vm), classPath(classPath) {
+        if (vm.params.classPrefetchEnable) {
+            auto threadCount = vm.params.classPrefetchThreadCount;
+            if (threadCount == 0) {
+                //留一个核给请求线程
+                const auto coreCount = CAST_SIZE_T(std::thread::hardware_concurrency());
+                threadCount = std::min(coreCount > 1 ? coreCount - 1 : 0, CLASS_PREFETCH_MAX_THREAD_COUNT);
+            }
+            if (threadCount > 0) {
+                prefetcher = std::make_unique<ClassPrefetcher>(classPath, !vm.params.jitCodeCacheDir.empty(), threadCount);
+                if (!vm.params.classListPath.empty()) {
+                    prefetcher->prefetchClassList(vm.params.classListPath);
+                }
+            }
+        }
         loadBasicClass();
     }
 
     ClassLoader::~ClassLoader() = default;
 
+    CompiledMethodDependency::CompiledMethodDependency(Method &method) : method(method) {
+    }
+
     void ClassLoader::loadBasicClass() {
         std::lock_guard<std::recursive_mutex> lock(clMutex);
         const auto objectClass = getClass(JAVA_LANG_OBJECT_NAME);
         for (const auto item : PRIMITIVE_TYPE_ARRAY) {
             auto klass = std::make_unique<PrimitiveClass>(item, *this);
             klass->superClass = CAST_INSTANCE_CLASS(objectClass);
-            classMap.emplace_unique(klass->getClassName(), std::move(klass));
+            const auto rawPtr = klass.get();
+            addClass(std::move(klass));
+            publishClass(rawPtr);
         }
 
         //load RexVM runtime class
         loadInstanceClass(REX_PRINT_STREAM_CLASS_FILE.data(), REX_PRINT_STREAM_CLASS_FILE.size(), false);
     }
 
-    constexpr auto ANONYMOUS_CLASS_NAME_PREFIX = "ANONYMOUS";
-    InstanceClass *ClassLoader::loadInstanceClass(std::istream &is, bool notAnonymous) {
-        ClassFile cf(is);
+    InstanceClass *ClassLoader::loadInstanceClass(const u1 *ptr, size_t length, bool notAnonymous) {
+        //defineClass会直接调用到这里 字节属于调用方 类需要保留一份
+        return loadInstanceClass(ClassBytes::copyOf(ptr, length), notAnonymous);
+    }
+
+    InstanceClass *ClassLoader::loadInstanceClass(std::unique_ptr<ClassBytes> classBytes, bool notAnonymous) {
+        std::lock_guard<std::recursive_mutex> lock(clMutex);
+        //JIT代码缓存的key需要class字节码的hash
+        const auto classFileHash =
+            vm.params.jitCodeCacheDir.empty() ? 0 : fnv1aHash(classBytes->data, classBytes->length);
+        ClassFileStream classStream(classBytes->data, classBytes->length);
+        ClassFile cf(classStream);
+        cf.classBytes = std::move(classBytes);
+        return defineInstanceClass(cf, classFileHash, notAnonymous);
+    }
+
+    InstanceClass *ClassLoader::defineInstanceClass(ClassFile &cf, const u8 classFileHash, const bool notAnonymous) {
         auto instanceClass = std::make_unique<InstanceClass>(*this, cf);
+        instanceClass->classFileHash = classFileHash;
         const auto rawPtr = instanceClass.get();
         auto className = instanceClass->getClassName();
         if (!notAnonymous && classMap.contains(className)) {
             const auto newClassName = ANONYMOUS_CLASS_NAME_PREFIX + std::to_string(anonymousClassIndex.fetch_add(1));
             instanceClass->setName(newClassName);
         }
-        classMap.emplace_unique(instanceClass->getClassName(), std::move(instanceClass));
+        addClass(std::move(instanceClass));
+        addSubClass(rawPtr);
+        if (vm.jitManager != nullptr) {
+            vm.jitManager->checkCodeCache(*rawPtr);
+        }
+        //子类关系和编译依赖都处理完后才对无锁查找可见
+        publishClass(rawPtr);
+        prefetchReferencedClasses(cf);
         return rawPtr;
     }
 
-    InstanceClass *ClassLoader::loadInstanceClass(cview name) {
-        const auto fileName = cformat("{}.class", name);
-        auto streamPtr = classPath.getStream(fileName);
-        if (streamPtr == nullptr) {
-            return nullptr;
+    void ClassLoader::prefetchReferencedClasses(const ClassFile &cf) const {
+        if (prefetcher == nullptr) {
+            return;
+        }
+        //常量池中引用的类在方法执行到时才加载 提前交给工作线程解析
+        for (const auto &constantInfo : cf.constantPool) {
+            if (constantInfo == nullptr || CAST_CONSTANT_TAG_ENUM(constantInfo->tag) != ConstantTagEnum::CONSTANT_Class) {
+                continue;
+            }
+            const auto className = getConstantStringFromPool(cf.constantPool, CAST_CONSTANT_CLASS_INFO(constantInfo.get())->index);
+            if (!classMap.contains(className)) {
+                prefetcher->prefetch(className);
+            }
         }
-        return loadInstanceClass(*streamPtr, true);
     }
 
-    Class *ClassLoader::getClass(cview name) {
+    void ClassLoader::stopPrefetch() const {
+        if (prefetcher != nullptr) {
+            prefetcher->stop();
+        }
+    }
+
+    void ClassLoader::dumpClassList(const cview classListPath) const {
+        std::ofstream os{cstring(classListPath), std::ios::trunc};
+        if (!os) {
+            cprintlnErr("class list write error: {}", classListPath);
+            return;
+        }
+        for (const auto &name : loadedClassNames) {
+            os << name << '\n';
+        }
+    }
+
+    void ClassLoader::addClass(std::unique_ptr<Class> klass) {
+        const auto rawPtr = klass.get();
+        classMap.emplace_unique(rawPtr->getClassName(), std::move(klass));
+    }
+
+    void ClassLoader::publishClass(Class *klass) {
+        loadedClasses.insert(klass);
+    }
+
+    void ClassLoader::addSubClass(InstanceClass *klass) {
+        if (const auto superClass = klass->getSuperClass(); superClass != nullptr) {
+            subClassMap[superClass].emplace_back(klass);
+        }
+        for (const auto interfaceClass : klass->interfaces) {
+            subClassMap[interfaceClass].emplace_back(klass);
+        }
+        invalidateDependencies(klass);
+    }
+
+    void ClassLoader::invalidateDependencies(InstanceClass *klass) {
+        if (dependencyMap.empty()) {
+            return;
+        }
+        //新加载的类会改变它所有父类和接口上的CHA结果
+        std::vector<InstanceClass *> superTypes{klass};
+        for (size_t i = 0; i < superTypes.size(); ++i) {
+            const auto current = superTypes[i];
+            if (const auto currentDependencies = dependencyMap.try_get(current); currentDependencies != nullptr) {
+                for (const auto dependency : *currentDependencies) {
+                    invalidateDependency(*dependency);
+                }
+                dependencyMap.erase(current);
+            }
+            if (const auto superClass = current->getSuperClass(); superClass != nullptr) {
+                superTypes.emplace_back(superClass);
+            }
+            for (const auto interfaceClass : current->interfaces) {
+                superTypes.emplace_back(interfaceClass);
+            }
+        }
+    }
+
+    void ClassLoader::invalidateDependency(CompiledMethodDependency &dependency) {
+        if (dependency.invalid.exchange(true)) {
+            return;
+        }
+        //卸下编译代码 等待重新编译 正在执行的编译代码会在调用点检查invalid并去优化
+        auto &method = dependency.method;
+        //只卸下这个依赖安装的代码 期间重新编译安装的新代码不受影响
+        auto installedHandler = dependency.compiledMethodHandler;
+        if (installedHandler != nullptr
+            && method.compiledMethodHandler.compare_exchange_strong(installedHandler, nullptr, std::memory_order_acq_rel)) {
+            method.invokeCounter = 0;
+            method.markCompile = false;
+        }
+    }
+
+    CompiledMethodDependency *ClassLoader::createCompiledMethodDependency(Method &method) {
+        std::lock_guard<std::recursive_mutex> lock(clMutex);
+        auto dependency = std::make_unique<CompiledMethodDependency>(method);
+        const auto rawPtr = dependency.get();
+        dependencies.emplace_back(std::move(dependency));
+        return rawPtr;
+    }
+
+    //与FrameMemoryHandler::linkVirtualMethod的查找方式一致
+    Method *resolveVirtualMethod(const InstanceClass *klass, const cview methodName, const cview methodDescriptor) {
+        for (auto k = klass; k != nullptr; k = k->getSuperClass()) {
+            const auto method = k->getMethod(methodName, methodDescriptor, false);
+            if (method != nullptr && !method->isAbstract()) {
+                return method;
+            }
+        }
+        return nullptr;
+    }
+
+    Method *ClassLoader::findUniqueConcreteMethod(
+        InstanceClass *klass,
+        const cview methodName,
+        const cview methodDescriptor,
+        CompiledMethodDependency &dependency
+    ) {
+        //遍历klass所有已加载的子类型 如果所有可实例化的类分派到同一个方法 则返回该方法
+        //查询和登记依赖在同一把锁内完成 避免中间有子类加载而漏掉失效
         std::lock_guard<std::recursive_mutex> lock(clMutex);
+        Method *uniqueMethod{nullptr};
+        std::vector<InstanceClass *> subTypes{klass};
+        for (size_t i = 0; i < subTypes.size(); ++i) {
+            const auto current = subTypes[i];
+            if (!current->isInterface() && !current->isAbstract()) {
+                const auto method = resolveVirtualMethod(current, methodName, methodDescriptor);
+                if (method == nullptr || (uniqueMethod != nullptr && uniqueMethod != method)) {
+                    return nullptr;
+                }
+                uniqueMethod = method;
+            }
+            if (const auto subClasses = subClassMap.try_get(current); subClasses != nullptr) {
+                subTypes.insert(subTypes.end(), subClasses->begin(), subClasses->end());
+            }
+            if (subTypes.size() > CHA_MAX_SUB_TYPE_COUNT) {
+                return nullptr;
+            }
+        }
+
+        if (uniqueMethod != nullptr) {
+            dependencyMap[klass].emplace_back(&dependency);
+        }
+        return uniqueMethod;
+    }
+
+    bool ClassLoader::installCompiledMethod(CompiledMethodDependency &dependency, const CompiledMethodHandler compiledMethodHandler) {
+        std::lock_guard<std::recursive_mutex> lock(clMutex);
+        auto &method = dependency.method;
+        if (dependency.invalid) {
+            //编译期间加载了新的子类 假设已失效 等待重新编译
+            method.invokeCounter = 0;
+            method.markCompile = false;
+            return false;
+        }
+        dependency.compiledMethodHandler = compiledMethodHandler;
+        method.compiledMethodHandler.store(compiledMethodHandler, std::memory_order_release);
+        return true;
+    }
+
+    InstanceClass *ClassLoader::loadInstanceClass(cview name) {
+        InstanceClass *instanceClass{nullptr};
+        u8 classFileHash{0};
+        if (const auto cf = prefetcher != nullptr ? prefetcher->take(name, classFileHash) : nullptr; cf != nullptr) {
+            instanceClass = defineInstanceClass(*cf, classFileHash, true);
+        } else {
+            const auto fileName = cformat("{}.class", name);
+            auto classBytes = classPath.getBytes(fileName);
+            if (classBytes == nullptr) {
+                return nullptr;
+            }
+            instanceClass = loadInstanceClass(std::move(classBytes), true);
+        }
+        if (!vm.params.classListDumpPath.empty()) {
+            loadedClassNames.emplace_back(name);
+        }
+        return instanceClass;
+    }
 
+    Class *ClassLoader::getClass(cview name) {
         if (name.empty()) {
             return nullptr;
         }
 
+        //已加载的类不需要加锁
+        if (const auto klass = loadedClasses.find(name); klass != nullptr) {
+            return klass;
+        }
+
+        //加载过程整体在clMutex下 同一个类的并发加载在这里排队 拿到锁后重新确认
+        std::lock_guard<std::recursive_mutex> lock(clMutex);
         const auto iter = classMap.try_get(name);
         if (iter != nullptr) {
             return (*iter).get();
@@ -80,6 +298,15 @@ namespace RexVM {
         return nullptr;
     }
 
+    Class *ClassLoader::findLoadedClass(const cview name) {
+        if (const auto klass = loadedClasses.find(name); klass != nullptr) {
+            return klass;
+        }
+        std::lock_guard<std::recursive_mutex> lock(clMutex);
+        const auto iter = classMap.try_get(name);
+        return iter != nullptr ? (*iter).get() : nullptr;
+    }
+
     ArrayClass *ClassLoader::loadArrayClass(cview name) {
         const auto nameSize = name.size();
         size_t typeIndex = 0;
@@ -92,42 +319,69 @@ namespace RexVM {
         }
 
         std::unique_ptr<ArrayClass> arrayClass;
+        Class *componentClass{nullptr};
+        const auto componentName = name.substr(1);
         if (isBasicType(typeStart) && nameSize == 2) {
             const auto basicType = getBasicTypeByDescriptor(typeStart);
             arrayClass = std::make_unique<TypeArrayClass>(name, *this, typeIndex, basicType);
+            componentClass = findLoadedClass(getPrimitiveClassNameByDescriptor(typeStart));
         } else {
             //elementClass can lazy
             //auto elementClass = getInstanceClass(name.substr(typeIndex + 1, nameSize - typeIndex - 2));
             InstanceClass *elementClass = nullptr; 
             arrayClass = std::make_unique<ObjArrayClass>(name, *this, typeIndex, elementClass);
+            if (componentName[0] == '[') {
+                //低一维的数组类创建没有代价 直接加载 multianewarray依赖这个链接
+                componentClass = getClass(componentName);
+                arrayClass->lowerDimension = CAST_ARRAY_CLASS(componentClass);
+            } else {
+                //元素类还没加载时不在这里触发加载 getObjectArrayClass会补上链接
+                componentClass = findLoadedClass(componentName.substr(1, componentName.size() - 2));
+            }
         }
 
-        // if (typeIndex != 1) {
-        //     const auto subClassName = name.substr(1);
-        //     const auto subClass = CAST_ARRAY_CLASS(getClass(subClassName));
-        //     arrayClass->lowerDimension = subClass;
-        //     subClass->higherDimension = arrayClass.get();
-        // }
-
         arrayClass->initStatus = ClassInitStatusEnum::INITED;
         const auto objectClass = getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_OBJECT);
         arrayClass->superClass = objectClass;
         const auto rawPtr = arrayClass.get();
-        classMap.emplace_unique(arrayClass->getClassName(), std::move(arrayClass));
+        addClass(std::move(arrayClass));
+        publishClass(rawPtr);
+        //initStatus和superClass设置完后才发布给无锁的快速路径
+        if (rawPtr->type == ClassTypeEnum::TYPE_ARRAY_CLASS) {
+            const auto typeArrayClass = CAST_TYPE_ARRAY_CLASS(rawPtr);
+            typeArrayClasses[CAST_SIZE_T(typeArrayClass->elementType)].store(typeArrayClass, std::memory_order_release);
+        }
+        if (componentClass != nullptr) {
+            componentClass->higherDimension.store(rawPtr, std::memory_order_release);
+        }
         return rawPtr;
     }
 
     TypeArrayClass *ClassLoader::getTypeArrayClass(BasicType type) {
+        if (const auto arrayClass = typeArrayClasses[CAST_SIZE_T(type)].load(std::memory_order_acquire); arrayClass != nullptr) {
+            return arrayClass;
+        }
         const auto className = getTypeArrayClassNameByBasicType(type);
         return CAST_TYPE_ARRAY_CLASS(getClass(className));
     }
 
     ObjArrayClass *ClassLoader::getObjectArrayClass(const Class &klass) {
+        if (const auto arrayClass = klass.higherDimension.load(std::memory_order_acquire); arrayClass != nullptr) {
+            return CAST_OBJ_ARRAY_CLASS(arrayClass);
+        }
         const auto arrayClassName = cformat("[{}", klass.getClassDescriptor());
-        return CAST_OBJ_ARRAY_CLASS(getClass(arrayClassName));
+        const auto arrayClass = CAST_OBJ_ARRAY_CLASS(getClass(arrayClassName));
+        //数组类比元素类先创建时 在这里补上链接
+        klass.higherDimension.store(arrayClass, std::memory_order_release);
+        return arrayClass;
     }
 
     void ClassLoader::initBasicJavaClass() {
+        if (prefetcher != nullptr) {
+            for (const auto &item : BASIC_JAVA_CLASS_NAMES) {
+                prefetcher->prefetch(item);
+            }
+        }
         for (const auto &item : BASIC_JAVA_CLASS_NAMES) {
             basicJavaClass.emplace_back(getInstanceClass(item));
         }
@@ -139,6 +393,9 @@ namespace RexVM {
         stringClassValueFieldSlotId =
             getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_STRING)
                 ->getFieldSelf("value" "[C", false)->slotId;
+        stringClassHashFieldSlotId =
+            getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_STRING)
+                ->getFieldSelf("hash" "I", false)->slotId;
 
         const auto threadClass = getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_THREAD);
         threadClassThreadStatusFieldSlotId = threadClass->getField("threadStatus" "I", false)->slotId;
@@ -166,12 +423,4 @@ namespace RexVM {
         return basicJavaClass[CAST_SIZE_T(classEnum)];
     }
 
-    InstanceClass *ClassLoader::loadInstanceClass(const u1 *ptr, size_t length, bool notAnonymous) {
-        cstring buffer(length, 0);
-        auto bufferPtr = CAST_VOID_PTR(buffer.data());
-        std::memcpy(bufferPtr, ptr, length * sizeof(u1));
-        const auto classStream = std::make_unique<std::istringstream>(buffer);
-        return loadInstanceClass(*classStream, notAnonymous);
-    }
-
 }
@@ -3,12 +3,14 @@
 
 #include <memory>
 #include <vector>
+#include <array>
 #include <mutex>
 #include <atomic>
 #include <hash_table8.hpp>
 #include "basic_type.hpp"
 #include "basic.hpp"
 #include "basic_java_class.hpp"
+#include "class_table.hpp"
 
 namespace RexVM {
 
@@ -19,23 +21,55 @@ namespace RexVM {
     struct TypeArrayClass;
     struct ObjArrayClass;
     struct ClassPath;
+    struct ClassFile;
+    struct ClassBytes;
+    struct ClassPrefetcher;
     struct ClassLoader;
     struct MirrorOop;
     struct InstanceOop;
+    struct Method;
+
+    constexpr size_t CHA_MAX_SUB_TYPE_COUNT = 64;
+    constexpr size_t CLASS_PREFETCH_MAX_THREAD_COUNT = 4;
+    constexpr auto ANONYMOUS_CLASS_NAME_PREFIX = "ANONYMOUS";
+
+    //JIT编译代码基于类层次分析(CHA)做的假设 加载了新的子类后失效
+    struct CompiledMethodDependency {
+        Method &method;
+        CompiledMethodHandler compiledMethodHandler{};
+        std::atomic_bool invalid{false}; //编译代码在调用点检查 失效后去优化
+
+        explicit CompiledMethodDependency(Method &method);
+    };
 
     struct ClassLoader {
         VM &vm;
         ClassPath &classPath;
         emhash8::HashMap<cview, std::unique_ptr<Class>> classMap;
+        LoadedClassTable loadedClasses; //getClass的无锁查找路径 类完全建立后才插入
         std::recursive_mutex clMutex;
         std::vector<InstanceClass *> basicJavaClass;
         std::atomic_int anonymousClassIndex{0};
+        //基本类型数组类 按BasicType的值索引
+        std::array<std::atomic<TypeArrayClass *>, CAST_SIZE_T(BasicType::T_LONG) + 1> typeArrayClasses{};
+
+        //类的直接子类 接口的直接子接口和实现类
+        emhash8::HashMap<InstanceClass *, std::vector<InstanceClass *>> subClassMap;
+        //依赖某个类的CHA结果的编译代码
+        emhash8::HashMap<InstanceClass *, std::vector<CompiledMethodDependency *>> dependencyMap;
+        std::vector<std::unique_ptr<CompiledMethodDependency>> dependencies;
+
+        //从classpath按顺序加载的类名 退出时写入classListDumpPath
+        std::vector<cstring> loadedClassNames;
+        //最后析构 工作线程先于classMap停止
+        std::unique_ptr<ClassPrefetcher> prefetcher;
 
         explicit ClassLoader(VM &vm, ClassPath &classPath);
         ~ClassLoader();
         void initBasicJavaClass();
 
         Class *getClass(cview name);
+        Class *findLoadedClass(cview name);
         InstanceClass *getBasicJavaClass(BasicJavaClassEnum classEnum) const;
 
         template<typename T>
@@ -51,18 +85,32 @@ namespace RexVM {
         TypeArrayClass *getTypeArrayClass(BasicType type);
         ObjArrayClass *getObjectArrayClass(const Class &klass);
         InstanceClass *loadInstanceClass(const u1 *ptr, size_t length, bool notAnonymous);
-        
+        void stopPrefetch() const;
+        void dumpClassList(cview classListPath) const;
+
+        CompiledMethodDependency *createCompiledMethodDependency(Method &method);
+        Method *findUniqueConcreteMethod(InstanceClass *klass, cview methodName, cview methodDescriptor, CompiledMethodDependency &dependency);
+        bool installCompiledMethod(CompiledMethodDependency &dependency, CompiledMethodHandler compiledMethodHandler);
+
 
     private:
 
         void initKeySlotId() const;
         void loadBasicClass();
         ArrayClass *loadArrayClass(cview name);
+        void addClass(std::unique_ptr<Class> klass);
+        void publishClass(Class *klass);
+        void addSubClass(InstanceClass *klass);
+        void invalidateDependencies(InstanceClass *klass);
+        static void invalidateDependency(CompiledMethodDependency &dependency);
 
         InstanceClass *loadInstanceClass(cview name);
-        InstanceClass *loadInstanceClass(std::istream &is, bool notAnonymous);
+        InstanceClass *loadInstanceClass(std::unique_ptr<ClassBytes> classBytes, bool notAnonymous);
+        InstanceClass *defineInstanceClass(ClassFile &cf, u8 classFileHash, bool notAnonymous);
+        void prefetchReferencedClasses(const ClassFile &cf) const;
     };
 
+    Method *resolveVirtualMethod(const InstanceClass *klass, cview methodName, cview methodDescriptor);
 
 }
 
@@ -10,6 +10,13 @@
 #include "utils/descriptor_parser.hpp"
 #include "utils/class_utils.hpp"
 #include "native/native_manager.hpp"
+#include "method_profile.hpp"
+#include "intrinsic.hpp"
+#include "vm.hpp"
+#include "opcode.hpp"
+#include "register_code.hpp"
+#include "utils/class_path.hpp"
+#include "utils/binary.hpp"
 
 namespace RexVM {
 
@@ -94,6 +101,11 @@ namespace RexVM {
         return is(name, descriptor) && this->isStatic() == isStatic;
     }
 
+    bool ClassMember::is(const Symbol *name, const Symbol *descriptor, bool isStatic) const {
+        //符号都是驻留的 比较指针即可
+        return id.nameSymbol == name && id.descriptorSymbol == descriptor && this->isStatic() == isStatic;
+    }
+
     bool ClassMember::isConstructor() const {
         return type == ClassMemberTypeEnum::METHOD && getName() == "<init>";
     }
@@ -179,6 +191,7 @@ namespace RexVM {
         initParamSlotSize();
         initAnnotations(info);
         initCode(info);
+        initIntrinsic();
         initExceptions(info);
     }
 
@@ -222,9 +235,9 @@ namespace RexVM {
         if (isNative()) {
             nativeMethodHandler =
                     NativeManager::instance.getNativeMethod(
-                            klass.getClassName(),
-                            getName(),
-                            getDescriptor(),
+                            klass.id.nameSymbol,
+                            id.nameSymbol,
+                            id.descriptorSymbol,
                             isStatic()
                     );
             return;
@@ -232,43 +245,78 @@ namespace RexVM {
 
         if (const auto codeAttribute = CAST_CODE_ATTRIBUTE(info->getAssignAttribute(AttributeTagEnum::CODE));
                 codeAttribute != nullptr) {
-            //maxStack = codeAttribute->maxStack;
+            maxStack = codeAttribute->maxStack;
             maxLocals = codeAttribute->maxLocals;
             codeLength = codeAttribute->codeLength;
-            code = std::move(codeAttribute->code);
-            if (codeAttribute->exceptionTableLength > 0) {
-                exceptionCatches.reserve(codeAttribute->exceptionTableLength);
-                for (const auto &exTableItem: codeAttribute->exceptionTables) {
-                    auto catchItem = std::make_unique<ExceptionCatchItem>(
-                            exTableItem->startPC,
-                            exTableItem->endPC,
-                            exTableItem->handlerPC,
-                            exTableItem->catchType
-                    );
-                    exceptionCatches.emplace_back(std::move(catchItem));
+            code = codeAttribute->code;
+        }
+    }
+
+    void Method::parseCodeBody() const {
+        std::lock_guard guard(codeBodyLock);
+        if (codeBodyParsed.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        if (code != nullptr) {
+            if (klass.classLoader.vm.params.superInstructionEnable) {
+                superInstructionCode = createSuperInstructionCode(code, codeLength);
+            }
+
+            //Code属性中字节码之后依次是异常表和属性表
+            const auto &classBytes = *klass.classBytes;
+            const auto tableBegin = code + codeLength;
+            ClassFileStream is(tableBegin, CAST_SIZE_T(classBytes.data + classBytes.length - tableBegin));
+
+            const auto exceptionTableLength = read<u2>(is);
+            if (exceptionTableLength > 0) {
+                exceptionCatches.reserve(exceptionTableLength);
+                for (u2 i = 0; i < exceptionTableLength; ++i) {
+                    const auto startPC = read<u2>(is);
+                    const auto endPC = read<u2>(is);
+                    const auto handlerPC = read<u2>(is);
+                    const auto catchType = read<u2>(is);
+                    exceptionCatches.emplace_back(startPC, endPC, handlerPC, catchType);
                 }
-                codeAttribute->exceptionTables.clear();
+                initExceptionCatchIndex();
             }
 
-            if (!codeAttribute->attributes.empty()) {
-                if (const auto lineNumberTableAttribute = CAST_LINE_NUMBER_ATTRIBUTE(
-                    getAssignAttributeByConstantPool(
-                        info->cf.constantPool,
-                        codeAttribute->attributes,
-                        AttributeTagEnum::LINE_NUMBER_TABLE
-                    ));
-                    lineNumberTableAttribute != nullptr) {
-                        if (!lineNumberTableAttribute->lineNumberTables.empty()) {
-
-                            lineNumbers.reserve(lineNumberTableAttribute->lineNumberTables.size());
-                            for (const auto &attributeItem: lineNumberTableAttribute->lineNumberTables) {
-                                lineNumbers.emplace_back(
-                                        std::make_unique<LineNumberItem>(attributeItem->startPC, attributeItem->lineNumber));
-                            }
-                        }
-                        lineNumberTableAttribute->lineNumberTables.clear();
+            const auto attributesCount = read<u2>(is);
+            for (u2 i = 0; i < attributesCount; ++i) {
+                const auto attributeNameIndex = read<u2>(is);
+                const auto attributeLength = read<u4>(is);
+                if (getConstantStringFromPool(klass.constantPool, attributeNameIndex) != "LineNumberTable") {
+                    is.skip(attributeLength);
+                    continue;
+                }
+                const auto lineNumberTableLength = read<u2>(is);
+                lineNumbers.reserve(lineNumbers.size() + lineNumberTableLength);
+                for (u2 j = 0; j < lineNumberTableLength; ++j) {
+                    const auto startPC = read<u2>(is);
+                    const auto lineNumber = read<u2>(is);
+                    lineNumbers.emplace_back(startPC, lineNumber);
                 }
             }
+            std::ranges::stable_sort(lineNumbers, {}, &LineNumberItem::start);
+        }
+
+        codeBodyParsed.store(true, std::memory_order_release);
+    }
+
+    void Method::initIntrinsic() {
+        if (!klass.classLoader.vm.params.intrinsicEnable) {
+            return;
+        }
+        const auto intrinsicInfo =
+                IntrinsicManager::instance.getIntrinsic(klass.getClassName(), getName(), getDescriptor());
+        if (intrinsicInfo == nullptr) {
+            return;
+        }
+        intrinsic = intrinsicInfo->type;
+        if (!isNative()) {
+            intrinsicHandler = intrinsicInfo->handler;
+            //字节码不再执行 也就不需要编译
+            canCompile = false;
         }
     }
 
@@ -308,58 +356,126 @@ namespace RexVM {
         return classes;
     }
 
-    std::optional<i4> Method::findExceptionHandler(const InstanceClass *exClass, u4 pc) {
+    void Method::initExceptionCatchIndex() const {
+        //异常表按顺序匹配 不能排序 较大的表记录每个pc第一个覆盖它的表项 查找时从该项开始
+        if (exceptionCatches.size() < EXCEPTION_CATCH_INDEX_THRESHOLD) {
+            return;
+        }
+        const auto noCatch = CAST_U2(exceptionCatches.size());
+        exceptionCatchIndex = std::make_unique<u2[]>(codeLength);
+        std::fill_n(exceptionCatchIndex.get(), codeLength, noCatch);
+        for (auto i = CAST_U2(exceptionCatches.size()); i-- > 0;) {
+            const auto &item = exceptionCatches[i];
+            std::fill(exceptionCatchIndex.get() + item.start, exceptionCatchIndex.get() + std::min<u4>(item.end, codeLength), i);
+        }
+    }
+
+    std::optional<i4> Method::findExceptionHandler(const InstanceClass *exClass, const u4 pc) const {
+        initCodeBody();
         if (exceptionCatches.empty()) {
             return std::nullopt;
         }
 
-        for (const auto &item: exceptionCatches) {
-            if (pc >= item->start && pc < item->end) {
-                if (item->catchType == 0) {
-                    //catch (Exception ex) { xx }
-                    return item->handler;
-                }
+        size_t first = 0;
+        if (exceptionCatchIndex != nullptr) {
+            if (pc >= codeLength) {
+                return std::nullopt;
+            }
+            first = exceptionCatchIndex[pc];
+        }
+        for (auto i = first; i < exceptionCatches.size(); ++i) {
+            const auto &item = exceptionCatches[i];
+            if (pc < item.start || pc >= item.end) {
+                continue;
+            }
+            if (item.catchType == 0) {
+                //catch (Exception ex) { xx }
+                return item.handler;
+            }
 
-                if (item->catchClass == nullptr) {
-                    const auto &constantPool = klass.constantPool;
-                    const auto exClassName = getConstantStringFromPoolByIndexInfo(constantPool, item->catchType);
-                    if (exClass->getClassName() == exClassName) {
-                        //Optimize[catchClass == exClass], needn't load Exception Class
-                        return item->handler;
-                    }
-                    item->catchClass = klass.classLoader.getInstanceClass(exClassName);
+            if (item.catchClass == nullptr) {
+                //第一次匹配到该表项 在这里解析
+                const auto exClassName = getConstantStringFromPoolByIndexInfo(klass.constantPool, item.catchType);
+                if (exClass->getClassName() == exClassName) {
+                    //Optimize[catchClass == exClass], needn't load Exception Class
+                    return item.handler;
                 }
+                item.catchClass = klass.classLoader.getInstanceClass(exClassName);
+            }
 
-                const auto catchClass = item->catchClass;
-                if (catchClass == exClass || catchClass->isSuperClassOf(exClass)) {
-                    return item->handler;
-                }
+            const auto catchClass = item.catchClass;
+            if (catchClass == exClass || catchClass->isSuperClassOf(exClass)) {
+                return item.handler;
             }
         }
 
         return std::nullopt;
     }
 
-    u4 Method::getLineNumber(u4 pc) const {
-        if (isNative() || lineNumbers.empty()) {
+    u4 Method::getLineNumber(const u4 pc) const {
+        if (isNative()) {
+            return 0;
+        }
+        initCodeBody();
+        if (lineNumbers.empty()) {
+            return 0;
+        }
+
+        //最后一个start <= pc的表项
+        const auto iter = std::ranges::upper_bound(lineNumbers, pc, {}, &LineNumberItem::start);
+        if (iter == lineNumbers.begin()) {
             return 0;
         }
+        return std::prev(iter)->lineNumber;
+    }
 
-        for (i4 i = CAST_I4(lineNumbers.size()) - 1; i >= 0; --i) {
-            const auto &item = lineNumbers[i];
-            if (pc >= item->start) {
-                return item->lineNumber;
-            }
+    void Method::addDeoptPC(const u4 pc) {
+        std::lock_guard guard(deoptLock);
+        if (std::ranges::find(deoptPCs, pc) == deoptPCs.end()) {
+            deoptPCs.emplace_back(pc);
         }
+    }
 
-        return 0;
+    bool Method::isDeoptPC(const u4 pc) {
+        std::lock_guard guard(deoptLock);
+        return std::ranges::find(deoptPCs, pc) != deoptPCs.end();
     }
 
     bool Method::compare(const std::unique_ptr<Method>& a, const std::unique_ptr<Method>& b) {
         return a->id.id < b->id.id;
     }
 
-    Method::~Method() = default;
+    void Method::initProfile() {
+        if (getProfile() != nullptr) {
+            return;
+        }
+        //多个线程可能同时创建 只保留第一个
+        auto newProfile = std::make_unique<MethodProfile>(*this);
+        MethodProfile *expected = nullptr;
+        if (profile.compare_exchange_strong(expected, newProfile.get(), std::memory_order_release)) {
+            newProfile.release();
+        }
+    }
+
+    MethodProfile *Method::getProfile() const {
+        return profile.load(std::memory_order_acquire);
+    }
+
+    void Method::initRegisterCode() {
+        if (registerCodeTranslated.load(std::memory_order_relaxed) || registerCodeTranslated.exchange(true)) {
+            return;
+        }
+        registerCode.store(translateRegisterCode(*this).release(), std::memory_order_release);
+    }
+
+    RegisterCode *Method::getRegisterCode() const {
+        return registerCode.load(std::memory_order_acquire);
+    }
+
+    Method::~Method() {
+        delete profile.load();
+        delete registerCode.load();
+    }
 
 
 }
\ No newline at end of file
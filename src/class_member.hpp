@@ -6,6 +6,7 @@
 #include <vector>
 #include <algorithm>
 #include <optional>
+#include <atomic>
 #include "utils/spin_lock.hpp"
 #include "mirror_base.hpp"
 #include "composite_ptr.hpp"
@@ -21,6 +22,9 @@ namespace RexVM {
     struct LineNumberInfo;
     struct ClassFile;
     struct MirrorBase;
+    struct MethodProfile;
+    struct RegisterCode;
+    enum class IntrinsicEnum : u1;
 
     struct ClassMember {
         const NameDescriptorIdentifier id;
@@ -53,6 +57,7 @@ namespace RexVM {
         [[nodiscard]] bool is(cview id, bool isStatic) const;
         [[nodiscard]] bool is(cview name,cview descriptor) const;
         [[nodiscard]] bool is(cview name, cview descriptor, bool isStatic) const;
+        [[nodiscard]] bool is(const Symbol *name, const Symbol *descriptor, bool isStatic) const;
 
         [[nodiscard]] bool isConstructor() const;
         [[nodiscard]] bool isClInit() const;
@@ -82,8 +87,12 @@ namespace RexVM {
         static bool compare(const std::unique_ptr<Field>& a, const std::unique_ptr<Field>& b);
     };
 
+    //异常表超过这个大小时建立pc索引
+    constexpr size_t EXCEPTION_CATCH_INDEX_THRESHOLD = 8;
+
     struct ExceptionCatchItem {
-        InstanceClass *catchClass{};
+        //类初始化时解析 异常抛出时不需要再按类名加载
+        mutable InstanceClass *catchClass{};
         const u2 start;
         const u2 end;
         const u2 handler;
@@ -92,22 +101,37 @@ namespace RexVM {
         explicit ExceptionCatchItem(u2 start, u2 end, u2 handler, u2 catchType);
     };
 
+    //按start排序
     struct LineNumberItem {
-        const u2 start;
-        const u2 lineNumber;
+        u2 start;
+        u2 lineNumber;
 
         explicit LineNumberItem(u2 start, u2 lineNumber);
     };
 
     struct Method : ClassMember {
+        u2 maxStack{};
         u2 maxLocals{};
         u4 codeLength{};
         u4 invokeCounter{};
-        std::unique_ptr<u1[]> code;
-        std::vector<std::unique_ptr<ExceptionCatchItem>> exceptionCatches;
-        std::vector<std::unique_ptr<LineNumberItem>> lineNumbers;
+        //指向类保留的class字节 不复制
+        const u1 *code{};
+        //以下几项在方法第一次执行或编译时才解析(initCodeBody) 没有执行过的方法不占用内存
+        //解释器执行的字节码 常见指令序列的首个操作码替换为超级指令 pc与code一致 没有可替换的序列时为空
+        //JIT CFG和profile都读取原始的code
+        mutable std::unique_ptr<u1[]> superInstructionCode;
+        mutable std::vector<ExceptionCatchItem> exceptionCatches;
+        //异常表较大时 pc -> 第一个覆盖该pc的exceptionCatches下标 没有覆盖的为exceptionCatches.size()
+        mutable std::unique_ptr<u2[]> exceptionCatchIndex;
+        mutable std::vector<LineNumberItem> lineNumbers;
+        mutable std::atomic_bool codeBodyParsed{false};
+        mutable SpinLock codeBodyLock;
         NativeMethodHandler nativeMethodHandler{};
-        CompiledMethodHandler compiledMethodHandler{};
+        //编译线程安装 去优化和CHA失效时由解释器线程卸下
+        std::atomic<CompiledMethodHandler> compiledMethodHandler{};
+        //内建实现 不为空时解释器不执行字节码 JIT在调用点按intrinsic生成代码
+        NativeMethodHandler intrinsicHandler{};
+        IntrinsicEnum intrinsic{};
 
         CompositeArray<u2> exceptionsIndex;
         std::unique_ptr<MethodAnnotationContainer> methodAnnotationContainer;
@@ -118,6 +142,19 @@ namespace RexVM {
         std::vector<SlotTypeEnum> paramSlotType;
         bool canCompile{true};
         bool markCompile{false};
+        bool hasCachedCode{false}; //磁盘缓存中有编译代码 调用次数达到profile阈值就编译 不等编译阈值
+
+        //JIT去优化记录 重新编译时不再对这些pc做推测
+        SpinLock deoptLock;
+        std::vector<u4> deoptPCs;
+        std::atomic<u2> deoptCounter{0}; //多个线程可能同时去优化同一个方法
+
+        //解释器收集的分支和类型profile 方法变热后才创建
+        std::atomic<MethodProfile *> profile{};
+
+        //方法变热后翻译的寄存器形式 不能翻译时为空 只翻译一次
+        std::atomic<RegisterCode *> registerCode{};
+        std::atomic_bool registerCodeTranslated{false};
 
         explicit Method(InstanceClass &klass, FMBaseInfo *info, const ClassFile &cf, u2 index = 0);
 
@@ -128,9 +165,26 @@ namespace RexVM {
         [[nodiscard]] std::vector<Class *> getParamClasses() const;
         [[nodiscard]] SlotTypeEnum getParamSlotType(size_t slotIdx) const;
 
-        std::optional<i4> findExceptionHandler(const InstanceClass *exClass, u4 pc);
+        //执行 编译 查找异常处理或行号之前调用 从字节码之后的位置解析异常表和行号表
+        void initCodeBody() const {
+            if (!codeBodyParsed.load(std::memory_order_acquire)) [[unlikely]] {
+                parseCodeBody();
+            }
+        }
+
+        //catch的类在第一次匹配到该表项时加载 没有抛出过异常的方法不会加载catch类
+        std::optional<i4> findExceptionHandler(const InstanceClass *exClass, u4 pc) const;
         [[nodiscard]] u4 getLineNumber(u4 pc) const;
 
+        void addDeoptPC(u4 pc);
+        [[nodiscard]] bool isDeoptPC(u4 pc);
+
+        void initProfile();
+        [[nodiscard]] MethodProfile *getProfile() const;
+
+        void initRegisterCode();
+        [[nodiscard]] RegisterCode *getRegisterCode() const;
+
         static bool compare(const std::unique_ptr<Method>& a, const std::unique_ptr<Method>& b);
 
         ~Method();
@@ -139,7 +193,10 @@ namespace RexVM {
         void initParamSlotSize();
         void initAnnotations(FMBaseInfo *info);
         void initCode(FMBaseInfo *info);
+        void initIntrinsic();
         void initExceptions(FMBaseInfo *info);
+        void parseCodeBody() const;
+        void initExceptionCatchIndex() const;
 
 
     };
@@ -0,0 +1,281 @@
+#include "class_prefetcher.hpp"
+#include <fstream>
+#include "class_file.hpp"
+#include "constant_info.hpp"
+#include "utils/class_path.hpp"
+#include "utils/binary.hpp"
+
+namespace RexVM {
+
+    ClassPrefetcher::ClassPrefetcher(ClassPath &classPath, const bool computeHash, const size_t threadCount)
+        : classPath(classPath), computeHash(computeHash) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this]() {
+                setThreadName("Class Prefetch");
+                workerLoop();
+            });
+        }
+    }
+
+    ClassPrefetcher::~ClassPrefetcher() {
+        stop();
+    }
+
+    void ClassPrefetcher::stop() {
+        {
+            std::lock_guard guard(lock);
+            stopped = true;
+        }
+        workCondition.notify_all();
+        finishCondition.notify_all();
+        for (auto &worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    void ClassPrefetcher::prefetch(const cview name) {
+        //数组类不需要读取类文件
+        if (name.empty() || name.front() == '[') {
+            return;
+        }
+        {
+            std::lock_guard guard(lock);
+            if (stopped || !requestedNames.emplace(name).second) {
+                return;
+            }
+            const cstring className{name};
+            classes.try_emplace(className);
+            pendingNames.emplace_back(className);
+        }
+        workCondition.notify_one();
+    }
+
+    void ClassPrefetcher::prefetchClassList(const cview classListPath) {
+        std::ifstream is{cstring(classListPath)};
+        if (!is) {
+            return;
+        }
+        cstring line;
+        while (std::getline(is, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            prefetch(line);
+        }
+    }
+
+    std::unique_ptr<ClassFile> ClassPrefetcher::take(const cview name, u8 &classFileHash) {
+        const cstring className{name};
+        std::unique_lock guard(lock);
+        const auto iter = classes.find(className);
+        if (iter == classes.end()) {
+            return nullptr;
+        }
+        auto &item = iter->second;
+        if (item.state == PrefetchStateEnum::PENDING) {
+            //还没开始解析 请求线程自己加载更快 工作线程取到后会跳过
+            classes.erase(iter);
+            return nullptr;
+        }
+        //工作线程正在解析 等它完成比重新解析一次更快 等待期间不能被淘汰
+        item.waiting = true;
+        finishCondition.wait(guard, [&] {
+            return stopped || item.state == PrefetchStateEnum::FINISHED;
+        });
+        if (item.state != PrefetchStateEnum::FINISHED) {
+            item.waiting = false;
+            return nullptr;
+        }
+        auto classFile = std::move(item.classFile);
+        classFileHash = item.classFileHash;
+        classes.erase(className);
+        --finishedCount;
+        return classFile;
+    }
+
+    void ClassPrefetcher::evictFinished() {
+        //预测错误的类一直不会被取走 按解析完成的顺序淘汰
+        while (finishedCount >= CLASS_PREFETCH_READY_LIMIT && !finishedNames.empty()) {
+            const auto iter = classes.find(finishedNames.front());
+            finishedNames.pop_front();
+            if (iter != classes.end() && iter->second.state == PrefetchStateEnum::FINISHED && !iter->second.waiting) {
+                classes.erase(iter);
+                --finishedCount;
+            }
+        }
+    }
+
+    //不会panic的字节游标 只用于预检查
+    struct ClassFileChecker {
+        const u1 *ptr;
+        const u1 *end;
+
+        bool skip(const size_t size) {
+            if (CAST_SIZE_T(end - ptr) < size) {
+                return false;
+            }
+            ptr += size;
+            return true;
+        }
+
+        template<StreamByteType T>
+        bool read(T &val) {
+            if (CAST_SIZE_T(end - ptr) < sizeof(T)) {
+                return false;
+            }
+            val = RexVM::read<T>(ptr);
+            ptr += sizeof(T);
+            return true;
+        }
+
+        bool skipAttributes() {
+            u2 attributeCount{};
+            if (!read(attributeCount)) {
+                return false;
+            }
+            for (u2 i = 0; i < attributeCount; ++i) {
+                u4 length{};
+                if (!skip(sizeof(u2)) || !read(length) || !skip(length)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool skipMembers() {
+            u2 memberCount{};
+            if (!read(memberCount)) {
+                return false;
+            }
+            for (u2 i = 0; i < memberCount; ++i) {
+                //access_flags name_index descriptor_index
+                if (!skip(sizeof(u2) * 3) || !skipAttributes()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool skipConstantPool() {
+            u2 constantPoolCount{};
+            if (!read(constantPoolCount)) {
+                return false;
+            }
+            for (u4 i = 1; i < constantPoolCount; ++i) {
+                u1 tag{};
+                if (!read(tag)) {
+                    return false;
+                }
+                size_t size;
+                switch (static_cast<ConstantTagEnum>(tag)) {
+                    case ConstantTagEnum::CONSTANT_Utf8: {
+                        u2 length{};
+                        if (!read(length)) {
+                            return false;
+                        }
+                        size = length;
+                        break;
+                    }
+                    case ConstantTagEnum::CONSTANT_Class:
+                    case ConstantTagEnum::CONSTANT_String:
+                    case ConstantTagEnum::CONSTANT_MethodType:
+                        size = 2;
+                        break;
+                    case ConstantTagEnum::CONSTANT_MethodHandle:
+                        size = 3;
+                        break;
+                    case ConstantTagEnum::CONSTANT_Integer:
+                    case ConstantTagEnum::CONSTANT_Float:
+                    case ConstantTagEnum::CONSTANT_FieldRef:
+                    case ConstantTagEnum::CONSTANT_MethodRef:
+                    case ConstantTagEnum::CONSTANT_InterfaceMethodRef:
+                    case ConstantTagEnum::CONSTANT_NameAndType:
+                    case ConstantTagEnum::CONSTANT_InvokeDynamic:
+                        size = 4;
+                        break;
+                    case ConstantTagEnum::CONSTANT_Long:
+                    case ConstantTagEnum::CONSTANT_Double:
+                        size = 8;
+                        ++i;
+                        break;
+                    default:
+                        //parseConstantPool不支持的tag
+                        return false;
+                }
+                if (!skip(size)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    //ClassFile的解析遇到错误的类文件会panic 预取的类可能是任意文件(classpath目录中被截断或者正在写入的类)
+    //先检查magic和整体结构 不完整时不在工作线程中解析 由请求的线程自己加载并报错
+    static bool isWellFormedClassFile(const u1 *data, const size_t length) {
+        ClassFileChecker checker{data, data + length};
+        u4 magic{};
+        if (!checker.read(magic) || magic != MAGIC_NUMBER) {
+            return false;
+        }
+        //minor_version major_version
+        if (!checker.skip(sizeof(u2) * 2) || !checker.skipConstantPool()) {
+            return false;
+        }
+        //access_flags this_class super_class
+        u2 interfaceCount{};
+        if (!checker.skip(sizeof(u2) * 3) || !checker.read(interfaceCount) || !checker.skip(sizeof(u2) * CAST_SIZE_T(interfaceCount))) {
+            return false;
+        }
+        return checker.skipMembers() && checker.skipMembers() && checker.skipAttributes() && checker.ptr == checker.end;
+    }
+
+    void ClassPrefetcher::workerLoop() {
+        while (true) {
+            cstring name;
+            {
+                std::unique_lock guard(lock);
+                workCondition.wait(guard, [this] { return stopped || !pendingNames.empty(); });
+                if (stopped) {
+                    return;
+                }
+                name = std::move(pendingNames.front());
+                pendingNames.pop_front();
+                const auto iter = classes.find(name);
+                if (iter == classes.end() || iter->second.state != PrefetchStateEnum::PENDING) {
+                    continue;
+                }
+                iter->second.state = PrefetchStateEnum::LOADING;
+            }
+
+            //解压和解析都不需要clMutex
+            std::unique_ptr<ClassFile> classFile;
+            u8 classFileHash{0};
+            if (auto classBytes = classPath.getBytes(cformat("{}.class", name));
+                classBytes != nullptr && isWellFormedClassFile(classBytes->data, classBytes->length)) {
+                if (computeHash) {
+                    classFileHash = fnv1aHash(classBytes->data, classBytes->length);
+                }
+                ClassFileStream classStream(classBytes->data, classBytes->length);
+                classFile = std::make_unique<ClassFile>(classStream);
+                classFile->classBytes = std::move(classBytes);
+            }
+
+            {
+                std::lock_guard guard(lock);
+                //LOADING状态的项不会被删除
+                auto &item = classes.at(name);
+                evictFinished();
+                item.classFile = std::move(classFile);
+                item.classFileHash = classFileHash;
+                item.state = PrefetchStateEnum::FINISHED;
+                finishedNames.emplace_back(name);
+                ++finishedCount;
+            }
+            finishCondition.notify_all();
+        }
+    }
+
+}
@@ -0,0 +1,70 @@
+#ifndef CLASS_PREFETCHER_HPP
+#define CLASS_PREFETCHER_HPP
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include "basic.hpp"
+
+namespace RexVM {
+
+    struct ClassPath;
+    struct ClassFile;
+
+    //同时保留的已解析但还没被取走的类 超过后丢弃最早解析完的
+    constexpr size_t CLASS_PREFETCH_READY_LIMIT = 512;
+
+    enum class PrefetchStateEnum {
+        PENDING,
+        LOADING,
+        FINISHED,
+    };
+
+    struct PrefetchedClass {
+        PrefetchStateEnum state{PrefetchStateEnum::PENDING};
+        std::unique_ptr<ClassFile> classFile;
+        u8 classFileHash{0};
+        bool waiting{false}; //有线程在等待它解析完成
+    };
+
+    //类加载流水线 预测即将用到的类 在工作线程中提前解压和解析成ClassFile
+    //预测来源: 上次运行记录的类列表 已加载类常量池中引用的类
+    //链接和clinit仍然由请求的线程在clMutex下按顺序执行
+    struct ClassPrefetcher {
+        ClassPath &classPath;
+        const bool computeHash; //JIT代码缓存需要类文件的hash
+
+        std::mutex lock;
+        std::condition_variable workCondition;
+        std::condition_variable finishCondition;
+        std::deque<cstring> pendingNames;
+        std::deque<cstring> finishedNames; //按解析完成的顺序 超过上限时从前面淘汰
+        std::unordered_set<cstring> requestedNames; //预测过的类只预取一次
+        std::unordered_map<cstring, PrefetchedClass> classes;
+        size_t finishedCount{0};
+        bool stopped{false};
+        std::vector<std::thread> workers;
+
+        explicit ClassPrefetcher(ClassPath &classPath, bool computeHash, size_t threadCount);
+        ~ClassPrefetcher();
+
+        void prefetch(cview name);
+        void prefetchClassList(cview classListPath);
+
+        //取走预取的类 正在解析时等待解析完成 没有预取或者还没开始解析时返回nullptr
+        std::unique_ptr<ClassFile> take(cview name, u8 &classFileHash);
+
+        void stop();
+
+    private:
+        void workerLoop();
+        void evictFinished();
+    };
+
+}
+
+#endif
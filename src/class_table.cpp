@@ -0,0 +1,58 @@
+#include "class_table.hpp"
+#include "class.hpp"
+
+namespace RexVM {
+
+    LoadedClassTable::Table::Table(const size_t capacity)
+        : mask(capacity - 1), slots(std::make_unique<std::atomic<Class *>[]>(capacity)) {
+    }
+
+    LoadedClassTable::LoadedClassTable() {
+        tables.emplace_back(std::make_unique<Table>(LOADED_CLASS_TABLE_INIT_CAPACITY));
+        current.store(tables.back().get(), std::memory_order_release);
+    }
+
+    Class *LoadedClassTable::find(const cview name) const {
+        const auto table = current.load(std::memory_order_acquire);
+        for (auto index = std::hash<cview>{}(name) & table->mask; ; index = (index + 1) & table->mask) {
+            const auto klass = table->slots[index].load(std::memory_order_acquire);
+            if (klass == nullptr) {
+                return nullptr;
+            }
+            if (klass->getClassName() == name) {
+                return klass;
+            }
+        }
+    }
+
+    void LoadedClassTable::insertToTable(Table &table, Class *klass) {
+        auto index = std::hash<cview>{}(klass->getClassName()) & table.mask;
+        while (table.slots[index].load(std::memory_order_relaxed) != nullptr) {
+            index = (index + 1) & table.mask;
+        }
+        //release保证其他线程看到指针时 类已经构造完成
+        table.slots[index].store(klass, std::memory_order_release);
+    }
+
+    void LoadedClassTable::grow() {
+        const auto &oldTable = *tables.back();
+        auto newTable = std::make_unique<Table>((oldTable.mask + 1) * 2);
+        for (size_t i = 0; i <= oldTable.mask; ++i) {
+            if (const auto klass = oldTable.slots[i].load(std::memory_order_relaxed); klass != nullptr) {
+                insertToTable(*newTable, klass);
+            }
+        }
+        current.store(newTable.get(), std::memory_order_release);
+        tables.emplace_back(std::move(newTable));
+    }
+
+    void LoadedClassTable::insert(Class *klass) {
+        //负载因子保持在一半以下 查找的探测链很短
+        if ((count + 1) * 2 > tables.back()->mask + 1) {
+            grow();
+        }
+        insertToTable(*tables.back(), klass);
+        ++count;
+    }
+
+}
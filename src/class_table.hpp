@@ -0,0 +1,42 @@
+#ifndef CLASS_TABLE_HPP
+#define CLASS_TABLE_HPP
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "basic.hpp"
+
+namespace RexVM {
+
+    struct Class;
+
+    constexpr size_t LOADED_CLASS_TABLE_INIT_CAPACITY = 1024;
+
+    //已加载类的只读索引 类不会卸载 所以只有插入
+    //查找不加锁 插入在ClassLoader::clMutex下进行
+    //开放寻址 扩容时复制到新表再发布 旧表一直保留 正在旧表上查找的线程不受影响
+    //查找时没有找到不代表没有加载 调用方需要再加锁确认
+    struct LoadedClassTable {
+        struct Table {
+            const size_t mask;
+            std::unique_ptr<std::atomic<Class *>[]> slots;
+
+            explicit Table(size_t capacity);
+        };
+
+        std::atomic<Table *> current{nullptr};
+        std::vector<std::unique_ptr<Table>> tables;
+        size_t count{0};
+
+        explicit LoadedClassTable();
+
+        [[nodiscard]] Class *find(cview name) const;
+        void insert(Class *klass);
+
+    private:
+        static void insertToTable(Table &table, Class *klass);
+        void grow();
+    };
+
+}
+
+#endif
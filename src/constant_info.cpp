@@ -21,18 +21,21 @@ namespace RexVM {
 
 
     cview getConstantString(ConstantInfo *info) {
-        const auto utf8Info = CAST_CONSTANT_UTF_8_INFO(info);
-        return {reinterpret_cast<char *>(utf8Info->bytes.get()), utf8Info->length};
+        return CAST_CONSTANT_UTF_8_INFO(info)->symbol->view();
+    }
+
+    const Symbol *getConstantSymbol(ConstantInfo *info) {
+        return CAST_CONSTANT_UTF_8_INFO(info)->symbol;
     }
 
     rstring getConstantRString(ConstantInfo *info) {
         const auto utf8Info = CAST_CONSTANT_UTF_8_INFO(info);
-        return {reinterpret_cast<char *>(utf8Info->bytes.get()), utf8Info->length};
+        return {utf8Info->symbol->data, utf8Info->length};
     }
 
     std::tuple<const u1 *, u2> getConstantStringBytes(ConstantInfo *info) {
         const auto utf8info = CAST_CONSTANT_UTF_8_INFO(info);
-        return std::make_tuple(utf8info->bytes.get(), utf8info->length);
+        return std::make_tuple(reinterpret_cast<const u1 *>(utf8info->symbol->data), utf8info->length);
     }
 
     cview
@@ -41,6 +44,11 @@ namespace RexVM {
         return getConstantString(info);
     }
 
+    const Symbol *
+    getConstantSymbolFromPool(const std::vector<std::unique_ptr<ConstantInfo>> &pool, const size_t index) {
+        return getConstantSymbol(pool[index].get());
+    }
+
     rstring
     getConstantRStringFromPool(const std::vector<std::unique_ptr<ConstantInfo>> &pool, const size_t index) {
         const auto info = pool[index].get();
@@ -95,4 +103,17 @@ namespace RexVM {
             type
         );
     }
+
+    std::tuple<cview, const Symbol *, const Symbol *> getConstantSymbolFromPoolByClassNameType(
+        const std::vector<std::unique_ptr<ConstantInfo>> &pool,
+        const size_t index
+    ) {
+        const auto classNameAndTypeInfo = CAST_CONSTANT_CLASS_NAME_TYPE_INDEX_INFO(pool[index].get());
+        const auto nameAndTypeInfo = CAST_CONSTANT_NAME_AND_TYPE_INFO(pool[classNameAndTypeInfo->nameAndTypeIndex].get());
+        return std::make_tuple(
+            getConstantStringFromPoolByIndexInfo(pool, classNameAndTypeInfo->classIndex),
+            getConstantSymbolFromPool(pool, nameAndTypeInfo->nameIndex),
+            getConstantSymbolFromPool(pool, nameAndTypeInfo->descriptorIndex)
+        );
+    }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "basic.hpp"
 #include "composite_string.hpp"
 #include "utils/binary.hpp"
+#include "symbol_table.hpp"
 
 namespace RexVM {
 
@@ -37,7 +38,7 @@ namespace RexVM {
     struct ConstantInfo {
         u1 tag = 0;
 
-        explicit ConstantInfo(std::istream &is) {
+        explicit ConstantInfo(ClassFileStream &is) {
             read(tag, is);
         }
 
@@ -49,7 +50,7 @@ namespace RexVM {
     struct Constant1IndexInfo : public ConstantInfo {
         u2 index{};
 
-        explicit Constant1IndexInfo(std::istream &is) : ConstantInfo(is) {
+        explicit Constant1IndexInfo(ClassFileStream &is) : ConstantInfo(is) {
             read(index, is);
         }
 
@@ -60,12 +61,12 @@ namespace RexVM {
 
 
     struct ConstantClassInfo : public Constant1IndexInfo {
-        explicit ConstantClassInfo(std::istream &is) : Constant1IndexInfo(is) {
+        explicit ConstantClassInfo(ClassFileStream &is) : Constant1IndexInfo(is) {
         }
     };
 
     struct ConstantStringInfo : public Constant1IndexInfo {
-        explicit ConstantStringInfo(std::istream &is) : Constant1IndexInfo(is) {
+        explicit ConstantStringInfo(ClassFileStream &is) : Constant1IndexInfo(is) {
         }
     };
 
@@ -73,7 +74,7 @@ namespace RexVM {
         u2 classIndex{};
         u2 nameAndTypeIndex{};
 
-        explicit ConstantClassNameTypeIndexInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantClassNameTypeIndexInfo(ClassFileStream &is) : ConstantInfo(is) {
             read(classIndex, is);
             read(nameAndTypeIndex, is);
         }
@@ -85,17 +86,17 @@ namespace RexVM {
     };
 
     struct ConstantFieldInfo : public ConstantClassNameTypeIndexInfo {
-        explicit ConstantFieldInfo(std::istream &is) : ConstantClassNameTypeIndexInfo(is) {
+        explicit ConstantFieldInfo(ClassFileStream &is) : ConstantClassNameTypeIndexInfo(is) {
         }
     };
 
     struct ConstantMethodInfo : public ConstantClassNameTypeIndexInfo {
-        explicit ConstantMethodInfo(std::istream &is) : ConstantClassNameTypeIndexInfo(is) {
+        explicit ConstantMethodInfo(ClassFileStream &is) : ConstantClassNameTypeIndexInfo(is) {
         }
     };
 
     struct ConstantInterfaceMethodInfo : public ConstantClassNameTypeIndexInfo {
-        explicit ConstantInterfaceMethodInfo(std::istream &is) : ConstantClassNameTypeIndexInfo(is) {
+        explicit ConstantInterfaceMethodInfo(ClassFileStream &is) : ConstantClassNameTypeIndexInfo(is) {
         }
     };
 
@@ -103,7 +104,7 @@ namespace RexVM {
     struct ConstantIntegerInfo : public ConstantInfo {
         i4 value;
 
-        explicit ConstantIntegerInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantIntegerInfo(ClassFileStream &is) : ConstantInfo(is) {
             value = CAST_I4(read<u4>(is));
         }
 
@@ -115,7 +116,7 @@ namespace RexVM {
     struct ConstantFloatInfo : public ConstantInfo {
         f4 value;
 
-        explicit ConstantFloatInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantFloatInfo(ClassFileStream &is) : ConstantInfo(is) {
             StreamByteType auto i = read<u4>(is);
             //value = *reinterpret_cast<f4 *>(&i);
 
@@ -130,7 +131,7 @@ namespace RexVM {
     struct ConstantLongInfo : public ConstantInfo {
         i8 value;
 
-        explicit ConstantLongInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantLongInfo(ClassFileStream &is) : ConstantInfo(is) {
             value = CAST_I8(read<u8>(is));
         }
 
@@ -142,7 +143,7 @@ namespace RexVM {
     struct ConstantDoubleInfo : public ConstantInfo {
         f8 value;
 
-        explicit ConstantDoubleInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantDoubleInfo(ClassFileStream &is) : ConstantInfo(is) {
             u8 i = read<u8>(is);
             //type1
             // union { u8 t1; f8 t2; } u1 = { .t1 = i};
@@ -164,7 +165,7 @@ namespace RexVM {
         u2 nameIndex{};
         u2 descriptorIndex{};
 
-        explicit ConstantNameAndTypeInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantNameAndTypeInfo(ClassFileStream &is) : ConstantInfo(is) {
             read(nameIndex, is);
             read(descriptorIndex, is);
         }
@@ -177,11 +178,11 @@ namespace RexVM {
 
     struct ConstantUTF8Info : public ConstantInfo {
         u2 length{};
-        std::unique_ptr<u1[]> bytes;
+        const Symbol *symbol{}; //直接从类文件内容驻留 不再单独复制一份
 
-        explicit ConstantUTF8Info(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantUTF8Info(ClassFileStream &is) : ConstantInfo(is) {
             read(length, is);
-            bytes = readBuffer(is, length);
+            symbol = internSymbol(cview(reinterpret_cast<const char *>(is.readBytes(length)), length));
         }
 
         cstring toString() override {
@@ -193,7 +194,7 @@ namespace RexVM {
         u1 referenceKind{};
         u2 referenceIndex{};
 
-        explicit ConstantMethodHandleInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantMethodHandleInfo(ClassFileStream &is) : ConstantInfo(is) {
             read(referenceKind, is);
             read(referenceIndex, is);
         }
@@ -207,7 +208,7 @@ namespace RexVM {
     struct ConstantMethodTypeInfo : public ConstantInfo {
         u2 descriptorIndex{};
 
-        explicit ConstantMethodTypeInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantMethodTypeInfo(ClassFileStream &is) : ConstantInfo(is) {
             read(descriptorIndex, is);
         }
 
@@ -220,7 +221,7 @@ namespace RexVM {
         u2 bootstrapMethodAttrIndex{};
         u2 nameAndTypeIndex{};
 
-        explicit ConstantInvokeDynamicInfo(std::istream &is) : ConstantInfo(is) {
+        explicit ConstantInvokeDynamicInfo(ClassFileStream &is) : ConstantInfo(is) {
             read(bootstrapMethodAttrIndex, is);
             read(nameAndTypeIndex, is);
         }
@@ -232,11 +233,13 @@ namespace RexVM {
     };
 
     cview getConstantString(ConstantInfo *info);
+    const Symbol *getConstantSymbol(ConstantInfo *info);
     rstring getConstantRString(ConstantInfo *info);
 
     std::tuple<const u1 *, u2> getConstantStringBytes(ConstantInfo *info);
 
     cview getConstantStringFromPool(const std::vector<std::unique_ptr<ConstantInfo>> &pool, size_t index);
+    const Symbol *getConstantSymbolFromPool(const std::vector<std::unique_ptr<ConstantInfo>> &pool, size_t index);
     rstring getConstantRStringFromPool(const std::vector<std::unique_ptr<ConstantInfo>> &pool, size_t index);
 
     std::tuple<const u1 *, u2> getConstantStringBytesFromPool(
@@ -263,6 +266,12 @@ namespace RexVM {
         const size_t index
     );
 
+    //成员引用的类名 以及成员名和描述符的Symbol
+    std::tuple<cview, const Symbol *, const Symbol *> getConstantSymbolFromPoolByClassNameType(
+        const std::vector<std::unique_ptr<ConstantInfo>> &pool,
+        const size_t index
+    );
+
 
 }
 
@@ -69,4 +69,8 @@ namespace RexVM {
     void throwIllegalThreadStateException(Frame &frame) {
         throwAssignException(frame, "java/lang/IllegalThreadStateException", {});
     }
+
+    void throwStackOverflowError(Frame &frame) {
+        throwAssignException(frame, "java/lang/StackOverflowError", {});
+    }
 }
\ No newline at end of file
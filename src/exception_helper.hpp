@@ -25,6 +25,8 @@ namespace RexVM {
     void throwRuntimeException(Frame &frame, cview message);
 
     void throwIllegalThreadStateException(Frame &frame);
+
+    void throwStackOverflowError(Frame &frame);
 }
 
 #endif
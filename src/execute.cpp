@@ -1,4 +1,5 @@
 #include "execute.hpp"
+#include <new>
 #include "basic.hpp"
 #include "utils/format.hpp"
 #include "vm.hpp"
@@ -12,6 +13,8 @@
 #include "basic_java_class.hpp"
 #include "string_pool.hpp"
 #include "jit_manager.hpp"
+#include "exception_helper.hpp"
+#include "register_code.hpp"
 
 namespace RexVM {
 
@@ -109,99 +112,221 @@ namespace RexVM {
         }
     }
 
-    void executeFrame(Frame &frame, [[maybe_unused]] cview methodName) {
+    //方法正常执行完成但没有返回
+    void checkNoReturnValue(const Frame &frame) {
+        if (frame.method.slotType != SlotTypeEnum::NONE) {
+            //not return but return slot type is not none
+            panic(cformat("Method stack error: {}", frame.method.toView()));
+        }
+    }
+
+    //一条指令执行后的检查 返回true表示当前方法已经结束(返回或者异常抛出到上一个Frame)
+    inline bool finishInstruction(Frame &frame) {
+        if (frame.markThrow && handleThrowValue(frame)) {
+            return true;
+        }
+        if (frame.markReturn) {
+            checkAndPassReturnValue(frame);
+            return true;
+        }
+        frame.reader.resetCurrentOffset();
+        return false;
+    }
+
+    //native方法 内建实现和JIT编译后的方法在这里直接执行完成 返回false表示需要解释执行字节码
+    bool enterFrame(Frame &frame) {
         auto &method = frame.method;
-        const auto notNativeMethod = !method.isNative();
+        //有内建实现的方法和native方法一样 直接调用C++实现
+        const auto notNativeMethod = !method.isNative() && method.intrinsicHandler == nullptr;
         method.invokeCounter++;
 
         frame.vm.jitManager->checkCompile(method);
+        frame.profile = method.getProfile();
 
         // printExecuteLog = true;
         PRINT_EXECUTE_LOG(printExecuteLog, frame)
 
         if (notNativeMethod) [[likely]] {
-            if (method.compiledMethodHandler != nullptr) {
-                method.compiledMethodHandler(&frame, frame.localVariableTable, frame.localVariableTableType, &frame.throwValue);
+            //去优化时其他线程可能会把compiledMethodHandler置空 先取到局部变量
+            if (const auto compiledMethodHandler = method.compiledMethodHandler.load(std::memory_order_acquire); compiledMethodHandler != nullptr) {
+                compiledMethodHandler(&frame, frame.localVariableTable, frame.localVariableTableType, &frame.throwValue);
                 if (frame.markThrow) {
                     //JIT函数的异常 可以catch的在函数里已经完成 抛出的都是无法catch的
                     handleThrowValueJIT(frame);
-                    return;
+                    return true;
                 }
                 if (frame.markReturn) {
                     checkAndPassReturnValue(frame);
-                    return;
+                    return true;
                 }
                 frame.reader.resetCurrentOffset();
-                return;
+                if (!frame.markDeopt) {
+                    return true;
+                }
+                //去优化 frame的lvt和操作数栈已经重建 从推测失败的pc处继续解释执行
+                frame.markDeopt = false;
+                frame.reader.gotoOffset(frame.pcCode);
+                return false;
             }
-
-            const auto &byteReader = frame.reader;
-            while (!byteReader.eof()) {
-                frame.pcCode = CAST_U4(byteReader.ptr - byteReader.begin);
-                frame.currentByteCode = frame.reader.readU1();
-                #ifdef DEBUG
-                ATTR_UNUSED const auto pc = frame.pc();
-                ATTR_UNUSED const auto opCode = static_cast<OpCodeEnum>(frame.currentByteCode);
-                ATTR_UNUSED const auto sourceFile = method.klass.sourceFile;
-                ATTR_UNUSED const auto lineNumber = method.getLineNumber(pc);
-                #endif
-
-                OpCodeHandlers[frame.currentByteCode](frame);
-
-                if (frame.markThrow && handleThrowValue(frame)) {
-                    return;
+            if (frame.vm.params.registerCodeEnable) {
+                if (method.invokeCounter >= frame.vm.params.registerCodeMethodInvokeCountThreshold) {
+                    method.initRegisterCode();
                 }
-                if (frame.markReturn) {
-                    checkAndPassReturnValue(frame);
-                    return;
+                //寄存器形式执行到方法结束 或者在不支持的块回到栈解释器继续执行
+                if (const auto registerCode = method.getRegisterCode(); registerCode != nullptr) {
+                    executeRegisterCode(frame, *registerCode);
+                    return finishInstruction(frame);
                 }
-                frame.reader.resetCurrentOffset();
             }
-        } else {
-            const auto nativeMethodHandler = method.nativeMethodHandler;
-            if (nativeMethodHandler == nullptr) {
-                frame.printCallStack();
-                panic(cformat("executeFrame error, method {}#{} nativeMethodHandler is nullptr", method.klass.toView(), method.toView()));
+            return false;
+        }
+
+        const auto nativeMethodHandler = method.isNative() ? method.nativeMethodHandler : method.intrinsicHandler;
+        if (nativeMethodHandler == nullptr) {
+            frame.printCallStack();
+            panic(cformat("executeFrame error, method {}#{} nativeMethodHandler is nullptr", method.klass.toView(), method.toView()));
+        }
+        nativeMethodHandler(frame);
+        if (frame.markThrow && handleThrowValue(frame)) {
+            return true;
+        }
+        if (frame.markReturn) {
+            checkAndPassReturnValue(frame);
+            return true;
+        }
+        checkNoReturnValue(frame);
+        return true;
+    }
+
+    //解释执行字节码 方法结束返回true 遇到invoke指令返回false 由executeFrame切换到被调用方法的Frame
+    bool interpretFrame(Frame &frame) {
+        const auto &byteReader = frame.reader;
+        while (!byteReader.eof()) {
+            frame.pcCode = CAST_U4(byteReader.ptr - byteReader.begin);
+            frame.currentByteCode = frame.reader.readU1();
+            #ifdef DEBUG
+            ATTR_UNUSED const auto pc = frame.pc();
+            ATTR_UNUSED const auto opCode = static_cast<OpCodeEnum>(frame.currentByteCode);
+            ATTR_UNUSED const auto sourceFile = frame.method.klass.sourceFile;
+            ATTR_UNUSED const auto lineNumber = frame.method.getLineNumber(pc);
+            #endif
+
+            OpCodeHandlers[frame.currentByteCode](frame);
+
+            if (frame.invokeTarget != nullptr) {
+                return false;
             }
-            nativeMethodHandler(frame);
-            if (frame.markThrow && handleThrowValue(frame)) {
-                return;
+            if (finishInstruction(frame)) {
+                return true;
             }
-            if (frame.markReturn) {
-                checkAndPassReturnValue(frame);
-                return;
+        }
+        checkNoReturnValue(frame);
+        return true;
+    }
+
+    //synchronized方法加锁 返回false表示方法不需要执行
+    bool beginFrame(Frame &frame) {
+        const auto &method = frame.method;
+        if (EXCLUDE_EXECUTE_METHODS(method)) {
+            return false;
+        }
+        if (method.isSynchronized()) [[unlikely]] {
+            frame.monitorHandler = method.isStatic() ? method.klass.getMirror(&frame) : frame.getThis();
+            frame.monitorHandler->lock();
+        }
+        return true;
+    }
+
+    void endFrame(const Frame &frame) {
+        if (frame.monitorHandler != nullptr) {
+            frame.monitorHandler->unlock();
+        }
+    }
+
+    //在线程的Frame存储中创建被调用方法的Frame 参数已经在prepareInvoke中从调用者的操作数栈pop
+    //栈空间不足时在调用者中抛出StackOverflowError 返回nullptr
+    Frame *pushInlineFrame(Frame &caller) {
+        auto &thread = caller.thread;
+        auto &method = *caller.invokeTarget;
+        const auto paramSlotSize = caller.invokeParamSlotSize;
+        caller.invokeTarget = nullptr;
+
+        //新Frame的lvt从调用者操作数栈顶的下一位开始 native方法最多需要2个槽位存放调用其他方法的返回值
+        const auto frameSlotSize =
+            method.isNative() ? std::max(method.paramSlotSize, paramSlotSize) + 2 : method.maxLocals + method.maxStack;
+        const auto usedSlotSize = caller.operandStackContext.getCurrentSlotPtr() + 1 - thread.stackMemory.get();
+        if (CAST_SIZE_T(usedSlotSize) + frameSlotSize + THREAD_STACK_RESERVED_SLOT_SIZE > THREAD_STACK_SLOT_SIZE) [[unlikely]] {
+            //构造StackOverflowError本身也要调用Java方法 使用预留的栈空间
+            if (thread.throwingStackOverflow || CAST_SIZE_T(usedSlotSize) + frameSlotSize > THREAD_STACK_SLOT_SIZE) {
+                caller.printCallStack();
+                panic("thread stack overflow");
             }
+            thread.throwingStackOverflow = true;
+            throwStackOverflowError(caller);
+            thread.throwingStackOverflow = false;
+            return nullptr;
         }
-        if (method.slotType != SlotTypeEnum::NONE) {
-            //not return but return slot type is not none
-            panic(cformat("Method stack error: {}", method.toView()));
+
+        auto &storage = thread.frameStorage;
+        if (thread.frameStorageTop == storage.size()) {
+            storage.emplace_back(std::make_unique<std::byte[]>(sizeof(Frame)));
+        }
+        const auto memory = storage[thread.frameStorageTop++].get();
+        return new (memory) Frame(thread, method, &caller, paramSlotSize);
+    }
+
+    void popInlineFrame(Frame &frame) {
+        auto &thread = frame.thread;
+        endFrame(frame);
+        frame.~Frame();
+        --thread.frameStorageTop;
+    }
+
+    //Java方法之间的调用和返回都在这个循环中完成 Frame对象放在线程的Frame存储中
+    //native方法和JIT代码中调用Java方法时仍然通过runMethodInner重新进入executeFrame
+    void executeFrame(Frame &frame, [[maybe_unused]] cview methodName) {
+        auto current = &frame;
+        auto finished = enterFrame(*current);
+        while (true) {
+            if (!finished) {
+                if (interpretFrame(*current)) {
+                    finished = true;
+                } else if (const auto callee = pushInlineFrame(*current); callee != nullptr) {
+                    current = callee;
+                    finished = !beginFrame(*current) || enterFrame(*current);
+                    continue;
+                } else {
+                    //创建Frame失败 调用者中已经有StackOverflowError
+                    finished = finishInstruction(*current);
+                    continue;
+                }
+            }
+
+            if (current == &frame) {
+                return;
+            }
+            //被调用的方法已经结束 返回值已经push到调用者的操作数栈中 回到调用者的invoke指令之后继续执行
+            const auto caller = current->previous;
+            popInlineFrame(*current);
+            current = caller;
+            current->mem.safePoint();
+            finished = finishInstruction(*current);
         }
     }
 
     //处理synchronized标记的方法
     inline void monitorExecuteFrame(Frame &frame) {
-        const auto &method = frame.method;
-        EXCLUDE_EXECUTE_METHODS(method)
-        auto lock = false;
-
-        //monitor execute start
-        ref monitorHandler = nullptr;
-        if (method.isSynchronized()) [[unlikely]] {
-            monitorHandler = method.isStatic() ? method.klass.getMirror(&frame) : frame.getThis();
-            monitorHandler->lock();
-            lock = true;
+        if (!beginFrame(frame)) {
+            return;
         }
 
 #ifdef DEBUG
-        executeFrame(frame, cformat("{}#{}", method.klass.toView(), method.toView()));
+        executeFrame(frame, cformat("{}#{}", frame.method.klass.toView(), frame.method.toView()));
 #else
         executeFrame(frame, "");
 #endif
 
-        if (lock) {
-            monitorHandler->unlock();
-        }
-        //monitor execute end
+        endFrame(frame);
     }
 
     void createFrameAndRunMethod(VMThread &thread, Method &method, Frame *previous, std::vector<Slot> params) {
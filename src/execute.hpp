@@ -4,7 +4,7 @@
 #include <vector>
 
 #define EXCLUDE_EXECUTE_METHOD(mref, cname, mname, desc) \
-    if (mref.getName() == mname && mref.getDescriptor() == desc && mref.klass.getClassName() == cname) { return; }
+    (mref.getName() == mname && mref.getDescriptor() == desc && mref.klass.getClassName() == cname)
 
 #define EXCLUDE_EXECUTE_METHODS(mref) \
 EXCLUDE_EXECUTE_METHOD(mref, JAVA_LANG_SYSTEM_NAME, "loadLibrary", "(Ljava/lang/String;)V")
@@ -69,14 +69,22 @@ namespace RexVM {
         thread(thread),
         method(method),
         klass(method.klass),
-        mem(FrameMemoryHandler(*this)),
-        constantPool(klass.constantPool),
-        classLoader(klass.classLoader) {
+        mem(*this) {
         thread.currentFrame = this;
         const auto nativeMethod = method.isNative();
         if (!nativeMethod) {
-            auto codePtr = method.code.get();
+            method.initCodeBody();
+            const auto codePtr = method.superInstructionCode != nullptr ? method.superInstructionCode.get() : method.code;
             reader.init(codePtr, method.codeLength);
+            //gc按类型标记扫描线程栈 参数以外的局部变量可能残留之前栈帧的REF标记 在这里清掉
+            //操作数栈只扫描到sp 栈中的槽位都会先写入再使用 不需要清理
+            if (localVariableTableSize > methodParamSlotSize) {
+                std::fill_n(
+                    localVariableTableType + methodParamSlotSize,
+                    localVariableTableSize - methodParamSlotSize,
+                    SlotTypeEnum::NONE
+                );
+            }
         }
 
         if (previous != nullptr) {
@@ -85,31 +93,7 @@ namespace RexVM {
     }
 
     Frame::~Frame() {
-        //清空此次函数所使用的栈内存 否则脏数据会影响gc root的获取
-
-        //清空lvt和操作数栈内存 操作数栈的元素数量根据maxSp来获取
-        //如果是native函数 因为不会改变maxSp 所以直接取最大值2(调用其他函数返回一个I8或者F8的情况)
-        const auto maxOperandStackSize =
-                method.nativeMethodHandler == nullptr ? operandStackContext.maxSp + 1 : 2;
-
-        i4 elementSize = CAST_I4(localVariableTableSize) + maxOperandStackSize;
-
-        auto cleanStartPtr = localVariableTable;
-        auto cleanStartTypePtr = localVariableTableType;
-        if (markReturn) {
-            // 函数返回的返回值 是通过向上一个栈做push实现的 上一个栈push后对应的位置正好是当前栈的开头
-            // 所以如果不加判断的清理 会把当前函数的返回值被清掉
-            const auto returnValueSlotCount = getSlotTypeStoreCount(returnType);
-            elementSize -= returnValueSlotCount;
-            cleanStartPtr += returnValueSlotCount;
-            cleanStartTypePtr += returnValueSlotCount;
-        }
-
-        if (elementSize > 0) {
-            std::fill_n(cleanStartPtr, elementSize, ZERO_SLOT);
-            std::fill_n(cleanStartTypePtr, elementSize, SlotTypeEnum::NONE);
-        }
-        
+        //栈内存的清理在下一个Frame创建时按需进行 见构造函数
         thread.currentFrame = previous;
     }
 
@@ -137,6 +121,20 @@ namespace RexVM {
         createFrameAndRunMethodNoPassParams(thread, runMethod, this, popSlotSize);
     }
 
+    //解释器的invoke指令使用 和runMethodInner一样先pop参数 但不在这里执行方法
+    //只记录目标方法 由executeFrame创建新Frame并继续在同一个循环中解释执行 不产生C++递归
+    void Frame::prepareInvoke(Method &runMethod) {
+        prepareInvoke(runMethod, runMethod.paramSlotSize);
+    }
+
+    void Frame::prepareInvoke(Method &runMethod, size_t popSlotSize) {
+        if (popSlotSize > 0) {
+            operandStackContext.pop(CAST_I4(popSlotSize));
+        }
+        invokeTarget = &runMethod;
+        invokeParamSlotSize = popSlotSize;
+    }
+
     //手动调用java方法用,创建新Frame,用params向其传递参数
     std::tuple<Slot, SlotTypeEnum> Frame::runMethodManual(Method &runMethod, std::vector<Slot> params) {
         createFrameAndRunMethod(thread, runMethod, this, std::move(params));
@@ -406,7 +404,7 @@ namespace RexVM {
     }
 
     void Frame::addCreateRef(ref oop) {
-        if (method.isNative() || !thread.gcSafe || method.compiledMethodHandler != nullptr) {
+        if (method.isNative() || !thread.gcSafe || method.compiledMethodHandler.load(std::memory_order_acquire) != nullptr) {
             nativeCreateRefs.emplace_back(oop);
         }
     }
@@ -17,6 +17,7 @@ namespace RexVM {
     struct InstanceClass;
     struct ObjArrayClass;
     struct Method;
+    struct MethodProfile;
     struct Oop;
     struct InstanceOop;
     struct FrameMemoryHandler;
@@ -48,19 +49,22 @@ namespace RexVM {
         FrameMemoryHandler mem;
         ByteReader reader{};
 
-        std::vector<std::unique_ptr<ConstantInfo>> &constantPool;
-        ClassLoader &classLoader;
-
         std::vector<ref> nativeCreateRefs; //native函数创建的ref 用来作为gc root 避免被异常回收
 
         bool markReturn{false};
         bool existReturnValue{false};
-        Slot returnValue{};
-        SlotTypeEnum returnType{};
-
         bool markThrow{false};
+        bool markDeopt{false}; //JIT推测失败 lvt 操作数栈和pc已重建 需要回到解释器继续执行
+        SlotTypeEnum returnType{};
+        Slot returnValue{};
         InstanceOop *throwValue{nullptr}; //for JIT
 
+        MethodProfile *profile{nullptr}; //方法的profile 未创建时为空 解释器据此记录分支和类型
+
+        Method *invokeTarget{nullptr}; //解释器中invoke指令的目标方法 由executeFrame在同一个循环中切换到新Frame执行
+        size_t invokeParamSlotSize{};
+        ref monitorHandler{nullptr}; //synchronized方法持有的锁
+
         explicit Frame(VMThread &thread, Method &method, Frame *previousFrame, size_t fixMethodParamSlotSize = 0);
         ~Frame();
 
@@ -68,6 +72,8 @@ namespace RexVM {
 
         void runMethodInner(Method &runMethod);
         void runMethodInner(Method &runMethod, size_t popSlotSize);
+        void prepareInvoke(Method &runMethod);
+        void prepareInvoke(Method &runMethod, size_t popSlotSize);
         std::tuple<Slot,SlotTypeEnum> runMethodManual(Method &runMethod_, std::vector<Slot> params);
         std::tuple<Slot, SlotTypeEnum> runMethodManualTypes(Method &runMethod, const std::vector<std::tuple<Slot, SlotTypeEnum>>& paramsWithType);
         void cleanOperandStack();
@@ -14,85 +14,90 @@
 #include "utils/descriptor_parser.hpp"
 #include "method_handle.hpp"
 #include "garbage_collect.hpp"
+#include "thread.hpp"
 
 namespace RexVM {
 
     FrameMemoryHandler::FrameMemoryHandler(Frame &frame) :
-        frame(frame), vmThread(frame.thread), oopManager(*frame.vm.oopManager), stringPool(*frame.vm.stringPool), classLoader(*frame.getCurrentClassLoader()) {
-            executeClassMemberCache.reserve(100);
+        frame(frame) {
     }
 
     InstanceOop *FrameMemoryHandler::newInstance(InstanceClass * klass) const {
-        const auto oop = oopManager.newInstance(&vmThread, klass);
+        const auto oop = frame.vm.oopManager->newInstance(&frame.thread, klass);
         frame.addCreateRef(oop);
         return oop;
     }
 
     MirOop *FrameMemoryHandler::newMirror(InstanceClass * klass, const voidPtr mirror, const MirrorObjectTypeEnum type) const {
-        const auto oop = oopManager.newMirror(&vmThread, klass, mirror, type);
+        const auto oop = frame.vm.oopManager->newMirror(&frame.thread, klass, mirror, type);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ObjArrayOop *FrameMemoryHandler::newObjArrayOop(ObjArrayClass * klass, const size_t length) const {
-        const auto oop = oopManager.newObjArrayOop(&vmThread, klass, length);
+        const auto oop = frame.vm.oopManager->newObjArrayOop(&frame.thread, klass, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ObjArrayOop *FrameMemoryHandler::newObjectObjArrayOop(const size_t length) const {
-        const auto oop = oopManager.newObjectObjArrayOop(&vmThread, length);
+        const auto oop = frame.vm.oopManager->newObjectObjArrayOop(&frame.thread, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ObjArrayOop *FrameMemoryHandler::newClassObjArrayOop(const size_t length) const {
-        const auto oop = oopManager.newClassObjArrayOop(&vmThread, length);
+        const auto oop = frame.vm.oopManager->newClassObjArrayOop(&frame.thread, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ObjArrayOop *FrameMemoryHandler::newStringObjArrayOop(const size_t length) const {
-        const auto oop = oopManager.newStringObjArrayOop(&vmThread, length);
+        const auto oop = frame.vm.oopManager->newStringObjArrayOop(&frame.thread, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     TypeArrayOop *FrameMemoryHandler::newTypeArrayOop(const BasicType type, const size_t length) const {
-        const auto oop = oopManager.newTypeArrayOop(&vmThread, type, length);
+        const auto oop = frame.vm.oopManager->newTypeArrayOop(&frame.thread, type, length);
+        frame.addCreateRef(oop);
+        return oop;
+    }
+
+    TypeArrayOop *FrameMemoryHandler::newTypeArrayOop(TypeArrayClass *klass, const size_t length) const {
+        const auto oop = frame.vm.oopManager->newTypeArrayOop(&frame.thread, klass, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ByteTypeArrayOop *FrameMemoryHandler::newByteArrayOop(const size_t length) const {
-        const auto oop = oopManager.newByteArrayOop(&vmThread, length);
+        const auto oop = frame.vm.oopManager->newByteArrayOop(&frame.thread, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ByteTypeArrayOop *FrameMemoryHandler::newByteArrayOop(const size_t length, const u1 *initBuffer) const {
-        const auto oop = oopManager.newByteArrayOop(&vmThread, length, initBuffer);
+        const auto oop = frame.vm.oopManager->newByteArrayOop(&frame.thread, length, initBuffer);
         frame.addCreateRef(oop);
         return oop;
     }
 
     CharTypeArrayOop *FrameMemoryHandler::newCharArrayOop(const size_t length) const {
-        const auto oop = oopManager.newCharArrayOop(&vmThread, length);
+        const auto oop = frame.vm.oopManager->newCharArrayOop(&frame.thread, length);
         frame.addCreateRef(oop);
         return oop;
     }
 
     ref FrameMemoryHandler::newMultiArrayOop(const u2 index, i4 *dimLength, const i2 dimCount) {
-        const auto &constantPool = frame.constantPool;
+        const auto &constantPool = frame.klass.constantPool;
         const auto className = getConstantStringFromPoolByIndexInfo(constantPool, index);
-        const auto oop = newMultiArrayOop(dimLength, dimCount, className, 0);
+        const auto oop = newMultiArrayOop(dimLength, dimCount, frame.mem.getArrayClass(className), 0);
         frame.addCreateRef(oop);
         return oop;
     }
 
-    ref FrameMemoryHandler::newMultiArrayOop(i4 *dimLength, const i2 dimCount, const cview name, const i4 currentDim) {
+    ref FrameMemoryHandler::newMultiArrayOop(i4 *dimLength, const i2 dimCount, ArrayClass *currentArrayClass, const i4 currentDim) {
         const auto arrayLength = dimLength[currentDim];
-        const auto currentArrayClass = frame.mem.getArrayClass(name);
         ArrayOop *arrayOop;
         if (currentArrayClass->type == ClassTypeEnum::TYPE_ARRAY_CLASS) {
             const auto typeArrayClass = CAST_TYPE_ARRAY_CLASS(currentArrayClass);
@@ -108,99 +113,127 @@ namespace RexVM {
 
         const auto objArrayOop = CAST_OBJ_ARRAY_OOP(arrayOop);
         if (currentDim < dimCount - 1) {
-            const auto childName = name.substr(1);
+            //低一维的数组类在加载数组类时已经链接好
+            const auto childArrayClass = currentArrayClass->lowerDimension;
             for (auto i = 0; i < arrayLength; ++i) {
-                objArrayOop->data[i] = newMultiArrayOop(dimLength, dimCount, childName, currentDim + 1);
+                objArrayOop->data[i] = newMultiArrayOop(dimLength, dimCount, childArrayClass, currentDim + 1);
             }
         }
         return objArrayOop;
     }
 
     InstanceOop *FrameMemoryHandler::newBooleanOop(const i4 value) const {
-        const auto oop = oopManager.newBooleanOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newBooleanOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newByteOop(const i4 value) const {
-        const auto oop = oopManager.newByteOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newByteOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newCharOop(const i4 value) const {
-        const auto oop = oopManager.newCharOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newCharOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newShortOop(const i4 value) const {
-        const auto oop = oopManager.newShortOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newShortOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newIntegerOop(const i4 value) const {
-        const auto oop = oopManager.newIntegerOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newIntegerOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newFloatOop(const f4 value) const {
-        const auto oop = oopManager.newFloatOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newFloatOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newLongOop(const i8 value) const {
-        const auto oop = oopManager.newLongOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newLongOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::newDoubleOop(const f8 value) const {
-        const auto oop = oopManager.newDoubleOop(&vmThread, value);
+        const auto oop = frame.vm.oopManager->newDoubleOop(&frame.thread, value);
         frame.addCreateRef(oop);
         return oop;
     }
 
     InstanceOop *FrameMemoryHandler::getInternString(const cview str) const {
-        const auto oop = stringPool.getInternString(&vmThread, str);
+        const auto oop = frame.vm.stringPool->getInternString(&frame.thread, str);
         frame.addCreateRef(oop);
         return oop;
     }
 
     Class *FrameMemoryHandler::getClass(const cview name) const {
-        return classLoader.getClass(name);
+        return frame.getCurrentClassLoader()->getClass(name);
     }
 
     InstanceClass *FrameMemoryHandler::getInstanceClass(const cview name) const {
-        return classLoader.getInstanceClass(name);
+        return frame.getCurrentClassLoader()->getInstanceClass(name);
     }
 
     ArrayClass *FrameMemoryHandler::getArrayClass(const cview name) const {
-        return classLoader.getArrayClass(name);
+        return frame.getCurrentClassLoader()->getArrayClass(name);
     }
 
     TypeArrayClass *FrameMemoryHandler::getTypeArrayClass(const BasicType type) const {
-        return classLoader.getTypeArrayClass(type);
+        return frame.getCurrentClassLoader()->getTypeArrayClass(type);
     }
     
     ObjArrayClass *FrameMemoryHandler::getObjectArrayClass(const Class &klass) const {
-        return classLoader.getObjectArrayClass(klass);
+        return frame.getCurrentClassLoader()->getObjectArrayClass(klass);
     }
 
     InstanceClass *FrameMemoryHandler::loadInstanceClass(const u1 *ptr, const size_t length, const bool notAnonymous) const {
-        return classLoader.loadInstanceClass(ptr, length, notAnonymous);
+        return frame.getCurrentClassLoader()->loadInstanceClass(ptr, length, notAnonymous);
     }
 
     InstanceClass *FrameMemoryHandler::getBasicJavaClass(const BasicJavaClassEnum classEnum) const {
-        return classLoader.getBasicJavaClass(classEnum);
+        return frame.getCurrentClassLoader()->getBasicJavaClass(classEnum);
+    }
+
+
+    void ExecuteCache::put(const ExecuteCacheKey &cacheKey, void *member) {
+        if (members.size() >= EXECUTE_CACHE_MAX_SIZE) {
+            clear();
+        }
+        members[cacheKey] = member;
+    }
+
+    //清空发生在创建新缓存之前 返回的指针在下一次put之前一直有效
+    ExecuteVirtualMethodCache *ExecuteCache::putVirtualMethodCache(const ExecuteCacheKey &cacheKey) {
+        if (members.size() >= EXECUTE_CACHE_MAX_SIZE) {
+            clear();
+        }
+        const auto cache = virtualMethodCaches.emplace_back(std::make_unique<ExecuteVirtualMethodCache>()).get();
+        members[cacheKey] = cache;
+        return cache;
+    }
+
+    void ExecuteCache::clear() {
+        members.clear();
+        virtualMethodCaches.clear();
     }
 
+    //invokevirtual和invokespecial可能使用同一个Methodref 两种缓存的结果类型不同 用高位区分
+    constexpr u8 EXECUTE_CACHE_VIRTUAL_KEY = CAST_U8(1) << 16;
 
     Field *FrameMemoryHandler::getRefField(u2 index, bool isStatic) {
-        if (const auto member = executeClassMemberCache.try_get(CAST_U8(index)); member != nullptr) {
+        auto &cache = frame.thread.executeCache;
+        const ExecuteCacheKey cacheKey{&frame.klass, CAST_U8(index)};
+        if (const auto member = cache.members.try_get(cacheKey); member != nullptr) {
             return CAST_FIELD(*member);
         }
         const auto &klass = frame.klass;
@@ -211,12 +244,14 @@ namespace RexVM {
                 return nullptr;
             }
         }
-        executeClassMemberCache.emplace_unique(index, fieldRef);
+        cache.put(cacheKey, fieldRef);
         return fieldRef;
     }
 
     Method *FrameMemoryHandler::getRefMethod(u2 index, const bool isStatic) {
-        if (const auto member = executeClassMemberCache.try_get(CAST_U8(index)); member != nullptr) {
+        auto &cache = frame.thread.executeCache;
+        const ExecuteCacheKey cacheKey{&frame.klass, CAST_U8(index)};
+        if (const auto member = cache.members.try_get(cacheKey); member != nullptr) {
             return CAST_METHOD(*member);
         }
         const auto &klass = frame.klass;
@@ -227,35 +262,38 @@ namespace RexVM {
                 return nullptr;
             }
         }
-        executeClassMemberCache.emplace_unique(index, methodRef);
+        cache.put(cacheKey, methodRef);
         return methodRef;
     }
 
     Class *FrameMemoryHandler::getRefClass(u2 index) {
-        if (const auto member = executeClassMemberCache.try_get(CAST_U8(index)); member != nullptr) {
+        auto &cache = frame.thread.executeCache;
+        const ExecuteCacheKey cacheKey{&frame.klass, CAST_U8(index)};
+        if (const auto member = cache.members.try_get(cacheKey); member != nullptr) {
             return CAST_CLASS(*member);
         }
         auto &klass = frame.klass;
         const auto className = getConstantStringFromPoolByIndexInfo(klass.constantPool, index);
         const auto refClass = klass.classLoader.getClass(className);
-        executeClassMemberCache.emplace_unique(index, refClass);
+        cache.put(cacheKey, refClass);
         return refClass;
     }
 
     ExecuteVirtualMethodCache *FrameMemoryHandler::resolveInvokeVirtualIndex(u2 index, const bool checkMethodHandle) {
-        if (const auto member = executeClassMemberCache.try_get(CAST_U8(index)); member != nullptr) {
+        auto &executeCache = frame.thread.executeCache;
+        const ExecuteCacheKey cacheKey{&frame.klass, CAST_U8(index) | EXECUTE_CACHE_VIRTUAL_KEY};
+        if (const auto member = executeCache.members.try_get(cacheKey); member != nullptr) {
             return static_cast<ExecuteVirtualMethodCache *>(*member);
         }
-        auto cache = std::make_unique<ExecuteVirtualMethodCache>();
-        auto cachePtr = cache.get();
-        cacheVector.emplace_back(std::move(cache));
-        executeClassMemberCache.emplace_unique(index, cachePtr);
+        const auto cachePtr = executeCache.putVirtualMethodCache(cacheKey);
 
         const auto &klass = frame.klass;
         const auto &constantPool = klass.constantPool;
-        auto [className, methodName, methodDescriptor] = getConstantStringFromPoolByClassNameType(constantPool, index);
-        cachePtr->methodName = methodName;
-        cachePtr->methodDescriptor = methodDescriptor;
+        auto [className, methodNameSymbol, methodDescriptorSymbol] = getConstantSymbolFromPoolByClassNameType(constantPool, index);
+        cachePtr->methodName = methodNameSymbol;
+        cachePtr->methodDescriptor = methodDescriptorSymbol;
+        const auto methodName = methodNameSymbol->view();
+        const auto methodDescriptor = methodDescriptorSymbol->view();
 
         if (checkMethodHandle && isMethodHandleInvoke(className, methodName)) {
             const auto invokeMethod =
@@ -272,13 +310,14 @@ namespace RexVM {
 
     Method *FrameMemoryHandler::linkVirtualMethod(
         const u2 index,
-        const cview methodName,
-        const cview methodDescriptor,
+        const Symbol *methodName,
+        const Symbol *methodDescriptor,
         InstanceClass *instanceClass
     ) {
+        auto &cache = frame.thread.executeCache;
         const Composite keyComposite(instanceClass, index);
-        u8 key = keyComposite.composite;
-        if (const auto member = executeClassMemberCache.try_get(key); member != nullptr) {
+        const ExecuteCacheKey cacheKey{&frame.klass, keyComposite.composite};
+        if (const auto member = cache.members.try_get(cacheKey); member != nullptr) {
             return CAST_METHOD(*member);
         }
 
@@ -289,13 +328,13 @@ namespace RexVM {
             if (realInvokeMethod == nullptr) {
                 panic("array invoke error");
             }
-            executeClassMemberCache.emplace_unique(key, realInvokeMethod);
+            cache.put(cacheKey, realInvokeMethod);
             return realInvokeMethod;
         } else {
             for (auto k = instanceClass; k != nullptr; k = k->getSuperClass()) {
                 const auto realInvokeMethod = k->getMethod(methodName, methodDescriptor, false);
                 if (realInvokeMethod != nullptr && !realInvokeMethod->isAbstract()) {
-                    executeClassMemberCache.emplace_unique(key, realInvokeMethod);
+                    cache.put(cacheKey, realInvokeMethod);
                     return realInvokeMethod;
                 }
             }
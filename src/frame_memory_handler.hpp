@@ -2,6 +2,9 @@
 #define FRAME_MEMORY_HANDLER_HPP
 #include "basic.hpp"
 #include "basic_java_class.hpp"
+#include <bit>
+#include <memory>
+#include <vector>
 #include <hash_table8.hpp>
 
 namespace RexVM {
@@ -27,24 +30,49 @@ namespace RexVM {
     struct ClassMember;
     struct Field;
     struct Method;
+    struct Symbol;
 
     struct ExecuteVirtualMethodCache {
         explicit ExecuteVirtualMethodCache() = default;
         Method *mhMethod{nullptr};
-        cview methodName{};
-        cview methodDescriptor{};
+        const Symbol *methodName{nullptr};
+        const Symbol *methodDescriptor{nullptr};
         u2 mhMethodPopSize{};
         u2 paramSlotSize{};
     };
 
+    //字节码中符号引用的解析结果 按线程缓存 Frame创建时不再需要分配缓存
+    //常量池属于类 key使用当前类和常量池索引(或接收者类型+常量池索引)
+    struct ExecuteCacheKey {
+        const InstanceClass *klass;
+        u8 key;
+
+        bool operator==(const ExecuteCacheKey &other) const = default;
+    };
+
+    struct ExecuteCacheKeyHash {
+        size_t operator()(const ExecuteCacheKey &cacheKey) const noexcept {
+            return std::hash<u8>{}(cacheKey.key ^ (std::bit_cast<u8>(cacheKey.klass) * 0x9E3779B97F4A7C15ULL));
+        }
+    };
+
+    //每个线程最多缓存的解析结果数 超过后整体清空重新解析
+    //VM不卸载类 但匿名类(lambda/反射生成的类)会不断产生新的key 不设上限长时间运行的线程会一直增长
+    constexpr size_t EXECUTE_CACHE_MAX_SIZE = 64 * 1024;
+
+    struct ExecuteCache {
+        emhash8::HashMap<ExecuteCacheKey, void *, ExecuteCacheKeyHash> members{256};
+        std::vector<std::unique_ptr<ExecuteVirtualMethodCache>> virtualMethodCaches;
+
+        void put(const ExecuteCacheKey &cacheKey, void *member);
+        ExecuteVirtualMethodCache *putVirtualMethodCache(const ExecuteCacheKey &cacheKey);
+        void clear();
+    };
+
     struct FrameMemoryHandler {
         explicit FrameMemoryHandler(Frame &frame);
 
         Frame &frame;
-        VMThread &vmThread;
-        OopManager &oopManager;
-        StringPool &stringPool;
-        ClassLoader &classLoader;
 
         [[nodiscard]] InstanceOop *newInstance(InstanceClass * klass) const;
         [[nodiscard]] MirOop *newMirror(InstanceClass * klass, voidPtr mirror, MirrorObjectTypeEnum type) const;
@@ -55,11 +83,12 @@ namespace RexVM {
         [[nodiscard]] ObjArrayOop *newStringObjArrayOop(size_t length) const;
 
         [[nodiscard]] TypeArrayOop *newTypeArrayOop(BasicType type, size_t length) const;
+        [[nodiscard]] TypeArrayOop *newTypeArrayOop(TypeArrayClass *klass, size_t length) const;
         [[nodiscard]] ByteTypeArrayOop *newByteArrayOop(size_t length) const;
         [[nodiscard]] ByteTypeArrayOop *newByteArrayOop(size_t length, const u1 *initBuffer) const;
         [[nodiscard]] CharTypeArrayOop *newCharArrayOop(size_t length) const;
         [[nodiscard]] ref newMultiArrayOop(u2 index, i4 *dimLength, i2 dimCount);
-        [[nodiscard]] ref newMultiArrayOop(i4 *dimLength, i2 dimCount, cview name, i4 currentDim);
+        [[nodiscard]] ref newMultiArrayOop(i4 *dimLength, i2 dimCount, ArrayClass *currentArrayClass, i4 currentDim);
 
         [[nodiscard]] InstanceOop *newBooleanOop(i4 value) const;
         [[nodiscard]] InstanceOop *newByteOop(i4 value) const;
@@ -82,11 +111,6 @@ namespace RexVM {
         [[nodiscard]] ArrayClass *getArrayClass(cview name) const;
 
 
-        //execute cache
-
-        emhash8::HashMap<u8, voidPtr> executeClassMemberCache{64};
-        std::vector<std::unique_ptr<ExecuteVirtualMethodCache>> cacheVector{};
-
         [[nodiscard]] Field *getRefField(u2 index, bool isStatic);
         [[nodiscard]] Method *getRefMethod(u2 index, bool isStatic);
         [[nodiscard]] Class *getRefClass(u2 index);
@@ -94,8 +118,8 @@ namespace RexVM {
         [[nodiscard]] ExecuteVirtualMethodCache *resolveInvokeVirtualIndex(u2 index, bool checkMethodHandle);
 
         [[nodiscard]] Method *linkVirtualMethod(u2 index,
-                                                cview methodName,
-                                                cview methodDescriptor,
+                                                const Symbol *methodName,
+                                                const Symbol *methodDescriptor,
                                                 InstanceClass *instanceClass
         );
 
@@ -253,6 +253,9 @@ namespace RexVM {
                 if (oopClass == stringClass) {
                     vm.stringPool->gcStringOop(CAST_INSTANCE_OOP(oop));
                 }
+                if (!vm.oopManager->restoredIdentityHashes.empty()) [[unlikely]] {
+                    vm.oopManager->restoredIdentityHashes.erase(oop);
+                }
                 deleteOop(oop);
             }
         }
@@ -0,0 +1,784 @@
+#include "heap_snapshot.hpp"
+#include <filesystem>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <hash_table8.hpp>
+#include "vm.hpp"
+#include "class.hpp"
+#include "class_member.hpp"
+#include "class_loader.hpp"
+#include "oop.hpp"
+#include "mirror_oop.hpp"
+#include "mirror_base.hpp"
+#include "memory.hpp"
+#include "thread.hpp"
+#include "string_pool.hpp"
+#include "key_slot_id.hpp"
+#include "os_platform.hpp"
+#include "utils/binary.hpp"
+#include "utils/string_utils.hpp"
+#include "utils/file_utils.hpp"
+
+namespace RexVM {
+
+    constexpr char HEAP_SNAPSHOT_MAGIC[8] = {'R', 'E', 'X', 'H', 'E', 'A', 'P', '1'};
+    constexpr auto SNAPSHOT_INVALID_MEMBER_INDEX = std::numeric_limits<u4>::max();
+
+    u8 getHeapSnapshotStamp(const VM &vm) {
+        //快照中有按VM结构体布局保存的数据 VM可执行文件变化后作废
+        auto stamp = getVMBuildStamp();
+        stamp = fnv1aHash(&vm.classPathStamp, sizeof(vm.classPathStamp), stamp);
+        stamp = fnv1aHash(vm.javaHome, stamp);
+        //System.initProperties把工作目录写进了user.dir 工作目录不同时不能使用
+        std::error_code ec;
+        return fnv1aHash(std::filesystem::current_path(ec).string(), stamp);
+    }
+
+    static size_t getTypeArrayElementSize(const BasicType type) {
+        switch (type) {
+            case BasicType::T_BOOLEAN:
+            case BasicType::T_BYTE:
+                return sizeof(u1);
+            case BasicType::T_SHORT:
+            case BasicType::T_CHAR:
+                return sizeof(u2);
+            case BasicType::T_INT:
+            case BasicType::T_FLOAT:
+                return sizeof(u4);
+            case BasicType::T_LONG:
+            case BasicType::T_DOUBLE:
+                return sizeof(u8);
+            default:
+                panic("error type");
+                return 0;
+        }
+    }
+
+    static u1 *getTypeArrayData(ref oop) {
+        switch (CAST_TYPE_ARRAY_CLASS(oop->getClass())->elementType) {
+            case BasicType::T_BOOLEAN:
+            case BasicType::T_BYTE:
+                return CAST_BYTE_TYPE_ARRAY_OOP(oop)->data.get();
+            case BasicType::T_SHORT:
+                return reinterpret_cast<u1 *>(CAST_SHORT_TYPE_ARRAY_OOP(oop)->data.get());
+            case BasicType::T_CHAR:
+                return reinterpret_cast<u1 *>(CAST_CHAR_TYPE_ARRAY_OOP(oop)->data.get());
+            case BasicType::T_INT:
+                return reinterpret_cast<u1 *>(CAST_INT_TYPE_ARRAY_OOP(oop)->data.get());
+            case BasicType::T_FLOAT:
+                return reinterpret_cast<u1 *>(CAST_FLOAT_TYPE_ARRAY_OOP(oop)->data.get());
+            case BasicType::T_LONG:
+                return reinterpret_cast<u1 *>(CAST_LONG_TYPE_ARRAY_OOP(oop)->data.get());
+            case BasicType::T_DOUBLE:
+                return reinterpret_cast<u1 *>(CAST_DOUBLE_TYPE_ARRAY_OOP(oop)->data.get());
+            default:
+                panic("error type");
+                return nullptr;
+        }
+    }
+
+    template<typename T>
+    static u4 getMemberIndex(const std::vector<std::unique_ptr<T>> &members, const ClassMember *member) {
+        for (size_t i = 0; i < members.size(); ++i) {
+            if (members[i].get() == member) {
+                return CAST_U4(i);
+            }
+        }
+        return SNAPSHOT_INVALID_MEMBER_INDEX;
+    }
+
+    struct SnapshotWriter {
+        std::string buffer;
+
+        template<typename T>
+        void put(const T value) {
+            buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        void putBytes(const void *data, const size_t size) {
+            buffer.append(static_cast<const char *>(data), size);
+        }
+    };
+
+    struct SnapshotReader {
+        const u1 *ptr;
+        const u1 *end;
+        bool ok{true};
+
+        //越界时ok置为false并返回0 调用方读完一段后统一检查
+        template<typename T>
+        T get() {
+            T value{};
+            if (CAST_SIZE_T(end - ptr) < sizeof(T)) {
+                ok = false;
+                ptr = end;
+                return value;
+            }
+            std::memcpy(&value, ptr, sizeof(T));
+            ptr += sizeof(T);
+            return value;
+        }
+
+        const u1 *getBytes(const size_t size) {
+            if (CAST_SIZE_T(end - ptr) < size) {
+                ok = false;
+                ptr = end;
+                return nullptr;
+            }
+            const auto result = ptr;
+            ptr += size;
+            return result;
+        }
+    };
+
+    static u8 readSnapshotU8(const u1 *data, const size_t index) {
+        u8 value{};
+        std::memcpy(&value, data + index * sizeof(u8), sizeof(u8));
+        return value;
+    }
+
+    static u4 readSnapshotU4(const u1 *data, const size_t index) {
+        u4 value{};
+        std::memcpy(&value, data + index * sizeof(u4), sizeof(u4));
+        return value;
+    }
+
+    //对象编号从1开始 按广度优先的顺序分配
+    struct SnapshotObjectTable {
+        const Class *throwableClass;
+        emhash8::HashMap<ref, u4> ids;
+        std::vector<ref> objects;
+
+        explicit SnapshotObjectTable(const Class *throwableClass) : throwableClass(throwableClass) {
+        }
+
+        //Throwable.backtrace是long[] 保存的是Method指针 下次启动时无效
+        //快照中当作null 不遍历也不写入 恢复后的异常栈为空(已经缓存在stackTrace字段中的除外)
+        [[nodiscard]] bool isSkippedSlot(const InstanceClass *klass, const size_t slotId) const {
+            return slotId == throwableClassBacktraceFID &&
+                   (klass == throwableClass || klass->isSubClassOf(throwableClass));
+        }
+
+        u4 getId(const ref oop) {
+            if (oop == nullptr) {
+                return 0;
+            }
+            if (const auto id = ids.try_get(oop); id != nullptr) {
+                return *id;
+            }
+            objects.emplace_back(oop);
+            const auto id = CAST_U4(objects.size());
+            ids[oop] = id;
+            return id;
+        }
+
+        void addChildren(const ref oop) {
+            switch (oop->getType()) {
+                case OopTypeEnum::INSTANCE_OOP: {
+                    const auto instance = CAST_INSTANCE_OOP(oop);
+                    const auto klass = instance->getInstanceClass();
+                    FOR_FROM_ZERO(CAST_SIZE_T(klass->instanceSlotCount)) {
+                        if (klass->instanceDataType[i] == SlotTypeEnum::REF && !isSkippedSlot(klass, i)) {
+                            getId(instance->data[i].refVal);
+                        }
+                    }
+                    break;
+                }
+
+                case OopTypeEnum::OBJ_ARRAY_OOP: {
+                    const auto array = CAST_OBJ_ARRAY_OOP(oop);
+                    FOR_FROM_ZERO(array->getDataLength()) {
+                        getId(array->data[i]);
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+    };
+
+    bool writeHeapSnapshot(VM &vm, VMThread &thread, const cview path) {
+        //快照中不保存线程的执行状态 除main外还有线程存活时放弃
+        for (const auto &item : vm.threadManager->getThreads()) {
+            if (item != &thread && item->isAlive()) {
+                cprintlnErr("heap snapshot skipped: thread {} is alive", item->getName());
+                return false;
+            }
+        }
+
+        auto &classLoader = *vm.bootstrapClassLoader;
+        std::vector<Class *> classes;
+        emhash8::HashMap<Class *, u4> classIndexes;
+        {
+            std::lock_guard lock(classLoader.clMutex);
+            classes.reserve(classLoader.classMap.size());
+            for (const auto &[name, klass] : classLoader.classMap) {
+                //匿名类没有办法按名字重新加载
+                if (name.starts_with(ANONYMOUS_CLASS_NAME_PREFIX)) {
+                    cprintlnErr("heap snapshot skipped: anonymous class {} is loaded", name);
+                    return false;
+                }
+                classIndexes[klass.get()] = CAST_U4(classes.size());
+                classes.emplace_back(klass.get());
+            }
+        }
+
+        //根: 类的mirror 已初始化类的静态字段 main线程
+        SnapshotObjectTable table(classLoader.getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_THROWABLE));
+        for (const auto &klass : classes) {
+            table.getId(klass->getMirror(nullptr, false));
+            if (klass->type == ClassTypeEnum::INSTANCE_CLASS) {
+                const auto instanceClass = CAST_INSTANCE_CLASS(klass);
+                if (instanceClass->initStatus != ClassInitStatusEnum::INITED) {
+                    continue;
+                }
+                FOR_FROM_ZERO(CAST_SIZE_T(instanceClass->staticSlotCount)) {
+                    if (instanceClass->staticDataType[i] == SlotTypeEnum::REF) {
+                        table.getId(instanceClass->staticData[i].refVal);
+                    }
+                }
+            }
+        }
+        const auto mainThreadId = table.getId(&thread);
+        for (size_t i = 0; i < table.objects.size(); ++i) {
+            table.addChildren(table.objects[i]);
+        }
+
+        SnapshotWriter writer;
+        SnapshotHeader header{};
+        std::memcpy(header.magic, HEAP_SNAPSHOT_MAGIC, sizeof(HEAP_SNAPSHOT_MAGIC));
+        header.stamp = getHeapSnapshotStamp(vm);
+        header.classCount = CAST_U4(classes.size());
+        header.objectCount = CAST_U4(table.objects.size());
+        header.mainThreadId = mainThreadId;
+        writer.put(header);
+
+        for (const auto &klass : classes) {
+            const auto name = klass->getClassName();
+            writer.put(CAST_U4(name.size()));
+            writer.putBytes(name.data(), name.size());
+            const auto initialized =
+                klass->type == ClassTypeEnum::INSTANCE_CLASS && klass->initStatus == ClassInitStatusEnum::INITED;
+            writer.put(CAST_U1(initialized));
+            if (!initialized) {
+                continue;
+            }
+            const auto instanceClass = CAST_INSTANCE_CLASS(klass);
+            writer.put(instanceClass->staticSlotCount);
+            FOR_FROM_ZERO(CAST_SIZE_T(instanceClass->staticSlotCount)) {
+                const auto value = instanceClass->staticData[i];
+                if (instanceClass->staticDataType[i] == SlotTypeEnum::REF) {
+                    writer.put(CAST_U8(table.getId(value.refVal)));
+                } else {
+                    writer.put(CAST_U8(value.i8Val));
+                }
+            }
+        }
+
+        const auto stringClass = classLoader.getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_STRING);
+        std::lock_guard stringPoolLock(vm.stringPool->lock);
+        for (const auto &oop : table.objects) {
+            const auto klass = oop->getClass();
+            const auto oopType = oop->getType();
+            const auto kind =
+                oop->isMirror() ? SnapshotObjectKind::MIRROR
+                : oopType == OopTypeEnum::INSTANCE_OOP ? SnapshotObjectKind::INSTANCE
+                : oopType == OopTypeEnum::OBJ_ARRAY_OOP ? SnapshotObjectKind::OBJ_ARRAY
+                : SnapshotObjectKind::TYPE_ARRAY;
+            const auto interned = klass == stringClass && vm.stringPool->stringTable->contains(CAST_INSTANCE_OOP(oop));
+
+            writer.put(CAST_U1(kind));
+            writer.put(classIndexes[klass]);
+            writer.put(CAST_U2(oop->getFlags() & ~TRACED_MASK));
+            writer.put(vm.oopManager->getIdentityHash(oop));
+            writer.put(CAST_U1(interned));
+
+            switch (kind) {
+                case SnapshotObjectKind::MIRROR: {
+                    const auto mirror = CAST_MIRROR_OOP(oop);
+                    const auto mirrorType = mirror->getMirrorObjectType();
+                    auto targetClassIndex = SNAPSHOT_INVALID_MEMBER_INDEX;
+                    auto memberIndex = SNAPSHOT_INVALID_MEMBER_INDEX;
+                    switch (mirrorType) {
+                        case MirrorObjectTypeEnum::CLASS:
+                        case MirrorObjectTypeEnum::CONSTANT_POOL:
+                            targetClassIndex = classIndexes[mirror->getMirrorClass()];
+                            break;
+
+                        case MirrorObjectTypeEnum::METHOD:
+                        case MirrorObjectTypeEnum::CONSTRUCTOR: {
+                            const auto member = CAST_CLASS_MEMBER(mirror->mirror.getPtr());
+                            targetClassIndex = classIndexes[&member->klass];
+                            memberIndex = getMemberIndex(member->klass.methods, member);
+                            break;
+                        }
+
+                        case MirrorObjectTypeEnum::FIELD: {
+                            const auto member = CAST_CLASS_MEMBER(mirror->mirror.getPtr());
+                            targetClassIndex = classIndexes[&member->klass];
+                            memberIndex = getMemberIndex(member->klass.fields, member);
+                            break;
+                        }
+
+                        default:
+                            //MemberName恢复后按字段重新解析
+                            break;
+                    }
+                    writer.put(CAST_U2(mirrorType));
+                    writer.put(targetClassIndex);
+                    writer.put(memberIndex);
+                    [[fallthrough]];
+                }
+
+                case SnapshotObjectKind::INSTANCE: {
+                    const auto instance = CAST_INSTANCE_OOP(oop);
+                    const auto instanceClass = instance->getInstanceClass();
+                    writer.put(CAST_U4(instanceClass->instanceSlotCount));
+                    FOR_FROM_ZERO(CAST_SIZE_T(instanceClass->instanceSlotCount)) {
+                        const auto value = instance->data[i];
+                        if (table.isSkippedSlot(instanceClass, i)) {
+                            writer.put(CAST_U8(0));
+                        } else if (instanceClass->instanceDataType[i] == SlotTypeEnum::REF) {
+                            writer.put(CAST_U8(table.getId(value.refVal)));
+                        } else {
+                            writer.put(CAST_U8(value.i8Val));
+                        }
+                    }
+                    break;
+                }
+
+                case SnapshotObjectKind::OBJ_ARRAY: {
+                    const auto array = CAST_OBJ_ARRAY_OOP(oop);
+                    writer.put(CAST_U4(array->getDataLength()));
+                    FOR_FROM_ZERO(array->getDataLength()) {
+                        writer.put(table.getId(array->data[i]));
+                    }
+                    break;
+                }
+
+                case SnapshotObjectKind::TYPE_ARRAY: {
+                    const auto length = oop->getDataLength();
+                    const auto elementSize = getTypeArrayElementSize(CAST_TYPE_ARRAY_CLASS(klass)->elementType);
+                    writer.put(CAST_U4(length));
+                    if (length > 0) {
+                        writer.putBytes(getTypeArrayData(oop), length * elementSize);
+                    }
+                    break;
+                }
+            }
+        }
+
+        const auto written = writeFileAtomically(path, [&writer](std::ostream &os) {
+            os.write(writer.buffer.data(), CAST_I8(writer.buffer.size()));
+        });
+        if (!written) {
+            cprintlnErr("heap snapshot write error: {}", path);
+        }
+        return written;
+    }
+
+    bool isHeapSnapshotHeaderValid(const VM &vm, const u1 *data, const size_t size) {
+        if (size < sizeof(SnapshotHeader)) {
+            return false;
+        }
+        SnapshotHeader header{};
+        std::memcpy(&header, data, sizeof(SnapshotHeader));
+        return std::memcmp(header.magic, HEAP_SNAPSHOT_MAGIC, sizeof(HEAP_SNAPSHOT_MAGIC)) == 0 &&
+               header.stamp == getHeapSnapshotStamp(vm);
+    }
+
+    struct SnapshotClass {
+        Class *klass{nullptr};
+        bool initialized{false};
+        const u1 *staticSlots{nullptr};
+    };
+
+    struct SnapshotObject {
+        SnapshotObjectKind kind{};
+        Class *klass{nullptr};
+        u2 flags{0};
+        i4 identityHash{0};
+        bool interned{false};
+        u4 length{0};
+        MirrorObjectTypeEnum mirrorType{};
+        void *mirrorTarget{nullptr};
+        const u1 *data{nullptr};
+    };
+
+    struct HeapSnapshotLoader {
+        VM &vm;
+        VMThread &thread;
+        SnapshotHeader header{};
+        std::vector<SnapshotClass> classes;
+        std::vector<SnapshotObject> objects;
+
+        explicit HeapSnapshotLoader(VM &vm, VMThread &thread) : vm(vm), thread(thread) {
+        }
+
+        [[nodiscard]] bool validId(const u8 id) const {
+            return id <= header.objectCount;
+        }
+
+        [[nodiscard]] bool validSlots(const u1 *data, const SlotTypeEnum *types, const size_t count) const {
+            FOR_FROM_ZERO(count) {
+                if (types[i] == SlotTypeEnum::REF && !validId(readSnapshotU8(data, i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //读取并校验整个快照 加载其中的类 不修改堆
+        bool parse(const u1 *data, const size_t size) {
+            if (!isHeapSnapshotHeaderValid(vm, data, size)) {
+                return false;
+            }
+            std::memcpy(&header, data, sizeof(SnapshotHeader));
+            SnapshotReader reader{data + sizeof(SnapshotHeader), data + size};
+
+            classes.resize(header.classCount);
+            for (auto &item : classes) {
+                const auto nameLength = reader.get<u4>();
+                const auto name = reader.getBytes(nameLength);
+                item.initialized = reader.get<u1>() != 0;
+                if (!reader.ok) {
+                    return false;
+                }
+                item.klass = vm.bootstrapClassLoader->getClass(cview(reinterpret_cast<const char *>(name), nameLength));
+                if (item.klass == nullptr) {
+                    return false;
+                }
+                if (!item.initialized) {
+                    continue;
+                }
+                if (item.klass->type != ClassTypeEnum::INSTANCE_CLASS) {
+                    return false;
+                }
+                const auto instanceClass = CAST_INSTANCE_CLASS(item.klass);
+                const auto staticSlotCount = reader.get<u2>();
+                item.staticSlots = reader.getBytes(CAST_SIZE_T(staticSlotCount) * sizeof(u8));
+                if (!reader.ok || staticSlotCount != instanceClass->staticSlotCount ||
+                    !validSlots(item.staticSlots, instanceClass->staticDataType.get(), staticSlotCount)) {
+                    return false;
+                }
+            }
+
+            objects.resize(header.objectCount);
+            for (auto &item : objects) {
+                const auto kind = reader.get<u1>();
+                const auto classIndex = reader.get<u4>();
+                item.flags = reader.get<u2>();
+                item.identityHash = reader.get<i4>();
+                item.interned = reader.get<u1>() != 0;
+                if (!reader.ok || kind > CAST_U1(SnapshotObjectKind::TYPE_ARRAY) || classIndex >= header.classCount) {
+                    return false;
+                }
+                item.kind = static_cast<SnapshotObjectKind>(kind);
+                item.klass = classes[classIndex].klass;
+
+                switch (item.kind) {
+                    case SnapshotObjectKind::MIRROR:
+                        if (!parseMirror(reader, item)) {
+                            return false;
+                        }
+                        [[fallthrough]];
+
+                    case SnapshotObjectKind::INSTANCE: {
+                        item.length = reader.get<u4>();
+                        if (item.klass->type != ClassTypeEnum::INSTANCE_CLASS) {
+                            return false;
+                        }
+                        const auto instanceClass = CAST_INSTANCE_CLASS(item.klass);
+                        item.data = reader.getBytes(CAST_SIZE_T(item.length) * sizeof(u8));
+                        if (!reader.ok || item.length != instanceClass->instanceSlotCount ||
+                            !validSlots(item.data, instanceClass->instanceDataType.get(), item.length)) {
+                            return false;
+                        }
+                        break;
+                    }
+
+                    case SnapshotObjectKind::OBJ_ARRAY:
+                        item.length = reader.get<u4>();
+                        item.data = reader.getBytes(CAST_SIZE_T(item.length) * sizeof(u4));
+                        if (!reader.ok || item.klass->type != ClassTypeEnum::OBJ_ARRAY_CLASS) {
+                            return false;
+                        }
+                        FOR_FROM_ZERO(CAST_SIZE_T(item.length)) {
+                            if (!validId(readSnapshotU4(item.data, i))) {
+                                return false;
+                            }
+                        }
+                        break;
+
+                    case SnapshotObjectKind::TYPE_ARRAY: {
+                        item.length = reader.get<u4>();
+                        if (item.klass->type != ClassTypeEnum::TYPE_ARRAY_CLASS) {
+                            return false;
+                        }
+                        const auto elementSize = getTypeArrayElementSize(CAST_TYPE_ARRAY_CLASS(item.klass)->elementType);
+                        item.data = reader.getBytes(CAST_SIZE_T(item.length) * elementSize);
+                        if (!reader.ok) {
+                            return false;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            //main线程对应到当前的main线程 类必须一致
+            if (header.mainThreadId == 0 || !validId(header.mainThreadId)) {
+                return false;
+            }
+            const auto &mainThreadObject = objects[header.mainThreadId - 1];
+            return reader.ptr == reader.end &&
+                   mainThreadObject.kind == SnapshotObjectKind::INSTANCE &&
+                   mainThreadObject.klass == thread.getClass();
+        }
+
+        bool parseMirror(SnapshotReader &reader, SnapshotObject &item) const {
+            const auto mirrorType = reader.get<u2>();
+            const auto targetClassIndex = reader.get<u4>();
+            const auto memberIndex = reader.get<u4>();
+            if (!reader.ok || mirrorType > CAST_U2(MirrorObjectTypeEnum::CONSTANT_POOL)) {
+                return false;
+            }
+            item.mirrorType = static_cast<MirrorObjectTypeEnum>(mirrorType);
+            if (item.mirrorType == MirrorObjectTypeEnum::MEMBER_NAME) {
+                return true;
+            }
+            if (targetClassIndex >= header.classCount) {
+                return false;
+            }
+            const auto targetClass = classes[targetClassIndex].klass;
+            if (item.mirrorType == MirrorObjectTypeEnum::CLASS) {
+                item.mirrorTarget = targetClass;
+                return true;
+            }
+            if (targetClass->type != ClassTypeEnum::INSTANCE_CLASS) {
+                return false;
+            }
+            const auto instanceClass = CAST_INSTANCE_CLASS(targetClass);
+            switch (item.mirrorType) {
+                case MirrorObjectTypeEnum::CONSTANT_POOL:
+                    item.mirrorTarget = instanceClass;
+                    return true;
+
+                case MirrorObjectTypeEnum::METHOD:
+                case MirrorObjectTypeEnum::CONSTRUCTOR:
+                    if (memberIndex >= instanceClass->methods.size()) {
+                        return false;
+                    }
+                    item.mirrorTarget = static_cast<ClassMember *>(instanceClass->methods[memberIndex].get());
+                    return true;
+
+                case MirrorObjectTypeEnum::FIELD:
+                    if (memberIndex >= instanceClass->fields.size()) {
+                        return false;
+                    }
+                    item.mirrorTarget = static_cast<ClassMember *>(instanceClass->fields[memberIndex].get());
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
+
+        [[nodiscard]] MirrorBase *getMirrorBase(const SnapshotObject &item) const {
+            switch (item.mirrorType) {
+                case MirrorObjectTypeEnum::CLASS:
+                    return &CAST_CLASS(item.mirrorTarget)->mirrorBase;
+
+                case MirrorObjectTypeEnum::METHOD:
+                case MirrorObjectTypeEnum::CONSTRUCTOR:
+                case MirrorObjectTypeEnum::FIELD:
+                    return &CAST_CLASS_MEMBER(item.mirrorTarget)->mirrorBase;
+
+                case MirrorObjectTypeEnum::CONSTANT_POOL:
+                    return &CAST_INSTANCE_CLASS(item.mirrorTarget)->constantPoolMirrorBase;
+
+                default:
+                    return nullptr;
+            }
+        }
+
+        //intern字符串的内容 直接从快照中的char数组读取
+        [[nodiscard]] bool getStringContent(const SnapshotObject &item, cstring &result) const {
+            if (item.length <= stringClassValueFieldSlotId) {
+                return false;
+            }
+            const auto valueId = readSnapshotU8(item.data, stringClassValueFieldSlotId);
+            if (valueId == 0) {
+                return false;
+            }
+            const auto &value = objects[valueId - 1];
+            if (value.kind != SnapshotObjectKind::TYPE_ARRAY ||
+                CAST_TYPE_ARRAY_CLASS(value.klass)->elementType != BasicType::T_CHAR) {
+                return false;
+            }
+            std::vector<cchar_16> utf16(value.length);
+            if (value.length > 0) {
+                std::memcpy(utf16.data(), value.data, value.length * sizeof(cchar_16));
+            }
+            result = utf16ToUtf8(utf16.data(), utf16.size());
+            return true;
+        }
+
+        void restore() {
+            auto &oopManager = *vm.oopManager;
+            auto &stringPool = *vm.stringPool;
+
+            //先把类标记为已初始化 Thread子类的对象才会创建成VMThread
+            for (const auto &item : classes) {
+                if (item.initialized && CAST_INSTANCE_CLASS(item.klass)->notInitialize()) {
+                    CAST_INSTANCE_CLASS(item.klass)->markInitialized();
+                }
+            }
+
+            //分配对象 已有mirror的类和成员 String Pool中已有的字符串 main线程直接使用现有的对象
+            std::vector<ref> oops(CAST_SIZE_T(header.objectCount) + 1, nullptr);
+            std::vector<bool> keepFields(oops.size(), false);
+            std::vector<InstanceOop *> internStrings;
+            FOR_FROM_ONE(oops.size()) {
+                const auto &item = objects[i - 1];
+                if (i == header.mainThreadId) {
+                    oops[i] = &thread;
+                    continue;
+                }
+                switch (item.kind) {
+                    case SnapshotObjectKind::INSTANCE: {
+                        cstring content;
+                        if (item.interned && getStringContent(item, content)) {
+                            std::lock_guard guard(stringPool.lock);
+                            if (InstanceOop *existString = nullptr;
+                                stringPool.stringTable->find(content.c_str(), content.size(), existString)) {
+                                oops[i] = existString;
+                                keepFields[i] = true;
+                                break;
+                            }
+                        }
+                        const auto oop = oopManager.newInstance(&thread, CAST_INSTANCE_CLASS(item.klass));
+                        if (item.interned) {
+                            internStrings.emplace_back(oop);
+                        }
+                        oops[i] = oop;
+                        break;
+                    }
+
+                    case SnapshotObjectKind::MIRROR: {
+                        const auto mirrorBase = getMirrorBase(item);
+                        if (mirrorBase != nullptr && mirrorBase->mirOop != nullptr) {
+                            oops[i] = mirrorBase->mirOop;
+                            break;
+                        }
+                        const auto mirror = oopManager.newMirror(
+                            &thread,
+                            CAST_INSTANCE_CLASS(item.klass),
+                            item.mirrorTarget,
+                            item.mirrorType
+                        );
+                        if (mirrorBase != nullptr) {
+                            mirrorBase->mirOop = mirror;
+                        }
+                        oops[i] = mirror;
+                        break;
+                    }
+
+                    case SnapshotObjectKind::OBJ_ARRAY:
+                        oops[i] = oopManager.newObjArrayOop(&thread, CAST_OBJ_ARRAY_CLASS(item.klass), item.length);
+                        break;
+
+                    case SnapshotObjectKind::TYPE_ARRAY: {
+                        const auto klass = CAST_TYPE_ARRAY_CLASS(item.klass);
+                        const auto oop = oopManager.newTypeArrayOop(&thread, klass, item.length);
+                        if (item.length > 0) {
+                            std::memcpy(getTypeArrayData(oop), item.data, item.length * getTypeArrayElementSize(klass->elementType));
+                        }
+                        oops[i] = oop;
+                        break;
+                    }
+                }
+            }
+
+            //填充字段 引用从对象编号换成新地址
+            const auto toSlot = [&oops](const u8 raw, const SlotTypeEnum type) {
+                return type == SlotTypeEnum::REF ? Slot(oops[raw]) : Slot(CAST_I8(raw));
+            };
+            oopManager.restoredIdentityHashes.reserve(oops.size());
+            FOR_FROM_ONE(oops.size()) {
+                const auto &item = objects[i - 1];
+                const auto oop = oops[i];
+                oopManager.restoredIdentityHashes[oop] = item.identityHash;
+                if (keepFields[i]) {
+                    continue;
+                }
+                oop->setFlags(CAST_U2((oop->getFlags() & MIRROR_MASK) | (item.flags & ~(TRACED_MASK | MIRROR_MASK))));
+                switch (item.kind) {
+                    case SnapshotObjectKind::INSTANCE:
+                    case SnapshotObjectKind::MIRROR: {
+                        const auto instance = CAST_INSTANCE_OOP(oop);
+                        const auto instanceClass = CAST_INSTANCE_CLASS(item.klass);
+                        for (size_t slotId = 0; slotId < item.length; ++slotId) {
+                            //当前main线程还没有启动 保持NEW状态
+                            if (i == header.mainThreadId && slotId == threadClassThreadStatusFieldSlotId) {
+                                continue;
+                            }
+                            instance->data[slotId] =
+                                toSlot(readSnapshotU8(item.data, slotId), instanceClass->instanceDataType[slotId]);
+                        }
+                        break;
+                    }
+
+                    case SnapshotObjectKind::OBJ_ARRAY: {
+                        const auto array = CAST_OBJ_ARRAY_OOP(oop);
+                        for (size_t index = 0; index < item.length; ++index) {
+                            array->data[index] = oops[readSnapshotU4(item.data, index)];
+                        }
+                        break;
+                    }
+
+                    default:
+                        break;
+                }
+            }
+
+            for (const auto &item : classes) {
+                if (!item.initialized) {
+                    continue;
+                }
+                const auto instanceClass = CAST_INSTANCE_CLASS(item.klass);
+                FOR_FROM_ZERO(CAST_SIZE_T(instanceClass->staticSlotCount)) {
+                    instanceClass->staticData[i] =
+                        toSlot(readSnapshotU8(item.staticSlots, i), instanceClass->staticDataType[i]);
+                }
+            }
+
+            //flags中带着字符串在String Pool中的hash 恢复flags后才能放入
+            std::lock_guard guard(stringPool.lock);
+            for (const auto &item : internStrings) {
+                stringPool.stringTable->insert(item);
+            }
+        }
+    };
+
+    bool restoreHeapSnapshot(VM &vm, VMThread &thread, const cview path) {
+        const auto pathString = cstring(path);
+        auto file = mapFileReadOnly(pathString.c_str());
+        if (file.data == nullptr) {
+            cprintlnErr("heap snapshot open error: {}", pathString);
+            return false;
+        }
+        HeapSnapshotLoader loader(vm, thread);
+        const auto valid = loader.parse(static_cast<const u1 *>(file.data), file.size);
+        if (valid) {
+            loader.restore();
+        } else {
+            cprintlnErr("heap snapshot is stale or corrupted, ignored: {}", pathString);
+        }
+        unmapFile(file);
+        return valid;
+    }
+
+}
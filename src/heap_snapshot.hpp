@@ -0,0 +1,48 @@
+#ifndef HEAP_SNAPSHOT_HPP
+#define HEAP_SNAPSHOT_HPP
+
+#include "basic.hpp"
+
+namespace RexVM {
+
+    struct VM;
+    struct VMThread;
+
+    //堆快照 保存bootstrap(System.initializeSystemClass)执行完之后的堆 下次启动时恢复这份堆 不再执行bootstrap
+    //内容: 全部已加载的类名 已初始化类的静态字段 从类的mirror 静态字段和main线程可达的全部对象
+    //恢复时类按名字重新加载 对象重新分配后把引用换成新地址 mirror重新绑定到类和成员上 intern字符串放回String Pool
+    //文件格式(本机字节序 只在生成它的机器 同一份JAVA_HOME和classpath下使用):
+    //  SnapshotHeader
+    //  类: 类名 是否已初始化 已初始化时跟着静态字段
+    //  对象: 类型 类的下标 flags identity hash 字段或数组元素 引用保存为对象编号 0表示null
+    //  Throwable.backtrace中是Method指针 不保存 恢复后为null
+    struct SnapshotHeader {
+        char magic[8];
+        u8 stamp; //VM可执行文件 classpath JAVA_HOME和工作目录算出的hash 不一致时快照作废
+        u4 classCount;
+        u4 objectCount;
+        u4 mainThreadId; //快照中main线程对象的编号 恢复时对应到当前的main线程
+        u4 reserved;
+    };
+
+    enum class SnapshotObjectKind : u1 {
+        INSTANCE,
+        MIRROR,
+        OBJ_ARRAY,
+        TYPE_ARRAY,
+    };
+
+    [[nodiscard]] u8 getHeapSnapshotStamp(const VM &vm);
+    //magic和stamp都一致才能使用 其他VM或者过期的快照返回false
+    [[nodiscard]] bool isHeapSnapshotHeaderValid(const VM &vm, const u1 *data, size_t size);
+
+    //在main线程中initializeSystemClass执行完后调用 此时不能有其他存活的Java线程
+    bool writeHeapSnapshot(VM &vm, VMThread &thread, cview path);
+
+    //在GC线程和main线程启动前调用 不执行Java代码
+    //快照过期或者无法使用时返回false 此时还没有修改堆 按正常流程执行bootstrap
+    bool restoreHeapSnapshot(VM &vm, VMThread &thread, cview path);
+
+}
+
+#endif
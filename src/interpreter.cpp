@@ -1,4 +1,6 @@
 #include <cmath>
+#include <functional>
+#include <type_traits>
 
 #include "exception_helper.hpp"
 #include "utils/descriptor_parser.hpp"
@@ -12,82 +14,264 @@
 #include "class_loader.hpp"
 #include "thread.hpp"
 #include "method_handle.hpp"
+#include "method_profile.hpp"
+#include "interpreter_op.hpp"
 
 namespace RexVM {
 
     namespace ByteHandler {
-        void nop([[maybe_unused]] Frame &frame) {}
+        //方法有profile时记录分支是否跳转
+        inline void jumpIf(Frame &frame, const bool jump, const i4 offset) {
+            if (const auto profile = frame.profile; profile != nullptr) [[unlikely]] {
+                profile->getBranchProfile(CAST_U4(frame.pcCode))->record(jump);
+            }
+            if (jump) {
+                frame.reader.relativeOffset(offset);
+            }
+        }
 
-        void aconst_null(Frame &frame) {
-            frame.pushRef(nullptr);
+        //方法有profile时记录对象的类型 null单独标记
+        inline TypeProfile *profileType(const Frame &frame, const ref oop) {
+            const auto profile = frame.profile;
+            if (profile == nullptr) [[likely]] {
+                return nullptr;
+            }
+            const auto typeProfile = profile->getTypeProfile(CAST_U4(frame.pcCode));
+            if (oop == nullptr) {
+                typeProfile->recordNull();
+            } else {
+                typeProfile->record(oop->getClass());
+            }
+            return typeProfile;
+        }
+
+        //按值类型和运算模板化生成的指令 直接读写操作数栈内存 不经过Frame::push/pop
+        //每条指令sp只调整一次 结果写回原操作数的位置 类型不变时不重写类型标记
+        //值类型和运算定义在interpreter_op.hpp 寄存器形式的解释器(register_code.cpp)共用
+        //写入值和类型标记 宽类型的第二个槽位和pushI8/pushF8一样写0
+        template<typename T>
+        inline void writeTyped(const StackContext &stack, const i4 pos, const T val) {
+            using V = StackValue<T>;
+            stack.memory[pos] = Slot(val);
+            stack.memoryType[pos] = V::type;
+            if constexpr (V::size == 2) {
+                stack.memory[pos + 1] = ZERO_SLOT;
+                stack.memoryType[pos + 1] = V::type;
+            }
         }
 
-        void iconst_m1(Frame &frame) {
-            frame.pushI4(-1);
+        template<i4 delta>
+        inline void adjustSp(StackContext &stack) {
+            stack.sp += delta;
         }
 
-        void iconst_0(Frame &frame) {
-            frame.pushI4(0);
+        template<typename T>
+        inline void pushTyped(StackContext &stack, const T val) {
+            writeTyped<T>(stack, stack.sp + 1, val);
+            adjustSp<StackValue<T>::size>(stack);
         }
 
-        void iconst_1(Frame &frame) {
-            frame.pushI4(1);
+        template<typename T, i4 value>
+        void constant(Frame &frame) {
+            pushTyped<T>(frame.operandStackContext, static_cast<T>(value));
         }
 
-        void iconst_2(Frame &frame) {
-            frame.pushI4(2);
+        template<typename T>
+        void load(Frame &frame) {
+            const auto index = frame.reader.readU1();
+            pushTyped<T>(frame.operandStackContext, StackValue<T>::get(frame.localVariableTable[index]));
         }
 
-        void iconst_3(Frame &frame) {
-            frame.pushI4(3);
+        template<typename T, OpCodeEnum baseOpCode>
+        void loadN(Frame &frame) {
+            const auto index = frame.currentByteCode - CAST_U1(baseOpCode);
+            pushTyped<T>(frame.operandStackContext, StackValue<T>::get(frame.localVariableTable[index]));
         }
 
-        void iconst_4(Frame &frame) {
-            frame.pushI4(4);
+        template<typename T>
+        inline void storeLocal(Frame &frame, const size_t index) {
+            using V = StackValue<T>;
+            auto &stack = frame.operandStackContext;
+            frame.localVariableTable[index] = stack.memory[stack.sp - V::size + 1];
+            frame.localVariableTableType[index] = V::type;
+            if constexpr (V::size == 2) {
+                frame.localVariableTable[index + 1] = ZERO_SLOT;
+                frame.localVariableTableType[index + 1] = V::type;
+            }
+            adjustSp<-V::size>(stack);
         }
 
-        void iconst_5(Frame &frame) {
-            frame.pushI4(5);
+        template<typename T>
+        void store(Frame &frame) {
+            storeLocal<T>(frame, frame.reader.readU1());
         }
 
-        void lconst_0(Frame &frame) {
-            frame.pushI8(0);
+        template<typename T, OpCodeEnum baseOpCode>
+        void storeN(Frame &frame) {
+            storeLocal<T>(frame, frame.currentByteCode - CAST_U1(baseOpCode));
         }
 
-        void lconst_1(Frame &frame) {
-            frame.pushI8(1);
+        //[arrayref, index] -> [value] byte/char/short扩展为int
+        template<typename ArrayOopType, typename T>
+        void arrayLoad(Frame &frame) {
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - 1;
+            const auto array = static_cast<ArrayOopType *>(stack.memory[pos].refVal);
+            ASSERT_IF_NULL_THROW_NPE(array)
+            const auto value = static_cast<T>(array->data[stack.memory[pos + 1].i4Val]);
+            if constexpr (std::is_same_v<T, ref>) {
+                //arrayref所在槽位已经是REF
+                stack.memory[pos] = Slot(value);
+            } else {
+                writeTyped<T>(stack, pos, value);
+            }
+            adjustSp<StackValue<T>::size - 2>(stack);
+        }
+
+        //[arrayref, index, value] -> []
+        template<typename ArrayOopType, typename T>
+        void arrayStore(Frame &frame) {
+            using V = StackValue<T>;
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - V::size - 1;
+            const auto array = static_cast<ArrayOopType *>(stack.memory[pos].refVal);
+            adjustSp<-(V::size + 2)>(stack);
+            ASSERT_IF_NULL_THROW_NPE(array)
+            using ElementType = std::remove_reference_t<decltype(array->data[0])>;
+            array->data[stack.memory[pos + 1].i4Val] = static_cast<ElementType>(V::get(stack.memory[pos + 2]));
+        }
+
+        template<i4 size>
+        void popSlots(Frame &frame) {
+            adjustSp<-size>(frame.operandStackContext);
+        }
+
+        //[val1, val2] -> [result] 结果写回val1的位置
+        template<typename T, typename Op>
+        void binaryOp(Frame &frame) {
+            using V = StackValue<T>;
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - 2 * V::size + 1;
+            const auto val1 = V::get(stack.memory[pos]);
+            const auto val2 = V::get(stack.memory[pos + V::size]);
+            stack.memory[pos] = Slot(static_cast<T>(Op{}(val1, val2)));
+            adjustSp<-V::size>(stack);
+        }
+
+        //整数除法 除0抛出ArithmeticException
+        template<typename T, bool remainder>
+        void integerDivide(Frame &frame) {
+            using V = StackValue<T>;
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - 2 * V::size + 1;
+            const auto val1 = V::get(stack.memory[pos]);
+            const auto val2 = V::get(stack.memory[pos + V::size]);
+            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2)
+            stack.memory[pos] = Slot(integerDivideValue<T, remainder>(val1, val2));
+            adjustSp<-V::size>(stack);
+        }
+
+        template<typename T>
+        void negate(Frame &frame) {
+            auto &stack = frame.operandStackContext;
+            auto &slot = stack.memory[stack.sp - StackValue<T>::size + 1];
+            const auto val = StackValue<T>::get(slot);
+            if constexpr (std::is_integral_v<T>) {
+                slot = Slot(static_cast<T>(0 - static_cast<std::make_unsigned_t<T>>(val)));
+            } else {
+                slot = Slot(-val);
+            }
         }
 
-        void fconst_0(Frame &frame) {
-            frame.pushF4(0);
+        //[val1, int shift] -> [result] 位移数只取低5位(int)或低6位(long)
+        template<typename T, typename Op>
+        void shiftOp(Frame &frame) {
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - StackValue<T>::size;
+            const auto s = CAST_U4(stack.memory[stack.sp].i4Val) & (sizeof(T) * 8 - 1);
+            stack.memory[pos] = Slot(Op{}(StackValue<T>::get(stack.memory[pos]), s));
+            adjustSp<-1>(stack);
         }
 
-        void fconst_1(Frame &frame) {
-            frame.pushF4(1);
+        template<typename From, typename To>
+        void convert(Frame &frame) {
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - StackValue<From>::size + 1;
+            writeTyped<To>(stack, pos, static_cast<To>(StackValue<From>::get(stack.memory[pos])));
+            adjustSp<StackValue<To>::size - StackValue<From>::size>(stack);
         }
 
-        void fconst_2(Frame &frame) {
-            frame.pushF4(2);
+        //i2b i2c i2s 截断后扩展回int 类型标记不变
+        template<typename Narrow>
+        void narrow(Frame &frame) {
+            auto &slot = frame.operandStackContext.memory[frame.operandStackContext.sp];
+            slot = Slot(CAST_I4(static_cast<Narrow>(slot.i4Val)));
         }
 
-        void dconst_0(Frame &frame) {
-            frame.pushF8(0);
+        //lcmp fcmpl fcmpg dcmpl dcmpg 有NaN时结果为nanResult
+        template<typename T, i4 nanResult>
+        void compare(Frame &frame) {
+            using V = StackValue<T>;
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - 2 * V::size + 1;
+            const auto val1 = V::get(stack.memory[pos]);
+            const auto val2 = V::get(stack.memory[pos + V::size]);
+            writeTyped<i4>(stack, pos, compareValue<T, nanResult>(val1, val2));
+            adjustSp<1 - 2 * V::size>(stack);
+        }
+
+        //if<cond> ifnull ifnonnull 和0(null)比较
+        template<typename T, typename Cmp>
+        void ifZero(Frame &frame) {
+            const auto offset = frame.reader.readI2();
+            auto &stack = frame.operandStackContext;
+            const auto jump = Cmp{}(StackValue<T>::get(stack.memory[stack.sp]), T{});
+            adjustSp<-1>(stack);
+            jumpIf(frame, jump, offset);
         }
 
-        void dconst_1(Frame &frame) {
-            frame.pushF8(1);
+        //if_icmp<cond> if_acmp<cond>
+        template<typename T, typename Cmp>
+        void ifCompare(Frame &frame) {
+            const auto offset = frame.reader.readI2();
+            auto &stack = frame.operandStackContext;
+            const auto pos = stack.sp - 1;
+            const auto jump = Cmp{}(StackValue<T>::get(stack.memory[pos]), StackValue<T>::get(stack.memory[pos + 1]));
+            adjustSp<-2>(stack);
+            jumpIf(frame, jump, offset);
         }
 
+        void nop([[maybe_unused]] Frame &frame) {}
+
+        void aconst_null(Frame &frame) {
+            pushTyped<ref>(frame.operandStackContext, nullptr);
+        }
+
+        constexpr MethodHandler iconst_m1 = constant<i4, -1>;
+        constexpr MethodHandler iconst_0 = constant<i4, 0>;
+        constexpr MethodHandler iconst_1 = constant<i4, 1>;
+        constexpr MethodHandler iconst_2 = constant<i4, 2>;
+        constexpr MethodHandler iconst_3 = constant<i4, 3>;
+        constexpr MethodHandler iconst_4 = constant<i4, 4>;
+        constexpr MethodHandler iconst_5 = constant<i4, 5>;
+        constexpr MethodHandler lconst_0 = constant<i8, 0>;
+        constexpr MethodHandler lconst_1 = constant<i8, 1>;
+        constexpr MethodHandler fconst_0 = constant<f4, 0>;
+        constexpr MethodHandler fconst_1 = constant<f4, 1>;
+        constexpr MethodHandler fconst_2 = constant<f4, 2>;
+        constexpr MethodHandler dconst_0 = constant<f8, 0>;
+        constexpr MethodHandler dconst_1 = constant<f8, 1>;
+
         void bipush(Frame &frame) {
-            frame.pushI4(frame.reader.readI1());
+            pushTyped<i4>(frame.operandStackContext, frame.reader.readI1());
         }
 
         void sipush(Frame &frame) {
-            frame.pushI4(frame.reader.readI2());
+            pushTyped<i4>(frame.operandStackContext, frame.reader.readI2());
         }
 
         void ldc_(Frame &frame, u2 index) {
-            const auto &constantPool = frame.constantPool;
+            const auto &constantPool = frame.klass.constantPool;
             const auto valPtr = constantPool[index].get();
             const auto constantTagEnum = CAST_CONSTANT_TAG_ENUM(valPtr->tag);
 
@@ -138,234 +322,48 @@ namespace RexVM {
             ldc_(frame, index);
         }
 
-        void iload(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.pushLocal(index);
-        }
-
-        void lload(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.pushLocalWide(index);
-        }
-
-        void fload(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.pushLocal(index);
-        }
-
-        void dload(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.pushLocalWide(index);
-        }
-
-        void aload(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.pushLocal(index);
-        }
-
-        void iload_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::ILOAD_0);
-            frame.pushLocal(index);
-        }
-
-        void lload_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::LLOAD_0);
-            frame.pushLocalWide(index);
-        }
-
-        void fload_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::FLOAD_0);
-            frame.pushLocal(index);
-        }
-
-        void dload_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::DLOAD_0);
-            frame.pushLocalWide(index);
-        }
-
-        void aload_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::ALOAD_0);
-            frame.pushLocal(index);
-        }
-
-        void iaload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_INT_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushI4(array->data[index]);
-        }
-
-        void laload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_LONG_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushI8(array->data[index]);
-        }
-
-        void faload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_FLOAT_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushF4(array->data[index]);
-        }
-
-        void daload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_DOUBLE_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushF8(array->data[index]);
-        }
-
-        void aaload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_OBJ_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushRef(array->data[index]);
-        }
-
-        void baload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_BYTE_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushI4(array->data[index]);
-        }
-
-        void caload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_CHAR_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushI4(array->data[index]);
-        }
-
-        void saload(Frame &frame) {
-            const auto index = frame.popI4();
-            const auto array = CAST_SHORT_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            frame.pushI4(array->data[index]);
-        }
-
-        void istore(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.popLocal(index);
-        }
-
-        void lstore(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.popLocalWide(index);
-        }
-
-        void fstore(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.popLocal(index);
-        }
-
-        void dstore(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.popLocalWide(index);
-        }
-
-        void astore(Frame &frame) {
-            const auto index = frame.reader.readU1();
-            frame.popLocal(index);
-        }
-
-        void istorn_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::ISTORE_0);
-            frame.popLocal(index);
-        }
-
-        void lstorn_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::LSTORE_0);
-            frame.popLocalWide(index);
-        }
-
-        void fstorn_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::FSTORE_0);
-            frame.popLocal(index);
-        }
-
-        void dstorn_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::DSTORE_0);
-            frame.popLocalWide(index);
-        }
-
-        void astorn_n(Frame &frame) {
-            const auto index = frame.currentByteCode - CAST_U1(OpCodeEnum::ASTORE_0);
-            frame.popLocal(index);
-        }
-
-        void iastore(Frame &frame) {
-            const auto val = frame.popI4();
-            const auto index = frame.popI4();
-            const auto array = CAST_INT_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void lastore(Frame &frame) {
-            const auto val = frame.popI8();
-            const auto index = frame.popI4();
-            const auto array = CAST_LONG_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void fastore(Frame &frame) {
-            const auto val = frame.popF4();
-            const auto index = frame.popI4();
-            const auto array = CAST_FLOAT_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void dastore(Frame &frame) {
-            const auto val = frame.popF8();
-            const auto index = frame.popI4();
-            const auto array = CAST_DOUBLE_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void aastore(Frame &frame) {
-            const auto val = frame.popRef();
-            const auto index = frame.popI4();
-            const auto array = CAST_OBJ_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void bastore(Frame &frame) {
-            const auto val = frame.popI4();
-            const auto index = frame.popI4();
-            const auto array = CAST_BYTE_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void castore(Frame &frame) {
-            const auto val = frame.popI4();
-            const auto index = frame.popI4();
-            const auto array = CAST_CHAR_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void sastore(Frame &frame) {
-            const auto val = frame.popI4();
-            const auto index = frame.popI4();
-            const auto array = CAST_SHORT_TYPE_ARRAY_OOP(frame.popRef());
-            ASSERT_IF_NULL_THROW_NPE(array);
-            array->data[index] = val;
-        }
-
-        void pop(Frame &frame) {
-            frame.pop();
-        }
-
-        void pop2(Frame &frame) {
-            frame.pop();
-            frame.pop();
-        }
+        constexpr MethodHandler iload = load<i4>;
+        constexpr MethodHandler lload = load<i8>;
+        constexpr MethodHandler fload = load<f4>;
+        constexpr MethodHandler dload = load<f8>;
+        constexpr MethodHandler aload = load<ref>;
+        constexpr MethodHandler iload_n = loadN<i4, OpCodeEnum::ILOAD_0>;
+        constexpr MethodHandler lload_n = loadN<i8, OpCodeEnum::LLOAD_0>;
+        constexpr MethodHandler fload_n = loadN<f4, OpCodeEnum::FLOAD_0>;
+        constexpr MethodHandler dload_n = loadN<f8, OpCodeEnum::DLOAD_0>;
+        constexpr MethodHandler aload_n = loadN<ref, OpCodeEnum::ALOAD_0>;
+
+        constexpr MethodHandler iaload = arrayLoad<IntTypeArrayOop, i4>;
+        constexpr MethodHandler laload = arrayLoad<LongTypeArrayOop, i8>;
+        constexpr MethodHandler faload = arrayLoad<FloatTypeArrayOop, f4>;
+        constexpr MethodHandler daload = arrayLoad<DoubleTypeArrayOop, f8>;
+        constexpr MethodHandler aaload = arrayLoad<ObjArrayOop, ref>;
+        constexpr MethodHandler baload = arrayLoad<ByteTypeArrayOop, i4>;
+        constexpr MethodHandler caload = arrayLoad<CharTypeArrayOop, i4>;
+        constexpr MethodHandler saload = arrayLoad<ShortTypeArrayOop, i4>;
+
+        constexpr MethodHandler istore = store<i4>;
+        constexpr MethodHandler lstore = store<i8>;
+        constexpr MethodHandler fstore = store<f4>;
+        constexpr MethodHandler dstore = store<f8>;
+        constexpr MethodHandler astore = store<ref>;
+        constexpr MethodHandler istorn_n = storeN<i4, OpCodeEnum::ISTORE_0>;
+        constexpr MethodHandler lstorn_n = storeN<i8, OpCodeEnum::LSTORE_0>;
+        constexpr MethodHandler fstorn_n = storeN<f4, OpCodeEnum::FSTORE_0>;
+        constexpr MethodHandler dstorn_n = storeN<f8, OpCodeEnum::DSTORE_0>;
+        constexpr MethodHandler astorn_n = storeN<ref, OpCodeEnum::ASTORE_0>;
+
+        constexpr MethodHandler iastore = arrayStore<IntTypeArrayOop, i4>;
+        constexpr MethodHandler lastore = arrayStore<LongTypeArrayOop, i8>;
+        constexpr MethodHandler fastore = arrayStore<FloatTypeArrayOop, f4>;
+        constexpr MethodHandler dastore = arrayStore<DoubleTypeArrayOop, f8>;
+        constexpr MethodHandler aastore = arrayStore<ObjArrayOop, ref>;
+        constexpr MethodHandler bastore = arrayStore<ByteTypeArrayOop, i4>;
+        constexpr MethodHandler castore = arrayStore<CharTypeArrayOop, i4>;
+        constexpr MethodHandler sastore = arrayStore<ShortTypeArrayOop, i4>;
+
+        constexpr MethodHandler pop = popSlots<1>;
+        constexpr MethodHandler pop2 = popSlots<2>;
 
         void dup(Frame &frame) {
             frame.operandStackContext.dup();
@@ -395,233 +393,43 @@ namespace RexVM {
             frame.operandStackContext.swapTop();
         }
 
-        void iadd(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            const auto result = CAST_I4(CAST_U4(val1) + CAST_U4(val2));
-            frame.pushI4(result);
-        }
-
-        void ladd(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            const auto result = CAST_I8(CAST_U8(val1) + CAST_U8(val2));
-            frame.pushI8(result);
-        }
-
-        void fadd(Frame &frame) {
-            const auto val2 = frame.popF4();   
-            const auto val1 = frame.popF4();
-            frame.pushF4(val1 + val2);
-        }
-
-        void dadd(Frame &frame) {
-            const auto val2 = frame.popF8();   
-            const auto val1 = frame.popF8();
-            frame.pushF8(val1 + val2);
-        }
-
-        void isub(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            const auto result = CAST_I4(CAST_U4(val1) - CAST_U4(val2));
-            frame.pushI4(result);
-        }
-
-        void lsub(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            const auto result = CAST_I8(CAST_U8(val1) - CAST_U8(val2));
-            frame.pushI8(result);
-        }
-
-        void fsub(Frame &frame) {
-            const auto val2 = frame.popF4();   
-            const auto val1 = frame.popF4();
-            frame.pushF4(val1 - val2);
-        }
-
-        void dsub(Frame &frame) {
-            const auto val2 = frame.popF8();   
-            const auto val1 = frame.popF8();
-            frame.pushF8(val1 - val2);
-        }
-
-        void imul(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            const auto result = CAST_I4(CAST_U4(val1) * CAST_U4(val2));
-            frame.pushI4(result);
-        }
-
-        void lmul(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            const auto result = CAST_I8(CAST_U8(val1) * CAST_U8(val2));
-            frame.pushI8(result);
-        }
-
-        void fmul(Frame &frame) {
-            const auto val2 = frame.popF4();   
-            const auto val1 = frame.popF4();
-            frame.pushF4(val1 * val2);
-        }
-
-        void dmul(Frame &frame) {
-            const auto val2 = frame.popF8();   
-            const auto val1 = frame.popF8();
-            frame.pushF8(val1 * val2);
-        }
-
-        void idiv(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2);
-            frame.pushI4(val1 / val2);
-        }
-
-        void ldiv(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2);
-            frame.pushI8(val1 / val2);
-        }
-
-        void fdiv(Frame &frame) {
-            const auto val2 = frame.popF4();   
-            const auto val1 = frame.popF4();
-            frame.pushF4(val1 / val2);
-        }
-
-        void ddiv(Frame &frame) {
-            const auto val2 = frame.popF8();   
-            const auto val1 = frame.popF8();
-            frame.pushF8(val1 / val2);
-        }
-
-        void irem(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2);
-            frame.pushI4(val1 % val2);
-        }
-
-        void lrem(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2);
-            frame.pushI8(val1 % val2);
-        }
-
-         void frem(Frame &frame) {
-            const auto val2 = frame.popF4();   
-            const auto val1 = frame.popF4();
-            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2);
-            const auto result = std::fmod(val1, val2);
-            frame.pushF4(result);
-        }
-
-        void drem(Frame &frame) {
-            const auto val2 = frame.popF8();   
-            const auto val1 = frame.popF8();
-            ASSERT_IF_ZERO_THROW_DIV_ZERO(val2);
-            const auto result = std::fmod(val1, val2);
-            frame.pushF8(result);
-        }
-
-        void ineg(Frame &frame) {
-            frame.pushI4(-frame.popI4());
-        }
-
-        void lneg(Frame &frame) {
-            frame.pushI8(-frame.popI8());
-        }
-
-        void fneg(Frame &frame) {
-            frame.pushF4(-frame.popF4());
-        }
-
-        void dneg(Frame &frame) {
-            frame.pushF8(-frame.popF8());
-        }
-
-        void ishl(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            const auto s = (CAST_U4(val2)) & 0x1F;
-            frame.pushI4(val1 << s);
-        }
-
-        void lshl(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI8();
-            const auto s = (CAST_U4(val2)) & 0x3F;
-            frame.pushI8(val1 << s);
-        }
-
-        void ishr(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            const auto s = (CAST_U4(val2)) & 0x1F;
-            frame.pushI4(val1 >> s);
-        }
-
-        void lshr(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI8();
-            const auto s = (CAST_U4(val2)) & 0x3F;
-            frame.pushI8(val1 >> s);
-        }
-
-        void iushr(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            const auto s = (CAST_U4(val2)) & 0x1F;
-            frame.pushI4(CAST_U4(val1) >> s);
-        }
-
-        void lushr(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI8();
-            const auto s = (CAST_U4(val2)) & 0x3F;
-            frame.pushI8(CAST_U8(val1) >> s);
-        }
-
-        void iand(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            frame.pushI4(val1 & val2);
-        }
-
-        void land(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            frame.pushI8(val1 & val2);
-        }
-
-        void ior(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            frame.pushI4(val1 | val2);
-        }
-
-        void lor(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            frame.pushI8(val1 | val2);
-        }
-
-        void ixor(Frame &frame) {
-            const auto val2 = frame.popI4();   
-            const auto val1 = frame.popI4();
-            frame.pushI4(val1 ^ val2); 
-        }
-
-        void lxor(Frame &frame) {
-            const auto val2 = frame.popI8();   
-            const auto val1 = frame.popI8();
-            frame.pushI8(val1 ^ val2);
-        }
+        constexpr MethodHandler iadd = binaryOp<i4, AddOp>;
+        constexpr MethodHandler ladd = binaryOp<i8, AddOp>;
+        constexpr MethodHandler fadd = binaryOp<f4, AddOp>;
+        constexpr MethodHandler dadd = binaryOp<f8, AddOp>;
+        constexpr MethodHandler isub = binaryOp<i4, SubOp>;
+        constexpr MethodHandler lsub = binaryOp<i8, SubOp>;
+        constexpr MethodHandler fsub = binaryOp<f4, SubOp>;
+        constexpr MethodHandler dsub = binaryOp<f8, SubOp>;
+        constexpr MethodHandler imul = binaryOp<i4, MulOp>;
+        constexpr MethodHandler lmul = binaryOp<i8, MulOp>;
+        constexpr MethodHandler fmul = binaryOp<f4, MulOp>;
+        constexpr MethodHandler dmul = binaryOp<f8, MulOp>;
+        constexpr MethodHandler idiv = integerDivide<i4, false>;
+        constexpr MethodHandler ldiv = integerDivide<i8, false>;
+        constexpr MethodHandler fdiv = binaryOp<f4, std::divides<>>;
+        constexpr MethodHandler ddiv = binaryOp<f8, std::divides<>>;
+        constexpr MethodHandler irem = integerDivide<i4, true>;
+        constexpr MethodHandler lrem = integerDivide<i8, true>;
+        //浮点数取余除0结果为NaN 不抛异常
+        constexpr MethodHandler frem = binaryOp<f4, FRemOp>;
+        constexpr MethodHandler drem = binaryOp<f8, FRemOp>;
+        constexpr MethodHandler ineg = negate<i4>;
+        constexpr MethodHandler lneg = negate<i8>;
+        constexpr MethodHandler fneg = negate<f4>;
+        constexpr MethodHandler dneg = negate<f8>;
+        constexpr MethodHandler ishl = shiftOp<i4, ShlOp>;
+        constexpr MethodHandler lshl = shiftOp<i8, ShlOp>;
+        constexpr MethodHandler ishr = shiftOp<i4, ShrOp>;
+        constexpr MethodHandler lshr = shiftOp<i8, ShrOp>;
+        constexpr MethodHandler iushr = shiftOp<i4, UShrOp>;
+        constexpr MethodHandler lushr = shiftOp<i8, UShrOp>;
+        constexpr MethodHandler iand = binaryOp<i4, std::bit_and<>>;
+        constexpr MethodHandler land = binaryOp<i8, std::bit_and<>>;
+        constexpr MethodHandler ior = binaryOp<i4, std::bit_or<>>;
+        constexpr MethodHandler lor = binaryOp<i8, std::bit_or<>>;
+        constexpr MethodHandler ixor = binaryOp<i4, std::bit_xor<>>;
+        constexpr MethodHandler lxor = binaryOp<i8, std::bit_xor<>>;
 
         void iinc(Frame &frame) {
             const auto index = frame.reader.readU1();
@@ -629,260 +437,42 @@ namespace RexVM {
             frame.setLocalI4(index, frame.getLocalI4(index) + value);
         }
 
-        void i2l(Frame &frame) {
-            const auto val = frame.popI4();
-            frame.pushI8(CAST_I8(val));
-        }
-        
-        void i2f(Frame &frame) {
-            const auto val = frame.popI4();
-            frame.pushF4(CAST_F4(val));
-        }
-
-        void i2d(Frame &frame) {
-            const auto val = frame.popI4();
-            frame.pushF8(CAST_F8(val));
-        }
-
-        void l2i(Frame &frame) {
-            const auto val = frame.popI8();
-            frame.pushI4(CAST_I4(val));
-        }
-
-        void l2f(Frame &frame) {
-            const auto val = frame.popI8();
-            frame.pushF4(CAST_F4(val));
-        }
-
-        void l2d(Frame &frame) {
-            const auto val = frame.popI8();
-            frame.pushF8(CAST_F8(val));
-        }
-
-        void f2i(Frame &frame) {
-            const auto val = frame.popF4();
-            frame.pushI4(CAST_I4(val));
-        }
-
-        void f2l(Frame &frame) {
-            const auto val = frame.popF4();
-            frame.pushI8(CAST_I8(val));
-        }
-
-        void f2d(Frame &frame) {
-            const auto val = frame.popF4();
-            frame.pushF8(CAST_F8(val));
-        }
-
-        void d2i(Frame &frame) {
-            const auto val = frame.popF8();
-            frame.pushI4(CAST_I4(val));
-        }
-
-        void d2l(Frame &frame) {
-            const auto val = frame.popF8();
-            frame.pushI8(CAST_I8(val));
-        }
-
-        void d2f(Frame &frame) {
-            const auto val = frame.popF8();
-            frame.pushF4(CAST_F4(val));
-        }
-
-        void i2b(Frame &frame) {
-            const auto val = frame.popI4();
-            frame.pushI4(CAST_I1(val));
-        }
-
-        void i2c(Frame &frame) {
-            const auto val = frame.popI4();
-            frame.pushI4(CAST_U2(val));
-        }
-
-        void i2s(Frame &frame) {
-            const auto val = frame.popI4();
-            frame.pushI4(CAST_I2(val));
-        }
-
-        void lcmp(Frame &frame) {
-            const auto val2 = frame.popI8();
-            const auto val1 = frame.popI8();
-            if (val1 > val2) {
-                frame.pushI4(1);
-            } else if (val1 == val2) {
-                frame.pushI4(0);
-            } else {
-                frame.pushI4(-1);
-            }
-        }
-
-        void fcmp_(Frame &frame, bool gCheck) {
-            const auto val2 = frame.popF4();
-            const auto val1 = frame.popF4();
-            if (val1 > val2) {
-                frame.pushI4(1);
-            } else if (val1 == val2) {
-                frame.pushI4(0);
-            } else if (val1 < val2) {
-                frame.pushI4(-1);
-            } else if (gCheck) {
-                frame.pushI4(1);
-            } else {
-                frame.pushI4(-1);
-            }
-        }
-
-        void fcmpl(Frame &frame) {
-            fcmp_(frame, false);
-        }
-
-        void fcmpg(Frame &frame) {
-            fcmp_(frame, true);
-        }
-
-        void dcmp_(Frame &frame, bool gCheck) {
-            const auto val2 = frame.popF8();
-            const auto val1 = frame.popF8();
-            if (val1 > val2) {
-                frame.pushI4(1);
-            } else if (val1 == val2) {
-                frame.pushI4(0);
-            } else if (val1 < val2) {
-                frame.pushI4(-1);
-            } else if (gCheck) {
-                frame.pushI4(1);
-            } else {
-                frame.pushI4(-1);
-            }
-        }
-
-        void dcmpl(Frame &frame) {
-            dcmp_(frame, false);
-        }
-
-        void dcmpg(Frame &frame) {
-            dcmp_(frame, true);
-        }
-
-        void ifeq(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popI4();
-            if (val == 0) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void ifne(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popI4();
-            if (val != 0) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void iflt(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popI4();
-            if (val < 0) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void ifge(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popI4();
-            if (val >= 0) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void ifgt(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popI4();
-            if (val > 0) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void ifle(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popI4();
-            if (val <= 0) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_icmpeq(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popI4();
-            const auto val1 = frame.popI4();
-            if (val1 == val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_icmpne(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popI4();
-            const auto val1 = frame.popI4();
-            if (val1 != val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_icmplt(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popI4();
-            const auto val1 = frame.popI4();
-            if (val1 < val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_icmpge(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popI4();
-            const auto val1 = frame.popI4();
-            if (val1 >= val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_icmpgt(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popI4();
-            const auto val1 = frame.popI4();
-            if (val1 > val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_icmple(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popI4();
-            const auto val1 = frame.popI4();
-            if (val1 <= val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_acmpeq(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popRef();
-            const auto val1 = frame.popRef();
-            if (val1 == val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
-
-        void if_acmpne(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val2 = frame.popRef();
-            const auto val1 = frame.popRef();
-            if (val1 != val2) {
-                frame.reader.relativeOffset(offset);
-            }
-        }
+        constexpr MethodHandler i2l = convert<i4, i8>;
+        constexpr MethodHandler i2f = convert<i4, f4>;
+        constexpr MethodHandler i2d = convert<i4, f8>;
+        constexpr MethodHandler l2i = convert<i8, i4>;
+        constexpr MethodHandler l2f = convert<i8, f4>;
+        constexpr MethodHandler l2d = convert<i8, f8>;
+        constexpr MethodHandler f2i = convert<f4, i4>;
+        constexpr MethodHandler f2l = convert<f4, i8>;
+        constexpr MethodHandler f2d = convert<f4, f8>;
+        constexpr MethodHandler d2i = convert<f8, i4>;
+        constexpr MethodHandler d2l = convert<f8, i8>;
+        constexpr MethodHandler d2f = convert<f8, f4>;
+        constexpr MethodHandler i2b = narrow<i1>;
+        constexpr MethodHandler i2c = narrow<u2>;
+        constexpr MethodHandler i2s = narrow<i2>;
+
+        constexpr MethodHandler lcmp = compare<i8, -1>;
+        constexpr MethodHandler fcmpl = compare<f4, -1>;
+        constexpr MethodHandler fcmpg = compare<f4, 1>;
+        constexpr MethodHandler dcmpl = compare<f8, -1>;
+        constexpr MethodHandler dcmpg = compare<f8, 1>;
+
+        constexpr MethodHandler ifeq = ifZero<i4, std::equal_to<>>;
+        constexpr MethodHandler ifne = ifZero<i4, std::not_equal_to<>>;
+        constexpr MethodHandler iflt = ifZero<i4, std::less<>>;
+        constexpr MethodHandler ifge = ifZero<i4, std::greater_equal<>>;
+        constexpr MethodHandler ifgt = ifZero<i4, std::greater<>>;
+        constexpr MethodHandler ifle = ifZero<i4, std::less_equal<>>;
+        constexpr MethodHandler if_icmpeq = ifCompare<i4, std::equal_to<>>;
+        constexpr MethodHandler if_icmpne = ifCompare<i4, std::not_equal_to<>>;
+        constexpr MethodHandler if_icmplt = ifCompare<i4, std::less<>>;
+        constexpr MethodHandler if_icmpge = ifCompare<i4, std::greater_equal<>>;
+        constexpr MethodHandler if_icmpgt = ifCompare<i4, std::greater<>>;
+        constexpr MethodHandler if_icmple = ifCompare<i4, std::less_equal<>>;
+        constexpr MethodHandler if_acmpeq = ifCompare<ref, std::equal_to<>>;
+        constexpr MethodHandler if_acmpne = ifCompare<ref, std::not_equal_to<>>;
 
         void goto_(Frame &frame) {
             const auto offset = frame.reader.readI2();
@@ -1044,7 +634,7 @@ namespace RexVM {
                         ->getMethod(methodName, METHOD_HANDLE_INVOKE_ORIGIN_DESCRIPTOR, false);
             //1第一个参数为MethodHandle Object
             const auto popLength = getMethodParamSlotSizeFromDescriptor(methodDescriptor, false);
-            frame.runMethodInner(*invokeMethod, popLength);
+            frame.prepareInvoke(*invokeMethod, popLength);
         }
 
         template<bool checkMethodHandle>
@@ -1052,11 +642,12 @@ namespace RexVM {
             const auto cache = frame.mem.resolveInvokeVirtualIndex(index, checkMethodHandle);
             if constexpr (checkMethodHandle) {
                 if (cache->mhMethod != nullptr) {
-                    frame.runMethodInner(*cache->mhMethod, cache->mhMethodPopSize);
+                    frame.prepareInvoke(*cache->mhMethod, cache->mhMethodPopSize);
                     return;
                 }
             }
             const auto instance = frame.getStackOffset(cache->paramSlotSize - 1).refVal;
+            profileType(frame, instance);
             ASSERT_IF_NULL_THROW_NPE(instance);
             const auto instanceClass = CAST_INSTANCE_CLASS(instance->getClass());
 
@@ -1066,8 +657,8 @@ namespace RexVM {
                 cache->methodDescriptor,
                 instanceClass
             );
-            frame.runMethodInner(*realInvokeMethod);
-            frame.mem.safePoint();
+            //被调用方法结束后 executeFrame会在回到当前Frame时执行safePoint
+            frame.prepareInvoke(*realInvokeMethod);
         }
 
         template<bool isStatic>
@@ -1081,8 +672,7 @@ namespace RexVM {
             // if constexpr (clinit) {
             //     invokeMethod->klass.clinit(frame);
             // }
-            frame.runMethodInner(*invokeMethod);
-            frame.mem.safePoint();
+            frame.prepareInvoke(*invokeMethod);
         }
 
         void invokevirtual(Frame &frame) {
@@ -1163,11 +753,15 @@ namespace RexVM {
         void checkcast(Frame &frame) {
             const auto index = frame.reader.readU2();
             const auto ref = frame.operandStackContext.top().refVal;
+            const auto typeProfile = profileType(frame, ref);
             if (ref == nullptr) {
                 return;
             }
             const auto checkClass = frame.mem.getRefClass(index);
             if (!ref->isInstanceOf(checkClass)) {
+                if (typeProfile != nullptr) {
+                    typeProfile->failedCount.increment();
+                }
                 throwClassCastException(frame, ref->getClass()->getClassName(), checkClass->getClassName());
             }
         }
@@ -1175,6 +769,7 @@ namespace RexVM {
         void instanceof(Frame &frame) {
             const auto index = frame.reader.readU2();
             const auto ref = frame.pop().refVal;
+            profileType(frame, ref);
             if (ref == nullptr) {
                 frame.pushI4(0);
                 return;
@@ -1253,30 +848,62 @@ namespace RexVM {
             frame.pushRef(multiArray);
         }
 
-        void ifnull(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popRef();
+        constexpr MethodHandler ifnull = ifZero<ref, std::equal_to<>>;
+        constexpr MethodHandler ifnonnull = ifZero<ref, std::not_equal_to<>>;
 
-            if (val == nullptr) {
-                frame.reader.relativeOffset(offset);
-            }
+        void goto_w(Frame &frame) {
+            const auto offset = frame.reader.readI4();
+            frame.reader.relativeOffset(offset);
+            frame.mem.safePoint();
         }
 
-        void ifnonnull(Frame &frame) {
-            const auto offset = frame.reader.readI2();
-            const auto val = frame.popRef();
+        //超级指令 一次分派执行一个指令序列 字节码中只有第一个操作码被替换 序列中其他指令保持原样
+        //每条指令执行前和interpretFrame一样更新pc 异常表 行号和分支profile都使用原始pc
+        inline void nextFusedInstruction(Frame &frame) {
+            auto &reader = frame.reader;
+            reader.resetCurrentOffset();
+            frame.pcCode = CAST_U4(reader.ptr - reader.begin);
+            frame.currentByteCode = reader.readU1();
+        }
 
-            if (val != nullptr) {
-                frame.reader.relativeOffset(offset);
-            }
+        template<MethodHandler First, MethodHandler... Rest>
+        void superInstruction(Frame &frame) {
+            First(frame);
+            ((nextFusedInstruction(frame), Rest(frame)), ...);
         }
 
-        void goto_w(Frame &frame) {
-            const auto offset = frame.reader.readI4();
-            frame.reader.relativeOffset(offset);
-            frame.mem.safePoint();
+        //序列的第一条指令已经被替换 局部变量下标由超级指令确定
+        template<typename T, size_t index>
+        void loadFixed(Frame &frame) {
+            pushTyped<T>(frame.operandStackContext, StackValue<T>::get(frame.localVariableTable[index]));
         }
-        
+
+        //序列中间的load指令可能是xload或者xload_n
+        template<typename T, OpCodeEnum loadOpCode, OpCodeEnum baseOpCode>
+        void loadAny(Frame &frame) {
+            if (frame.currentByteCode == CAST_U1(loadOpCode)) {
+                load<T>(frame);
+            } else {
+                loadN<T, baseOpCode>(frame);
+            }
+        }
+
+        constexpr MethodHandler iloadAny = loadAny<i4, OpCodeEnum::ILOAD, OpCodeEnum::ILOAD_0>;
+
+        constexpr MethodHandler super_aload_0_getfield = superInstruction<loadFixed<ref, 0>, getfield>;
+        constexpr MethodHandler super_aload_0_invokespecial = superInstruction<loadFixed<ref, 0>, invokespecial>;
+        constexpr MethodHandler super_iload_iload_if_icmpge = superInstruction<iload, iloadAny, if_icmpge>;
+        constexpr MethodHandler super_iload_0_iload_if_icmpge = superInstruction<loadFixed<i4, 0>, iloadAny, if_icmpge>;
+        constexpr MethodHandler super_iload_1_iload_if_icmpge = superInstruction<loadFixed<i4, 1>, iloadAny, if_icmpge>;
+        constexpr MethodHandler super_iload_2_iload_if_icmpge = superInstruction<loadFixed<i4, 2>, iloadAny, if_icmpge>;
+        constexpr MethodHandler super_iload_3_iload_if_icmpge = superInstruction<loadFixed<i4, 3>, iloadAny, if_icmpge>;
+        constexpr MethodHandler super_aload_arraylength = superInstruction<aload, arraylength>;
+        constexpr MethodHandler super_aload_0_arraylength = superInstruction<loadFixed<ref, 0>, arraylength>;
+        constexpr MethodHandler super_aload_1_arraylength = superInstruction<loadFixed<ref, 1>, arraylength>;
+        constexpr MethodHandler super_aload_2_arraylength = superInstruction<loadFixed<ref, 2>, arraylength>;
+        constexpr MethodHandler super_aload_3_arraylength = superInstruction<loadFixed<ref, 3>, arraylength>;
+        constexpr MethodHandler super_iinc_goto = superInstruction<iinc, goto_>;
+
     }
 
     std::array<MethodHandler, 256> OpCodeHandlers{
@@ -1481,6 +1108,47 @@ namespace RexVM {
         ByteHandler::ifnull, // = 198:  ifnull
         ByteHandler::ifnonnull, // = 199:  ifnonnull
         ByteHandler::goto_w, // = 200:  goto_w
+        nullptr, // = 201:  reserved
+        nullptr, // = 202:  reserved
+        nullptr, // = 203:  reserved
+        nullptr, // = 204:  reserved
+        nullptr, // = 205:  reserved
+        nullptr, // = 206:  reserved
+        nullptr, // = 207:  reserved
+        nullptr, // = 208:  reserved
+        nullptr, // = 209:  reserved
+        nullptr, // = 210:  reserved
+        nullptr, // = 211:  reserved
+        nullptr, // = 212:  reserved
+        nullptr, // = 213:  reserved
+        nullptr, // = 214:  reserved
+        nullptr, // = 215:  reserved
+        nullptr, // = 216:  reserved
+        nullptr, // = 217:  reserved
+        nullptr, // = 218:  reserved
+        nullptr, // = 219:  reserved
+        nullptr, // = 220:  reserved
+        nullptr, // = 221:  reserved
+        nullptr, // = 222:  reserved
+        nullptr, // = 223:  reserved
+        nullptr, // = 224:  reserved
+        nullptr, // = 225:  reserved
+        nullptr, // = 226:  reserved
+        nullptr, // = 227:  reserved
+        nullptr, // = 228:  reserved
+        ByteHandler::super_aload_0_getfield, // = 229:  super_aload_0_getfield
+        ByteHandler::super_aload_0_invokespecial, // = 230:  super_aload_0_invokespecial
+        ByteHandler::super_iload_iload_if_icmpge, // = 231:  super_iload_iload_if_icmpge
+        ByteHandler::super_iload_0_iload_if_icmpge, // = 232:  super_iload_0_iload_if_icmpge
+        ByteHandler::super_iload_1_iload_if_icmpge, // = 233:  super_iload_1_iload_if_icmpge
+        ByteHandler::super_iload_2_iload_if_icmpge, // = 234:  super_iload_2_iload_if_icmpge
+        ByteHandler::super_iload_3_iload_if_icmpge, // = 235:  super_iload_3_iload_if_icmpge
+        ByteHandler::super_aload_arraylength, // = 236:  super_aload_arraylength
+        ByteHandler::super_aload_0_arraylength, // = 237:  super_aload_0_arraylength
+        ByteHandler::super_aload_1_arraylength, // = 238:  super_aload_1_arraylength
+        ByteHandler::super_aload_2_arraylength, // = 239:  super_aload_2_arraylength
+        ByteHandler::super_aload_3_arraylength, // = 240:  super_aload_3_arraylength
+        ByteHandler::super_iinc_goto, // = 241:  super_iinc_goto
     };
 
 }
@@ -0,0 +1,104 @@
+#ifndef INTERPRETER_OP_HPP
+#define INTERPRETER_OP_HPP
+#include <cmath>
+#include <type_traits>
+#include "basic.hpp"
+
+namespace RexVM {
+
+    //解释器和寄存器形式的解释器共用的值类型和运算 保证两者的运算语义一致
+    template<typename T>
+    struct StackValue;
+
+#define DEFINE_STACK_VALUE(valueType, slotType, slotSize, field) \
+    template<> \
+    struct StackValue<valueType> { \
+        static constexpr auto type = SlotTypeEnum::slotType; \
+        static constexpr i4 size = slotSize; \
+        static valueType get(const Slot slot) { return slot.field; } \
+    };
+
+    DEFINE_STACK_VALUE(i4, I4, 1, i4Val)
+    DEFINE_STACK_VALUE(i8, I8, 2, i8Val)
+    DEFINE_STACK_VALUE(f4, F4, 1, f4Val)
+    DEFINE_STACK_VALUE(f8, F8, 2, f8Val)
+    DEFINE_STACK_VALUE(ref, REF, 1, refVal)
+
+#undef DEFINE_STACK_VALUE
+
+    //整数运算按无符号计算 溢出时回绕 与Java语义一致
+#define DEFINE_WRAP_OP(name, op) \
+    struct name { \
+        template<typename T> \
+        T operator()(const T a, const T b) const { \
+            if constexpr (std::is_integral_v<T>) { \
+                using U = std::make_unsigned_t<T>; \
+                return static_cast<T>(static_cast<U>(a) op static_cast<U>(b)); \
+            } else { \
+                return a op b; \
+            } \
+        } \
+    };
+
+    DEFINE_WRAP_OP(AddOp, +)
+    DEFINE_WRAP_OP(SubOp, -)
+    DEFINE_WRAP_OP(MulOp, *)
+
+#undef DEFINE_WRAP_OP
+
+    struct FRemOp {
+        template<typename T>
+        T operator()(const T a, const T b) const {
+            return std::fmod(a, b);
+        }
+    };
+
+    struct ShlOp {
+        template<typename T>
+        T operator()(const T a, const u4 s) const {
+            return static_cast<T>(static_cast<std::make_unsigned_t<T>>(a) << s);
+        }
+    };
+
+    struct ShrOp {
+        template<typename T>
+        T operator()(const T a, const u4 s) const {
+            return a >> s;
+        }
+    };
+
+    struct UShrOp {
+        template<typename T>
+        T operator()(const T a, const u4 s) const {
+            return static_cast<T>(static_cast<std::make_unsigned_t<T>>(a) >> s);
+        }
+    };
+
+    //调用者已经检查除数不为0
+    //MIN_VALUE / -1在C++中是未定义行为(x86上会触发SIGFPE) Java中商为MIN_VALUE 余数为0
+    template<typename T, bool remainder>
+    T integerDivideValue(const T val1, const T val2) {
+        if (val2 == -1) [[unlikely]] {
+            return remainder ? 0 : static_cast<T>(0 - static_cast<std::make_unsigned_t<T>>(val1));
+        }
+        return remainder ? val1 % val2 : val1 / val2;
+    }
+
+    //lcmp fcmpl fcmpg dcmpl dcmpg 有NaN时结果为nanResult
+    template<typename T, i4 nanResult>
+    i4 compareValue(const T val1, const T val2) {
+        if (val1 > val2) {
+            return 1;
+        }
+        if (val1 == val2) {
+            return 0;
+        }
+        if (val1 < val2) {
+            return -1;
+        }
+        return nanResult;
+    }
+
+}
+
+#endif
@@ -0,0 +1,363 @@
+#include "intrinsic.hpp"
+#include <cmath>
+#include <bit>
+#include <cstring>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include "utils/format.hpp"
+#include "oop.hpp"
+#include "class.hpp"
+#include "frame.hpp"
+#include "key_slot_id.hpp"
+#include "basic_type.hpp"
+#include "basic_java_class.hpp"
+#include "exception_helper.hpp"
+
+namespace RexVM {
+
+    constexpr i4 MIN_SUPPLEMENTARY_CODE_POINT = 0x010000;
+    constexpr i4 MAX_CODE_POINT = 0x10FFFF;
+
+    CharTypeArrayOop *getStringValue(const InstanceOop *str) {
+        return CAST_CHAR_TYPE_ARRAY_OOP(str->getFieldValue(stringClassValueFieldSlotId).refVal);
+    }
+
+    //在[begin, end)中查找ch 找不到返回end
+    const cchar_16 *findChar(const cchar_16 *begin, const cchar_16 *end, const cchar_16 ch) {
+        auto ptr = begin;
+#if defined(__SSE2__)
+        const auto target = _mm_set1_epi16(static_cast<i2>(ch));
+        for (; ptr + 8 <= end; ptr += 8) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+            if (const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(chunk, target)); mask != 0) {
+                //每个char在mask中占2位
+                return ptr + std::countr_zero(CAST_U4(mask)) / 2;
+            }
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const auto target = vdupq_n_u16(static_cast<u2>(ch));
+        for (; ptr + 8 <= end; ptr += 8) {
+            const auto chunk = vld1q_u16(reinterpret_cast<const u2 *>(ptr));
+            if (vmaxvq_u16(vceqq_u16(chunk, target)) != 0) {
+                //命中的8个char交给下面的逐个比较定位
+                break;
+            }
+        }
+#endif
+        for (; ptr < end; ++ptr) {
+            if (*ptr == ch) {
+                return ptr;
+            }
+        }
+        return end;
+    }
+
+    void *getTypeArrayData(Oop *array, const BasicType elementType) {
+        switch (elementType) {
+            case BasicType::T_BOOLEAN:
+            case BasicType::T_BYTE:
+                return CAST_BYTE_TYPE_ARRAY_OOP(array)->data.get();
+            case BasicType::T_CHAR:
+                return CAST_CHAR_TYPE_ARRAY_OOP(array)->data.get();
+            case BasicType::T_SHORT:
+                return CAST_SHORT_TYPE_ARRAY_OOP(array)->data.get();
+            case BasicType::T_INT:
+                return CAST_INT_TYPE_ARRAY_OOP(array)->data.get();
+            case BasicType::T_LONG:
+                return CAST_LONG_TYPE_ARRAY_OOP(array)->data.get();
+            case BasicType::T_FLOAT:
+                return CAST_FLOAT_TYPE_ARRAY_OOP(array)->data.get();
+            case BasicType::T_DOUBLE:
+                return CAST_DOUBLE_TYPE_ARRAY_OOP(array)->data.get();
+            default:
+                panic("getTypeArrayData error: type error");
+        }
+        return nullptr;
+    }
+
+    bool stringEquals(const InstanceOop *str, Oop *other) {
+        if (str == other) {
+            return true;
+        }
+        //String是final类 类型相同即是String
+        if (other == nullptr || other->getClass() != str->getClass()) {
+            return false;
+        }
+        const auto value = getStringValue(str);
+        const auto otherValue = getStringValue(CAST_INSTANCE_OOP(other));
+        const auto length = value->getDataLength();
+        return length == otherValue->getDataLength()
+            && (length == 0
+                || std::memcmp(value->data.get(), otherValue->data.get(), sizeof(cchar_16) * length) == 0);
+    }
+
+    i4 stringHashCode(const InstanceOop *str) {
+        if (const auto hash = str->getFieldValue(stringClassHashFieldSlotId).i4Val; hash != 0) {
+            return hash;
+        }
+        const auto value = getStringValue(str);
+        const auto data = value->data.get();
+        const auto length = value->getDataLength();
+        //h = 31 * h + c 每次展开4个字符 缩短乘法的依赖链 31^2 = 961 31^3 = 29791 31^4 = 923521
+        u4 h = 0;
+        size_t i = 0;
+        for (; i + 4 <= length; i += 4) {
+            h = h * 923521U
+                + CAST_U4(data[i]) * 29791U
+                + CAST_U4(data[i + 1]) * 961U
+                + CAST_U4(data[i + 2]) * 31U
+                + CAST_U4(data[i + 3]);
+        }
+        for (; i < length; ++i) {
+            h = h * 31U + CAST_U4(data[i]);
+        }
+        const auto hash = CAST_I4(h);
+        if (hash != 0) {
+            str->setFieldValue(stringClassHashFieldSlotId, Slot(hash));
+        }
+        return hash;
+    }
+
+    i4 stringIndexOf(const InstanceOop *str, const i4 ch, i4 fromIndex) {
+        const auto value = getStringValue(str);
+        const auto data = value->data.get();
+        const auto length = CAST_I4(value->getDataLength());
+        if (fromIndex < 0) {
+            fromIndex = 0;
+        } else if (fromIndex >= length) {
+            return -1;
+        }
+
+        if (ch < MIN_SUPPLEMENTARY_CODE_POINT) {
+            if (ch < 0) {
+                return -1;
+            }
+            const auto end = data + length;
+            const auto result = findChar(data + fromIndex, end, static_cast<cchar_16>(ch));
+            return result == end ? -1 : CAST_I4(result - data);
+        }
+
+        if (ch > MAX_CODE_POINT) {
+            return -1;
+        }
+        //增补字符 按代理对查找
+        const auto high = static_cast<cchar_16>(((ch - MIN_SUPPLEMENTARY_CODE_POINT) >> 10) + 0xD800);
+        const auto low = static_cast<cchar_16>(((ch - MIN_SUPPLEMENTARY_CODE_POINT) & 0x3FF) + 0xDC00);
+        for (auto i = fromIndex; i < length - 1; ++i) {
+            if (data[i] == high && data[i + 1] == low) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool arrayEquals(Oop *a, Oop *b) {
+        if (a == b) {
+            return true;
+        }
+        if (a == nullptr || b == nullptr) {
+            return false;
+        }
+        const auto length = a->getDataLength();
+        if (length != b->getDataLength()) {
+            return false;
+        }
+        if (length == 0) {
+            return true;
+        }
+        //只登记了整数类型数组 按字节比较和逐个元素比较结果一致
+        const auto elementType = CAST_TYPE_ARRAY_CLASS(a->getClass())->elementType;
+        return std::memcmp(
+            getTypeArrayData(a, elementType),
+            getTypeArrayData(b, elementType),
+            length * getElementSizeByBasicType(elementType)
+        ) == 0;
+    }
+
+    void arrayFill(Oop *array, const Slot value) {
+        const auto length = array->getDataLength();
+        switch (CAST_TYPE_ARRAY_CLASS(array->getClass())->elementType) {
+            case BasicType::T_BOOLEAN:
+            case BasicType::T_BYTE:
+                std::fill_n(CAST_BYTE_TYPE_ARRAY_OOP(array)->data.get(), length, static_cast<u1>(value.i4Val));
+                break;
+            case BasicType::T_CHAR:
+                std::fill_n(CAST_CHAR_TYPE_ARRAY_OOP(array)->data.get(), length, static_cast<cchar_16>(value.i4Val));
+                break;
+            case BasicType::T_SHORT:
+                std::fill_n(CAST_SHORT_TYPE_ARRAY_OOP(array)->data.get(), length, static_cast<i2>(value.i4Val));
+                break;
+            case BasicType::T_INT:
+                std::fill_n(CAST_INT_TYPE_ARRAY_OOP(array)->data.get(), length, value.i4Val);
+                break;
+            case BasicType::T_LONG:
+                std::fill_n(CAST_LONG_TYPE_ARRAY_OOP(array)->data.get(), length, value.i8Val);
+                break;
+            case BasicType::T_FLOAT:
+                std::fill_n(CAST_FLOAT_TYPE_ARRAY_OOP(array)->data.get(), length, value.f4Val);
+                break;
+            case BasicType::T_DOUBLE:
+                std::fill_n(CAST_DOUBLE_TYPE_ARRAY_OOP(array)->data.get(), length, value.f8Val);
+                break;
+            default:
+                panic("arrayFill error: type error");
+        }
+    }
+
+    namespace Intrinsics {
+
+        //boolean equals(Object anObject)
+        void stringEquals(Frame &frame) {
+            frame.returnBoolean(RexVM::stringEquals(frame.getThisInstance(), frame.getLocalRef(1)));
+        }
+
+        //int hashCode()
+        void stringHashCode(Frame &frame) {
+            frame.returnI4(RexVM::stringHashCode(frame.getThisInstance()));
+        }
+
+        //int indexOf(int ch)
+        void stringIndexOf(Frame &frame) {
+            frame.returnI4(RexVM::stringIndexOf(frame.getThisInstance(), frame.getLocalI4(1), 0));
+        }
+
+        //int indexOf(int ch, int fromIndex)
+        void stringIndexOfFrom(Frame &frame) {
+            frame.returnI4(RexVM::stringIndexOf(frame.getThisInstance(), frame.getLocalI4(1), frame.getLocalI4(2)));
+        }
+
+        //static boolean equals(int[] a, int[] a2)
+        void arraysEquals(Frame &frame) {
+            frame.returnBoolean(arrayEquals(frame.getLocalRef(0), frame.getLocalRef(1)));
+        }
+
+        //static void fill(int[] a, int val)
+        void arraysFill(Frame &frame) {
+            const auto array = frame.getLocalRef(0);
+            ASSERT_IF_NULL_THROW_NPE(array)
+            arrayFill(array, frame.getLocal(1));
+        }
+
+        void mathMinI(Frame &frame) {
+            frame.returnI4(std::min(frame.getLocalI4(0), frame.getLocalI4(1)));
+        }
+
+        void mathMaxI(Frame &frame) {
+            frame.returnI4(std::max(frame.getLocalI4(0), frame.getLocalI4(1)));
+        }
+
+        void mathMinJ(Frame &frame) {
+            frame.returnI8(std::min(frame.getLocalI8(0), frame.getLocalI8(2)));
+        }
+
+        void mathMaxJ(Frame &frame) {
+            frame.returnI8(std::max(frame.getLocalI8(0), frame.getLocalI8(2)));
+        }
+
+        //abs(Integer.MIN_VALUE) == Integer.MIN_VALUE 用无符号取反避免溢出
+        void mathAbsI(Frame &frame) {
+            const auto val = frame.getLocalI4(0);
+            frame.returnI4(CAST_I4(val < 0 ? 0U - CAST_U4(val) : CAST_U4(val)));
+        }
+
+        void mathAbsJ(Frame &frame) {
+            const auto val = frame.getLocalI8(0);
+            frame.returnI8(CAST_I8(val < 0 ? 0ULL - CAST_U8(val) : CAST_U8(val)));
+        }
+
+        void mathAbsF(Frame &frame) {
+            frame.returnF4(std::fabs(frame.getLocalF4(0)));
+        }
+
+        void mathAbsD(Frame &frame) {
+            frame.returnF8(std::fabs(frame.getLocalF8(0)));
+        }
+
+        void mathSqrt(Frame &frame) {
+            frame.returnF8(std::sqrt(frame.getLocalF8(0)));
+        }
+
+        void integerBitCount(Frame &frame) {
+            frame.returnI4(std::popcount(CAST_U4(frame.getLocalI4(0))));
+        }
+
+        void integerNumberOfLeadingZeros(Frame &frame) {
+            frame.returnI4(std::countl_zero(CAST_U4(frame.getLocalI4(0))));
+        }
+
+    }
+
+    IntrinsicManager::IntrinsicManager() {
+        regAllIntrinsics();
+    }
+
+    IntrinsicManager IntrinsicManager::instance;
+
+    void IntrinsicManager::regIntrinsic(
+            const cview className, const cview methodName, const cview descriptor,
+            const IntrinsicEnum type, const NativeMethodHandler handler
+    ) {
+        const auto key = cformat("{}:{}:{}", className, methodName, descriptor);
+        intrinsics.emplace(key, Intrinsic{type, handler});
+        if (std::ranges::find(classNames, className) == classNames.end()) {
+            classNames.emplace_back(className);
+        }
+    }
+
+    const Intrinsic *IntrinsicManager::getIntrinsic(const cview className, const cview methodName, const cview descriptor) const {
+        if (std::ranges::find(classNames, className) == classNames.end()) {
+            return nullptr;
+        }
+        const auto key = cformat("{}:{}:{}", className, methodName, descriptor);
+        if (const auto iter = intrinsics.find(key); iter != intrinsics.end()) {
+            return &iter->second;
+        }
+        return nullptr;
+    }
+
+    void IntrinsicManager::regAllIntrinsics() {
+        regIntrinsic(JAVA_LANG_STRING_NAME, "equals", "(Ljava/lang/Object;)Z", IntrinsicEnum::STRING_EQUALS, Intrinsics::stringEquals);
+        regIntrinsic(JAVA_LANG_STRING_NAME, "hashCode", "()I", IntrinsicEnum::STRING_HASH_CODE, Intrinsics::stringHashCode);
+        regIntrinsic(JAVA_LANG_STRING_NAME, "indexOf", "(I)I", IntrinsicEnum::STRING_INDEX_OF, Intrinsics::stringIndexOf);
+        regIntrinsic(JAVA_LANG_STRING_NAME, "indexOf", "(II)I", IntrinsicEnum::STRING_INDEX_OF, Intrinsics::stringIndexOfFrom);
+
+        //float和double数组的equals按floatToIntBits比较 NaN的处理和按字节比较不同 不做内建
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "equals", "([Z[Z)Z", IntrinsicEnum::ARRAYS_EQUALS, Intrinsics::arraysEquals);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "equals", "([B[B)Z", IntrinsicEnum::ARRAYS_EQUALS, Intrinsics::arraysEquals);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "equals", "([C[C)Z", IntrinsicEnum::ARRAYS_EQUALS, Intrinsics::arraysEquals);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "equals", "([S[S)Z", IntrinsicEnum::ARRAYS_EQUALS, Intrinsics::arraysEquals);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "equals", "([I[I)Z", IntrinsicEnum::ARRAYS_EQUALS, Intrinsics::arraysEquals);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "equals", "([J[J)Z", IntrinsicEnum::ARRAYS_EQUALS, Intrinsics::arraysEquals);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([ZZ)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([BB)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([CC)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([SS)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([II)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([JJ)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([FF)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+        regIntrinsic(JAVA_UTIL_ARRAYS_NAME, "fill", "([DD)V", IntrinsicEnum::ARRAYS_FILL, Intrinsics::arraysFill);
+
+        //float和double的min/max要处理NaN和-0.0 保持字节码实现
+        regIntrinsic(JAVA_LANG_MATH_NAME, "min", "(II)I", IntrinsicEnum::MATH_MIN_I, Intrinsics::mathMinI);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "max", "(II)I", IntrinsicEnum::MATH_MAX_I, Intrinsics::mathMaxI);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "min", "(JJ)J", IntrinsicEnum::MATH_MIN_J, Intrinsics::mathMinJ);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "max", "(JJ)J", IntrinsicEnum::MATH_MAX_J, Intrinsics::mathMaxJ);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "abs", "(I)I", IntrinsicEnum::MATH_ABS_I, Intrinsics::mathAbsI);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "abs", "(J)J", IntrinsicEnum::MATH_ABS_J, Intrinsics::mathAbsJ);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "abs", "(F)F", IntrinsicEnum::MATH_ABS_F, Intrinsics::mathAbsF);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "abs", "(D)D", IntrinsicEnum::MATH_ABS_D, Intrinsics::mathAbsD);
+        regIntrinsic(JAVA_LANG_MATH_NAME, "sqrt", "(D)D", IntrinsicEnum::MATH_SQRT, Intrinsics::mathSqrt);
+
+        regIntrinsic(JAVA_LANG_INTEGER_NAME, "bitCount", "(I)I", IntrinsicEnum::INTEGER_BIT_COUNT, Intrinsics::integerBitCount);
+        regIntrinsic(JAVA_LANG_INTEGER_NAME, "numberOfLeadingZeros", "(I)I", IntrinsicEnum::INTEGER_NUMBER_OF_LEADING_ZEROS, Intrinsics::integerNumberOfLeadingZeros);
+
+        //native方法 解释器直接使用native实现 只登记给JIT
+        regIntrinsic(JAVA_LANG_OBJECT_NAME, "getClass", "()Ljava/lang/Class;", IntrinsicEnum::OBJECT_GET_CLASS, nullptr);
+        regIntrinsic(JAVA_LANG_CLASS_NAME, "isInstance", "(Ljava/lang/Object;)Z", IntrinsicEnum::CLASS_IS_INSTANCE, nullptr);
+    }
+
+}
@@ -0,0 +1,73 @@
+#ifndef INTRINSIC_HPP
+#define INTRINSIC_HPP
+
+#include <vector>
+#include <hash_table8.hpp>
+#include "basic.hpp"
+
+namespace RexVM {
+
+    struct Oop;
+    struct InstanceOop;
+
+    //JDK热点方法的内建实现 解释器执行C++实现 JIT在调用点直接生成IR或调用helper
+    enum class IntrinsicEnum : u1 {
+        NONE,
+        STRING_EQUALS,
+        STRING_HASH_CODE,
+        STRING_INDEX_OF,
+        ARRAYS_EQUALS,
+        ARRAYS_FILL,
+        MATH_MIN_I,
+        MATH_MAX_I,
+        MATH_MIN_J,
+        MATH_MAX_J,
+        MATH_ABS_I,
+        MATH_ABS_J,
+        MATH_ABS_F,
+        MATH_ABS_D,
+        MATH_SQRT,
+        INTEGER_BIT_COUNT,
+        INTEGER_NUMBER_OF_LEADING_ZEROS,
+        OBJECT_GET_CLASS,
+        CLASS_IS_INSTANCE,
+    };
+
+    struct Intrinsic {
+        IntrinsicEnum type{IntrinsicEnum::NONE};
+        //替换字节码方法体的实现 native方法本身已经是C++实现 为空
+        NativeMethodHandler handler{};
+    };
+
+    struct IntrinsicManager {
+
+        emhash8::HashMap<cstring, Intrinsic> intrinsics;
+        //有内建实现的类 加载其他类的方法时不用拼接key查表
+        std::vector<cstring> classNames;
+
+        void regIntrinsic(
+                cview className, cview methodName, cview descriptor,
+                IntrinsicEnum type, NativeMethodHandler handler
+        );
+
+        //在方法链接(Method创建)时查找 没有内建实现返回nullptr
+        [[nodiscard]] const Intrinsic *getIntrinsic(cview className, cview methodName, cview descriptor) const;
+
+        //static safe
+        static IntrinsicManager instance;
+
+        explicit IntrinsicManager();
+
+        void regAllIntrinsics();
+    };
+
+    //解释器和JIT helper共用的实现
+    [[nodiscard]] bool stringEquals(const InstanceOop *str, Oop *other);
+    [[nodiscard]] i4 stringHashCode(const InstanceOop *str);
+    [[nodiscard]] i4 stringIndexOf(const InstanceOop *str, i4 ch, i4 fromIndex);
+    [[nodiscard]] bool arrayEquals(Oop *a, Oop *b);
+    void arrayFill(Oop *array, Slot value);
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "jit_help_function.hpp"
+#include <bit>
 #include "../basic.hpp"
 #include "../vm.hpp"
 #include "../frame.hpp"
@@ -9,6 +10,9 @@
 #include "../exception_helper.hpp"
 #include "../method_handle.hpp"
 #include "../garbage_collect.hpp"
+#include "../jit_manager.hpp"
+#include "../mirror_oop.hpp"
+#include "../intrinsic.hpp"
 
 extern "C" {
 
@@ -16,16 +20,16 @@ extern "C" {
 
     void *llvm_compile_get_instance_constant(void *framePtr, const uint32_t index) {
         const auto frame = static_cast<Frame *>(framePtr);
-        const auto valPtr = frame->constantPool[index].get();
+        const auto valPtr = frame->klass.constantPool[index].get();
         const auto constantTagEnum = CAST_CONSTANT_TAG_ENUM(valPtr->tag);
         if (constantTagEnum == ConstantTagEnum::CONSTANT_String) {
             const auto stringConstInfo = CAST_CONSTANT_STRING_INFO(valPtr);
-            const auto strValue = getConstantStringFromPool(frame->constantPool, stringConstInfo->index);
+            const auto strValue = getConstantStringFromPool(frame->klass.constantPool, stringConstInfo->index);
             return frame->mem.getInternString(strValue);
         }
         if (constantTagEnum == ConstantTagEnum::CONSTANT_Class) {
             const auto classConstInfo = CAST_CONSTANT_CLASS_INFO(valPtr);
-            const auto className = getConstantStringFromPool(frame->constantPool, classConstInfo->index);
+            const auto className = getConstantStringFromPool(frame->klass.constantPool, classConstInfo->index);
             const auto value = frame->mem.getClass(className);
             return value->getMirror(frame);
         }
@@ -82,6 +86,11 @@ extern "C" {
         if (method != nullptr) {
             operandStack.sp += CAST_I4(paramSize);
             invokeMethod = static_cast<Method *>(method);
+            //CHA或profile直接绑定的虚方法 接收者为null时不能进入被调函数
+            if (!invokeMethod->isStatic() && paramSize > 0 && frame->getStackOffset(paramSize - 1).refVal == nullptr) {
+                throwNullPointException(*frame);
+                return frame->throwValue;
+            }
             invokeMethod->klass.clinit(*frame);
             if (frame->markThrow) {
                 return frame->throwValue;
@@ -177,6 +186,27 @@ extern "C" {
         }
     }
 
+    void *llvm_compile_new_object_fast(void *framePtr, void *klass, const int32_t length) {
+        //编译期已经确定: 类已初始化且是普通类 数组类已经解析
+        //不需要clinit检查 不会抛异常 也不用按类名查找数组类(会加classLoader的锁)
+        const auto frame = static_cast<Frame *>(framePtr);
+        frame->mem.safePoint();
+        switch (const auto klassPtr = CAST_CLASS(klass); klassPtr->type) {
+            case ClassTypeEnum::INSTANCE_CLASS:
+                return frame->mem.newInstance(CAST_INSTANCE_CLASS(klassPtr));
+
+            case ClassTypeEnum::TYPE_ARRAY_CLASS:
+                return frame->mem.newTypeArrayOop(CAST_TYPE_ARRAY_CLASS(klassPtr), length);
+
+            case ClassTypeEnum::OBJ_ARRAY_CLASS:
+                return frame->mem.newObjArrayOop(CAST_OBJ_ARRAY_CLASS(klassPtr), length);
+
+            default:
+                panic("llvm_compile_new_object_fast error: class type");
+                return nullptr;
+        }
+    }
+
     void llvm_compile_throw_exception(
         void *framePtr,
         void *exOop,
@@ -278,4 +308,53 @@ extern "C" {
         return -1;
     }
 
+    void llvm_compile_deoptimize(void *framePtr, const uint32_t pc, const uint16_t stackSize, const uint8_t reason) {
+        //编译代码中的推测失败 lvt和操作数栈已经由编译代码写回frame内存
+        //这里恢复pc和sp 并标记frame 由executeFrame从pc处继续解释执行
+        const auto frame = static_cast<Frame *>(framePtr);
+        frame->pcCode = CAST_I4(pc);
+        frame->operandStackContext.sp = CAST_I4(stackSize) - 1;
+        frame->markDeopt = true;
+        frame->vm.jitManager->deoptimize(frame->method, pc, reason);
+    }
+
+    //不需要frame的内建方法 编译代码直接调用 不经过invoke_method_fixed创建frame
+    //调用前编译代码已经做过null检查 这里不会抛出异常
+    int64_t llvm_compile_intrinsic(void *framePtr, void *pa, void *pb, const int64_t va, const int32_t vb, const uint8_t type) {
+        switch (static_cast<IntrinsicEnum>(type)) {
+            case IntrinsicEnum::STRING_EQUALS:
+                return stringEquals(CAST_INSTANCE_OOP(pa), CAST_REF(pb)) ? 1 : 0;
+
+            case IntrinsicEnum::STRING_HASH_CODE:
+                return stringHashCode(CAST_INSTANCE_OOP(pa));
+
+            case IntrinsicEnum::STRING_INDEX_OF:
+                return stringIndexOf(CAST_INSTANCE_OOP(pa), CAST_I4(va), vb);
+
+            case IntrinsicEnum::ARRAYS_EQUALS:
+                return arrayEquals(CAST_REF(pa), CAST_REF(pb)) ? 1 : 0;
+
+            case IntrinsicEnum::ARRAYS_FILL:
+                arrayFill(CAST_REF(pa), Slot(CAST_I8(va)));
+                return 0;
+
+            case IntrinsicEnum::OBJECT_GET_CLASS: {
+                const auto frame = static_cast<Frame *>(framePtr);
+                return std::bit_cast<int64_t>(CAST_REF(pa)->getClass()->getMirror(frame));
+            }
+
+            case IntrinsicEnum::CLASS_IS_INSTANCE: {
+                if (pb == nullptr) {
+                    return 0;
+                }
+                const auto mirrorClass = CAST_MIRROR_OOP(pa)->getMirrorClass();
+                return CAST_REF(pb)->getClass()->isInstanceOf(mirrorClass) ? 1 : 0;
+            }
+
+            default:
+                panic("llvm_compile_intrinsic error: type error");
+        }
+        return 0;
+    }
+
 }
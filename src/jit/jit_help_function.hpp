@@ -28,6 +28,11 @@ constexpr uint8_t LLVM_COMPILER_MISC_CHECK_INSTANCE_OF = 3;
 constexpr uint8_t LLVM_COMPILER_MISC_CLEAN_THROW = 4;
 constexpr uint8_t LLVM_COMPILER_MISC_SAFE_POINT = 5;
 
+constexpr uint8_t LLVM_COMPILER_DEOPT_NULL_CHECK = 0;
+constexpr uint8_t LLVM_COMPILER_DEOPT_CLASS_CHECK = 1;
+constexpr uint8_t LLVM_COMPILER_DEOPT_CLASS_HIERARCHY = 2;
+constexpr uint8_t LLVM_COMPILER_DEOPT_TYPE_PROFILE = 3;
+
 extern "C" {
     void *llvm_compile_get_instance_constant(void *framePtr, uint32_t index);
 
@@ -37,11 +42,17 @@ extern "C" {
 
     void *llvm_compile_new_object(void *framePtr, uint8_t type, int32_t length, void *klass, int32_t *exception);
 
+    void *llvm_compile_new_object_fast(void *framePtr, void *klass, int32_t length);
+
     void llvm_compile_throw_exception(void *framePtr, void *exOop, uint32_t pc, uint8_t fixedException, void *exField);
 
     int32_t llvm_compile_match_catch(void *oop, void **catchClassArray, int32_t size);
 
     int32_t llvm_compile_misc(void *framePtr, void *pa, void *pb, uint8_t type);
+
+    void llvm_compile_deoptimize(void *framePtr, uint32_t pc, uint16_t stackSize, uint8_t reason);
+
+    int64_t llvm_compile_intrinsic(void *framePtr, void *pa, void *pb, int64_t va, int32_t vb, uint8_t type);
 }
 
 #endif
\ No newline at end of file
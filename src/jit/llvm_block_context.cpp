@@ -177,6 +177,14 @@ namespace RexVM {
         return blockValueStack.top();
     }
 
+    llvm::Value *BlockContext::peekValue(const size_t depth) const {
+        auto valueStack = blockValueStack;
+        for (size_t i = 0; i < depth; ++i) {
+            valueStack.pop();
+        }
+        return valueStack.top();
+    }
+
     void BlockContext::padding() {
         pushValue(nullptr); 
     }
@@ -207,7 +215,7 @@ namespace RexVM {
 
     void BlockContext::compile() {
         const auto &method = methodCompiler.method;
-        const auto codeBegin = method.code.get();
+        const auto codeBegin = method.code;
 
         methodCompiler.changeBB(*this, basicBlock);
         initPassStack();
@@ -220,7 +228,7 @@ namespace RexVM {
         }
 
         ByteReader reader{};
-        const auto codePtr = method.code.get() + methodBlock->startPC;
+        const auto codePtr = method.code + methodBlock->startPC;
         const auto codeLength = methodBlock->endPC - methodBlock->startPC;
         reader.init(codePtr, codeLength);
 
@@ -235,6 +243,9 @@ namespace RexVM {
                 methodCompiler.writeModifyLocalVariableTable(*this);
             }
 
+            if (methodCompiler.useSpeculate) {
+                instructionValueStack = blockValueStack;
+            }
             processInstruction(opCode, reader);
 
             if (methodBlock->autoJmp && lastOpCode) {
@@ -1045,7 +1056,7 @@ namespace RexVM {
             }
 
             case OpCodeEnum::TABLESWITCH: {
-                const auto nextPc = CAST_U4(byteReader.ptr - methodCompiler.method.code.get());
+                const auto nextPc = CAST_U4(byteReader.ptr - methodCompiler.method.code);
                 if (const auto mod = nextPc % 4; mod != 0) {
                     byteReader.skip(4 - mod);
                 }
@@ -1071,7 +1082,7 @@ namespace RexVM {
             }
 
             case OpCodeEnum::LOOKUPSWITCH: {
-                const auto nextPc = CAST_U4(byteReader.ptr - methodCompiler.method.code.get());
+                const auto nextPc = CAST_U4(byteReader.ptr - methodCompiler.method.code);
                 if (const auto mod = nextPc % 4; mod != 0) {
                     byteReader.skip(4 - mod);
                 }
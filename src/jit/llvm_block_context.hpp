@@ -37,6 +37,8 @@ namespace RexVM {
         std::vector<std::unique_ptr<PassStack>> passStack;
         //当前块的StackValue
         std::stack<llvm::Value *> blockValueStack;
+        //当前指令执行前的StackValue 去优化时用来重建解释器的操作数栈
+        std::stack<llvm::Value *> instructionValueStack;
 
         //当前块的本地变量表
         std::vector<llvm::Value *> localVariableTable;
@@ -67,6 +69,9 @@ namespace RexVM {
 
         llvm::Value *topValue();
 
+        //取栈顶往下第depth个slot的值 0是栈顶
+        [[nodiscard]] llvm::Value *peekValue(size_t depth) const;
+
         void padding();
 
         void unPadding();
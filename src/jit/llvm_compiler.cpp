@@ -1,6 +1,7 @@
 #include "llvm_compiler.hpp"
 #include <llvm/ExecutionEngine/JITLink/JITLink.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/IR/MDBuilder.h>
 #include "llvm_block_context.hpp"
 #include "jit_help_function.hpp"
 #include "llvm_register_help_function.hpp"
@@ -12,6 +13,8 @@
 #include "../class_loader.hpp"
 #include "../constant_info.hpp"
 #include "../method_handle.hpp"
+#include "../method_profile.hpp"
+#include "../intrinsic.hpp"
 #include "../utils/descriptor_parser.hpp"
 
 
@@ -23,6 +26,7 @@ namespace RexVM {
 
     constexpr u2 INSTANCE_OOP_DATA_FIELD_OFFSET = sizeof(Oop);
     constexpr u2 ARRAY_OOP_DATA_FIELD_OFFSET = sizeof(Oop);
+    constexpr u2 OOP_COM_CLASS_FIELD_OFFSET = offsetof(Oop, comClass);
 
     MethodCompiler::MethodCompiler(
         VM &vm,
@@ -37,6 +41,8 @@ namespace RexVM {
         useLVTOptimize(vm.params.jitLVTOptimize),
         checkStackError(vm.params.jitCheckStack),
         useException(vm.params.jitSupportException),
+        useSpeculate(vm.params.jitSpeculate),
+        useRelocatableConstant(!vm.params.jitCodeCacheDir.empty()),
         cfg(method),
         module(module),
         ctx(module.getContext()),
@@ -46,6 +52,10 @@ namespace RexVM {
         localPtr(localCount, nullptr),
         localTypePtr(localCount, nullptr) {
 
+        if (vm.params.jitProfile) {
+            profile = method.getProfile();
+        }
+
         const auto functionType =
                 FunctionType::get(
                     irBuilder.getVoidTy(),
@@ -299,6 +309,8 @@ namespace RexVM {
                 irBuilder.CreateGEP(irBuilder.getInt8Ty(), oop, offset);
 
         const auto dataFieldValue = irBuilder.CreateLoad(voidPtrType, oopDataFieldPtr);
+        //oop创建后data指针不会再变 标记为invariant 循环中的数组访问可以把它提到循环外
+        markInvariantLoad(dataFieldValue);
         //InstanceOop element is Slot
         const u4 elementByteSize = isArray ? getElementSizeByBasicType(type) : SLOT_BYTE_SIZE;
         const u4 elementBitSize = elementByteSize * 8;
@@ -306,7 +318,7 @@ namespace RexVM {
 
         //再通过slotId或者数据的index 获取具体数据的地址
         const auto dataFieldPtr =
-                irBuilder.CreateGEP(
+                irBuilder.CreateInBoundsGEP(
                     dataPtrType,
                     dataFieldValue,
                     index
@@ -404,9 +416,60 @@ namespace RexVM {
 
 
     void MethodCompiler::throwNpeIfNull(BlockContext &blockContext, llvm::Value *val) {
+        if (canSpeculate(blockContext)) {
+            //推测不为null 为null时去优化 由解释器重新执行当前指令抛出NPE并查找异常处理
+            const auto isNull = irBuilder.CreateICmpEQ(val, getZeroValue(SlotTypeEnum::REF));
+            deoptimizeIf(blockContext, isNull, LLVM_COMPILER_DEOPT_NULL_CHECK);
+            return;
+        }
         throwIfZero(blockContext, val, SlotTypeEnum::REF);
     }
 
+    bool MethodCompiler::canSpeculate(const BlockContext &blockContext) const {
+        //去优化过的pc不再推测 避免反复去优化
+        return useSpeculate && !method.isDeoptPC(blockContext.pc);
+    }
+
+    void MethodCompiler::deoptimize(BlockContext &blockContext, const u1 reason) {
+        //把当前指令执行前的状态写回frame 解释器从当前pc重新执行这条指令
+        //lvt写回内存 操作数栈写到lvt之后的内存 也就是传参用的内存
+        writeModifyLocalVariableTable(blockContext);
+
+        auto valueStack = blockContext.instructionValueStack;
+        std::vector<llvm::Value *> stackValues(valueStack.size());
+        for (i4 i = CAST_I4(stackValues.size()) - 1; i >= 0; --i) {
+            stackValues[i] = valueStack.top();
+            valueStack.pop();
+        }
+
+        addParamSlot(blockContext, stackValues.size());
+        auto slotType = SlotTypeEnum::NONE;
+        for (size_t i = 0; i < stackValues.size(); ++i) {
+            //nullptr 是宽类型的padding 类型和前一个slot相同
+            if (const auto value = stackValues[i]; value != nullptr) {
+                slotType = llvmTypeMap(value->getType());
+                irBuilder.CreateStore(value, invokeMethodParamPtr[i]);
+            }
+            irBuilder.CreateStore(irBuilder.getInt8(static_cast<uint8_t>(slotType)), invokeMethodParamTypePtr[i]);
+        }
+
+        helpFunction->createCallDeoptimize(irBuilder, getFramePtr(), blockContext.pc, CAST_U2(stackValues.size()), reason);
+        exitMethod();
+    }
+
+    void MethodCompiler::deoptimizeIf(BlockContext &blockContext, llvm::Value *cond, const u1 reason) {
+        const auto deoptBB = BasicBlock::Create(ctx);
+        const auto continueBB = BasicBlock::Create(ctx);
+        //推测失败是小概率分支
+        const auto branchWeights = MDBuilder(ctx).createBranchWeights(1, 1 << 20);
+        irBuilder.CreateCondBr(cond, deoptBB, continueBB, branchWeights);
+
+        changeBB(blockContext, deoptBB);
+        deoptimize(blockContext, reason);
+
+        changeBB(blockContext, continueBB);
+    }
+
     void MethodCompiler::throwException(BlockContext &blockContext, llvm::Value *ex) {
         throwNpeIfNull(blockContext, ex);
         helpFunction->createCallThrowException(
@@ -460,19 +523,35 @@ namespace RexVM {
         setLocalVariableTableValue(blockContext, index, value, slotType);
     }
 
+    llvm::Value *MethodCompiler::getOopComClass(llvm::Value *oop) {
+        //comClass 低位是Class指针 高位是数组长度 对象创建后不再改变
+        const auto comClassPtr =
+                irBuilder.CreateGEP(irBuilder.getInt8Ty(), oop, irBuilder.getInt32(OOP_COM_CLASS_FIELD_OFFSET));
+        const auto comClass = irBuilder.CreateLoad(irBuilder.getInt64Ty(), comClassPtr);
+        markInvariantLoad(comClass);
+        return comClass;
+    }
+
+    llvm::Value *MethodCompiler::getOopClass(llvm::Value *oop) {
+        const auto klassAddress = irBuilder.CreateAnd(getOopComClass(oop), irBuilder.getInt64(COM_PTR_MASK));
+        return irBuilder.CreateIntToPtr(klassAddress, voidPtrType);
+    }
+
     void MethodCompiler::arrayLength(BlockContext &blockContext, llvm::Value *arrayRef) {
         throwNpeIfNull(blockContext, arrayRef);
-        const auto arrayLength =
-                helpFunction->createCallMisc(
-                    irBuilder,
-                    getFramePtr(),
-                    arrayRef,
-                    getZeroValue(SlotTypeEnum::REF),
-                    LLVM_COMPILER_MISC_ARRAY_LENGTH
-                );
+        //数组长度保存在comClass的高位 直接读取 不调用helper 循环条件里的length才能被LLVM识别为循环不变量
+        const auto comClass = getOopComClass(arrayRef);
+        const auto arrayLength = irBuilder.CreateTrunc(
+            irBuilder.CreateLShr(comClass, irBuilder.getInt64(COM_PTR_LENGTH)),
+            slotTypeMap(SlotTypeEnum::I4)
+        );
         blockContext.pushValue(arrayLength);
     }
 
+    void MethodCompiler::markInvariantLoad(LoadInst *load) const {
+        load->setMetadata(LLVMContext::MD_invariant_load, MDNode::get(ctx, {}));
+    }
+
     void MethodCompiler::arrayLoad(BlockContext &blockContext, llvm::Value *arrayRef, llvm::Value *index,
                                    const uint8_t type) {
         //arrayRef 是 arrayOop
@@ -663,6 +742,23 @@ namespace RexVM {
         return CAST_U4(CAST_I4(blockContext.pc) + offset);
     }
 
+    llvm::MDNode *MethodCompiler::getBranchWeights(const u4 pc) const {
+        if (profile == nullptr) {
+            return nullptr;
+        }
+        const auto branchProfile = profile->getBranchProfile(pc);
+        if (branchProfile == nullptr) {
+            return nullptr;
+        }
+        const auto taken = branchProfile->taken.get();
+        const auto notTaken = branchProfile->notTaken.get();
+        if (taken == 0 && notTaken == 0) {
+            return nullptr;
+        }
+        //解释器统计的跳转比例 LLVM据此安排基本块布局 冷分支移到函数后部
+        return MDBuilder(ctx).createBranchWeights(taken, notTaken);
+    }
+
     void MethodCompiler::ifOp(const BlockContext &blockContext, const i4 offset, llvm::Value *val1, llvm::Value *val2, const OpCodeEnum op) {
         const auto jumpToBB = getBlockContext(offsetToPC(blockContext, offset))->basicBlock;
         // const auto nextOpCodeBB = cfgBlocks[blockContext.methodBlock->index + 1]->basicBlock;
@@ -699,7 +795,7 @@ namespace RexVM {
         }
         //const auto elseBB = BasicBlock::Create(ctx);
         const auto elseBB = nextOpCodeBB;
-        irBuilder.CreateCondBr(cmp, jumpToBB, elseBB);
+        irBuilder.CreateCondBr(cmp, jumpToBB, elseBB, getBranchWeights(blockContext.pc));
         // changeBB(blockContext, elseBB);
     }
 
@@ -738,6 +834,24 @@ namespace RexVM {
     }
 
     llvm::Value *MethodCompiler::getConstantPtr(void *ptr) {
+        if (useRelocatableConstant && ptr != nullptr) {
+            //以外部全局变量的地址代替常量指针 链接时由JIT填入真实地址
+            if (const auto iter = constantSymbolMap.find(ptr); iter != constantSymbolMap.end()) {
+                return iter->second;
+            }
+            const auto symbolName = cformat("{}{}", JIT_CONSTANT_SYMBOL_PREFIX, constantSymbols.size());
+            const auto globalVariable = new GlobalVariable(
+                module,
+                irBuilder.getInt8Ty(),
+                false,
+                GlobalValue::ExternalLinkage,
+                nullptr,
+                symbolName
+            );
+            constantSymbols.emplace_back(ptr);
+            constantSymbolMap.emplace(ptr, globalVariable);
+            return globalVariable;
+        }
         const auto ptrInt = irBuilder.getInt64(std::bit_cast<uint64_t>(ptr));
         return ConstantExpr::getIntToPtr(ptrInt, voidPtrType);
     }
@@ -803,6 +917,11 @@ namespace RexVM {
             }
         }
 
+        if (includeThis) {
+            //this为null时报npe 检查要在pop参数之前 推测失败去优化时操作数栈还是指令执行前的状态
+            throwNpeIfNull(blockContext, blockContext.peekValue(paramSlotType.size() - 1));
+        }
+
         //由于JIT模式下的函数不需要使用操作数栈进行计算 所以操作数栈只用来做函数传参 传参时用首地址即可
         //根据Frame的初始化定义 操作数栈的首地址 operandStackPtr = lvtPtr + lvtSize
         //对于普通java函数 lvtSize = localCount 所以可以直接计算出操作数栈的地址
@@ -812,11 +931,6 @@ namespace RexVM {
             //假设有4个参数 则 i = 3,2,1,0
             //具体的参数
             const auto paramValue = blockContext.popValue();
-            if (includeThis && i == 0) {
-                //对于需要传this的场景 要判断传入是否为null 为null报npe
-                throwNpeIfNull(blockContext, paramValue);
-            }
-
             const auto slotPtr = invokeMethodParamPtr[i];
             const auto slotTypePtr = invokeMethodParamTypePtr[i];
 
@@ -859,6 +973,12 @@ namespace RexVM {
         const auto [className, methodName, methodDescriptor] =
                 getConstantStringFromPoolByClassNameType(constantPool, index);
 
+        const auto methodRef = klass.getRefMethod(index, isStatic);
+        //invokespecial调用的可能是子类覆盖前的实现 只对static方法做内建
+        if (isStatic && invokeIntrinsic(blockContext, *methodRef)) {
+            return;
+        }
+
         const auto [paramType, returnType] = parseMethodDescriptor(methodDescriptor);
         const auto paramSlotSize = pushParams(blockContext, paramType, !isStatic);
 
@@ -870,29 +990,287 @@ namespace RexVM {
         //2. 在调用完成时 假设有返回值 我们依然可以通过传参同样的方式从当前函数操作数栈里拿到返回值
         //但拿到返回值理应通过pop操作数栈完成 所以在调用完成后method_fixed还需要做返回值对应sp的减操作
 
-        const auto methodRef = klass.getRefMethod(index, isStatic);
-
         invokeCommon(blockContext, methodName, returnType, getConstantPtr(methodRef), paramSlotSize);
     }
 
+    Method *MethodCompiler::devirtualize(
+        BlockContext &blockContext,
+        const cview className,
+        const cview methodName,
+        const cview methodDescriptor
+    ) {
+        if (!canSpeculate(blockContext)) {
+            return nullptr;
+        }
+        //只对已经加载的类做CHA 不在编译线程里加载类
+        auto &classLoader = klass.classLoader;
+        const auto receiverClass = classLoader.findLoadedClass(className);
+        if (receiverClass == nullptr || !receiverClass->isInstanceClass()) {
+            return nullptr;
+        }
+
+        if (dependency == nullptr) {
+            dependency = classLoader.createCompiledMethodDependency(method);
+        }
+        const auto uniqueMethod =
+                classLoader.findUniqueConcreteMethod(
+                    CAST_INSTANCE_CLASS(receiverClass),
+                    methodName,
+                    methodDescriptor,
+                    *dependency
+                );
+        if (uniqueMethod == nullptr) {
+            return nullptr;
+        }
+
+        //加载新子类后依赖失效 正在执行的编译代码在这里去优化 回到解释器重新分派
+        const auto invalid = irBuilder.CreateLoad(irBuilder.getInt8Ty(), getConstantPtr(&dependency->invalid));
+        invalid->setAtomic(AtomicOrdering::Monotonic);
+        const auto isInvalid = irBuilder.CreateICmpNE(invalid, irBuilder.getInt8(0));
+        deoptimizeIf(blockContext, isInvalid, LLVM_COMPILER_DEOPT_CLASS_HIERARCHY);
+        return uniqueMethod;
+    }
+
+    Method *MethodCompiler::speculateReceiverType(
+        BlockContext &blockContext,
+        const cview methodName,
+        const cview methodDescriptor
+    ) {
+        if (!canSpeculate(blockContext) || profile == nullptr) {
+            return nullptr;
+        }
+        const auto typeProfile = profile->getTypeProfile(blockContext.pc);
+        //见过null的调用点不推测 避免去优化后由解释器抛NPE的慢路径变成常态
+        if (typeProfile == nullptr || typeProfile->nullSeen.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        const auto receiverClass = typeProfile->getMonomorphicClass();
+        if (receiverClass == nullptr || !receiverClass->isInstanceClass()) {
+            return nullptr;
+        }
+        const auto targetMethod =
+                resolveVirtualMethod(CAST_INSTANCE_CLASS(receiverClass), methodName, methodDescriptor);
+        if (targetMethod == nullptr) {
+            return nullptr;
+        }
+
+        //接收者在操作数栈中位于所有参数之下
+        const auto receiver =
+                blockContext.peekValue(getMethodParamSlotSizeFromDescriptor(methodDescriptor, false) - 1);
+        throwNpeIfNull(blockContext, receiver);
+        const auto isOtherClass = irBuilder.CreateICmpNE(getOopClass(receiver), getConstantPtr(receiverClass));
+        deoptimizeIf(blockContext, isOtherClass, LLVM_COMPILER_DEOPT_TYPE_PROFILE);
+        return targetMethod;
+    }
+
     void MethodCompiler::invokeVirtualMethod(BlockContext &blockContext, const u2 index) {
         const auto [className, methodName, methodDescriptor] =
          getConstantStringFromPoolByClassNameType(constantPool, index);
 
         const auto [paramType, returnType] = parseMethodDescriptor(methodDescriptor);
-        const auto paramSlotSize = pushParams(blockContext, paramType, true);
-
         if (isMethodHandleInvoke(className, methodName)) {
+            const auto paramSlotSize = pushParams(blockContext, paramType, true);
             const auto invokeMethod =
                     vm.bootstrapClassLoader
                     ->getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_INVOKE_METHOD_HANDLE)
                     ->getMethod(methodName, METHOD_HANDLE_INVOKE_ORIGIN_DESCRIPTOR, false);
 
             invokeCommon(blockContext, methodName, returnType, getConstantPtr(invokeMethod), paramSlotSize);
+            return;
+        }
+
+        if (const auto intrinsicMethod = findIntrinsicMethod(className, methodName, methodDescriptor);
+            intrinsicMethod != nullptr && invokeIntrinsic(blockContext, *intrinsicMethod)) {
+            return;
+        }
+
+        //去虚化的检查要在pushParams之前 去优化时操作数栈还是指令执行前的状态
+        auto uniqueMethod = devirtualize(blockContext, className, methodName, methodDescriptor);
+        if (uniqueMethod != nullptr) {
+            //直接绑定的调用不再经过分派 和speculateReceiverType一样先检查接收者
+            const auto receiver =
+                    blockContext.peekValue(getMethodParamSlotSizeFromDescriptor(methodDescriptor, false) - 1);
+            throwNpeIfNull(blockContext, receiver);
+        } else {
+            //CHA无法确定时 按profile中唯一的接收者类型推测
+            uniqueMethod = speculateReceiverType(blockContext, methodName, methodDescriptor);
+        }
+        const auto paramSlotSize = pushParams(blockContext, paramType, true);
+        if (uniqueMethod != nullptr) {
+            //只有一个实现 直接绑定被调函数 不再由helper做运行时分派
+            invokeCommon(blockContext, methodName, returnType, getConstantPtr(uniqueMethod), paramSlotSize);
         } else {
             invokeCommon(blockContext, methodName, returnType, getZeroValue(SlotTypeEnum::REF), index);
         }
+    }
+
+    Method *MethodCompiler::findIntrinsicMethod(
+        const cview className,
+        const cview methodName,
+        const cview methodDescriptor
+    ) const {
+        //虚方法只有在不可能被覆盖时(final方法或final类)才能按内建实现处理
+        const auto receiverClass = klass.classLoader.findLoadedClass(className);
+        if (receiverClass == nullptr || !receiverClass->isInstanceClass()) {
+            return nullptr;
+        }
+        const auto targetMethod =
+                CAST_INSTANCE_CLASS(receiverClass)->getMethod(cformat("{}{}", methodName, methodDescriptor), false);
+        if (targetMethod == nullptr || targetMethod->intrinsic == IntrinsicEnum::NONE) {
+            return nullptr;
+        }
+        const auto isFinalClass = (targetMethod->klass.getAccessFlags() & CAST_U2(AccessFlagEnum::ACC_FINAL)) != 0;
+        return targetMethod->isFinal() || isFinalClass ? targetMethod : nullptr;
+    }
+
+    bool MethodCompiler::invokeIntrinsic(BlockContext &blockContext, const Method &targetMethod) {
+        //数值计算直接生成LLVM intrinsic 其他的调用llvm_compile_intrinsic 不创建frame
+        const auto intrinsic = targetMethod.intrinsic;
+        const auto nullValue = getZeroValue(SlotTypeEnum::REF);
+        const auto intrinsicType = static_cast<u1>(intrinsic);
+        switch (intrinsic) {
+            case IntrinsicEnum::MATH_MIN_I:
+            case IntrinsicEnum::MATH_MAX_I:
+            case IntrinsicEnum::MATH_MIN_J:
+            case IntrinsicEnum::MATH_MAX_J: {
+                const auto isLong = intrinsic == IntrinsicEnum::MATH_MIN_J || intrinsic == IntrinsicEnum::MATH_MAX_J;
+                const auto slotType = isLong ? SlotTypeEnum::I8 : SlotTypeEnum::I4;
+                const auto val2 = blockContext.popValue(slotType);
+                const auto val1 = blockContext.popValue(slotType);
+                const auto isMin = intrinsic == IntrinsicEnum::MATH_MIN_I || intrinsic == IntrinsicEnum::MATH_MIN_J;
+                const auto result = irBuilder.CreateBinaryIntrinsic(isMin ? llvm::Intrinsic::smin : llvm::Intrinsic::smax, val1, val2);
+                blockContext.pushValue(result, slotType);
+                return true;
+            }
+
+            case IntrinsicEnum::MATH_ABS_I:
+            case IntrinsicEnum::MATH_ABS_J: {
+                const auto slotType = intrinsic == IntrinsicEnum::MATH_ABS_J ? SlotTypeEnum::I8 : SlotTypeEnum::I4;
+                const auto val = blockContext.popValue(slotType);
+                //abs(MIN_VALUE)返回MIN_VALUE 不能标记为poison
+                const auto result = irBuilder.CreateBinaryIntrinsic(llvm::Intrinsic::abs, val, irBuilder.getFalse());
+                blockContext.pushValue(result, slotType);
+                return true;
+            }
+
+            case IntrinsicEnum::MATH_ABS_F:
+            case IntrinsicEnum::MATH_ABS_D:
+            case IntrinsicEnum::MATH_SQRT: {
+                const auto slotType = intrinsic == IntrinsicEnum::MATH_ABS_F ? SlotTypeEnum::F4 : SlotTypeEnum::F8;
+                const auto val = blockContext.popValue(slotType);
+                const auto id = intrinsic == IntrinsicEnum::MATH_SQRT ? llvm::Intrinsic::sqrt : llvm::Intrinsic::fabs;
+                blockContext.pushValue(irBuilder.CreateUnaryIntrinsic(id, val), slotType);
+                return true;
+            }
+
+            case IntrinsicEnum::INTEGER_BIT_COUNT: {
+                const auto val = blockContext.popValue();
+                blockContext.pushValue(irBuilder.CreateUnaryIntrinsic(llvm::Intrinsic::ctpop, val));
+                return true;
+            }
+
+            case IntrinsicEnum::INTEGER_NUMBER_OF_LEADING_ZEROS: {
+                const auto val = blockContext.popValue();
+                //numberOfLeadingZeros(0) == 32
+                blockContext.pushValue(irBuilder.CreateBinaryIntrinsic(llvm::Intrinsic::ctlz, val, irBuilder.getFalse()));
+                return true;
+            }
 
+            case IntrinsicEnum::STRING_EQUALS: {
+                const auto other = blockContext.popValue();
+                const auto str = blockContext.popValue();
+                throwNpeIfNull(blockContext, str);
+                const auto result =
+                        helpFunction->createCallIntrinsic(irBuilder, getFramePtr(), str, other, irBuilder.getInt64(0), irBuilder.getInt32(0), intrinsicType);
+                blockContext.pushValue(irBuilder.CreateTrunc(result, irBuilder.getInt32Ty()));
+                return true;
+            }
+
+            case IntrinsicEnum::STRING_HASH_CODE: {
+                const auto str = blockContext.popValue();
+                throwNpeIfNull(blockContext, str);
+                const auto result =
+                        helpFunction->createCallIntrinsic(irBuilder, getFramePtr(), str, nullValue, irBuilder.getInt64(0), irBuilder.getInt32(0), intrinsicType);
+                blockContext.pushValue(irBuilder.CreateTrunc(result, irBuilder.getInt32Ty()));
+                return true;
+            }
+
+            case IntrinsicEnum::STRING_INDEX_OF: {
+                //indexOf(I)I 或 indexOf(II)I
+                const auto fromIndex = targetMethod.paramSlotSize == 3 ? blockContext.popValue() : irBuilder.getInt32(0);
+                const auto ch = blockContext.popValue();
+                const auto str = blockContext.popValue();
+                throwNpeIfNull(blockContext, str);
+                const auto result =
+                        helpFunction->createCallIntrinsic(
+                            irBuilder,
+                            getFramePtr(),
+                            str,
+                            nullValue,
+                            irBuilder.CreateSExt(ch, irBuilder.getInt64Ty()),
+                            fromIndex,
+                            intrinsicType
+                        );
+                blockContext.pushValue(irBuilder.CreateTrunc(result, irBuilder.getInt32Ty()));
+                return true;
+            }
+
+            case IntrinsicEnum::ARRAYS_EQUALS: {
+                const auto array2 = blockContext.popValue();
+                const auto array1 = blockContext.popValue();
+                const auto result =
+                        helpFunction->createCallIntrinsic(irBuilder, getFramePtr(), array1, array2, irBuilder.getInt64(0), irBuilder.getInt32(0), intrinsicType);
+                blockContext.pushValue(irBuilder.CreateTrunc(result, irBuilder.getInt32Ty()));
+                return true;
+            }
+
+            case IntrinsicEnum::ARRAYS_FILL: {
+                //按Slot的内存布局传值 float写在低32位
+                const auto slotType = targetMethod.paramSlotType[1];
+                const auto value = blockContext.popValue(slotType);
+                const auto array = blockContext.popValue();
+                throwNpeIfNull(blockContext, array);
+                llvm::Value *slotValue{nullptr};
+                switch (slotType) {
+                    case SlotTypeEnum::I4:
+                        slotValue = irBuilder.CreateSExt(value, irBuilder.getInt64Ty());
+                        break;
+                    case SlotTypeEnum::F4:
+                        slotValue = irBuilder.CreateZExt(irBuilder.CreateBitCast(value, irBuilder.getInt32Ty()), irBuilder.getInt64Ty());
+                        break;
+                    case SlotTypeEnum::F8:
+                        slotValue = irBuilder.CreateBitCast(value, irBuilder.getInt64Ty());
+                        break;
+                    default:
+                        slotValue = value;
+                        break;
+                }
+                helpFunction->createCallIntrinsic(irBuilder, getFramePtr(), array, nullValue, slotValue, irBuilder.getInt32(0), intrinsicType);
+                return true;
+            }
+
+            case IntrinsicEnum::OBJECT_GET_CLASS: {
+                const auto obj = blockContext.popValue();
+                throwNpeIfNull(blockContext, obj);
+                const auto result =
+                        helpFunction->createCallIntrinsic(irBuilder, getFramePtr(), obj, nullValue, irBuilder.getInt64(0), irBuilder.getInt32(0), intrinsicType);
+                blockContext.pushValue(irBuilder.CreateIntToPtr(result, voidPtrType));
+                return true;
+            }
+
+            case IntrinsicEnum::CLASS_IS_INSTANCE: {
+                const auto obj = blockContext.popValue();
+                const auto mirror = blockContext.popValue();
+                throwNpeIfNull(blockContext, mirror);
+                const auto result =
+                        helpFunction->createCallIntrinsic(irBuilder, getFramePtr(), mirror, obj, irBuilder.getInt64(0), irBuilder.getInt32(0), intrinsicType);
+                blockContext.pushValue(irBuilder.CreateTrunc(result, irBuilder.getInt32Ty()));
+                return true;
+            }
+
+            default:
+                return false;
+        }
     }
 
     void MethodCompiler::invokeDynamic(BlockContext &blockContext, const u2 index) {
@@ -916,7 +1294,8 @@ namespace RexVM {
                     hasExceptionPtr
                 );
 
-        throwNpeIfNull(blockContext, callSiteObj);
+        //callSite为null时helper中已经执行过引导方法 不能去优化重新执行
+        throwIfZero(blockContext, callSiteObj, SlotTypeEnum::REF);
         blockContext.pushValue(callSiteObj);
     }
 
@@ -944,21 +1323,36 @@ namespace RexVM {
         blockContext.pushValue(newObject);
     }
 
+    void MethodCompiler::newOpCodeFast(BlockContext &blockContext, Class *newClass, llvm::Value *length) {
+        const auto newObject =
+                helpFunction->createCallNewFast(irBuilder, getFramePtr(), getConstantPtr(newClass), length);
+        blockContext.pushValue(newObject);
+    }
+
     void MethodCompiler::newObject(BlockContext &blockContext, const u2 index) {
         const auto className = getConstantStringFromPoolByIndexInfo(constantPool, index);
         const auto refClass = klass.classLoader.getClass(className);
+        if (refClass->isInstanceClass()
+            && !CAST_INSTANCE_CLASS(refClass)->notInitialize()
+            && CAST_INSTANCE_CLASS(refClass)->specialClassType == SpecialClassEnum::NONE) {
+            //编译时类已经初始化完成 且是固定大小的普通类 走快速分配
+            newOpCodeFast(blockContext, refClass, irBuilder.getInt32(0));
+            return;
+        }
         newOpCode(blockContext, LLVM_COMPILER_NEW_OBJECT, irBuilder.getInt32(0), getConstantPtr(refClass));
     }
 
     void MethodCompiler::newArray(BlockContext &blockContext, const u1 type, llvm::Value *length) {
-        newOpCode(blockContext, type, length, getZeroValue(SlotTypeEnum::REF));
+        //基本类型数组类在编译时解析 运行时不需要再按类名查找
+        const auto arrayClass = vm.bootstrapClassLoader->getTypeArrayClass(static_cast<BasicType>(type));
+        newOpCodeFast(blockContext, arrayClass, length);
     }
 
     void MethodCompiler::newObjectArray(BlockContext &blockContext, const u2 index, llvm::Value *length) {
         const auto className = getConstantStringFromPoolByIndexInfo(constantPool, index);
         const auto refClass = klass.classLoader.getClass(className);
         const auto arrayClass = klass.classLoader.getObjectArrayClass(*refClass);
-        newOpCode(blockContext, LLVM_COMPILER_NEW_OBJECT_ARRAY, length, getConstantPtr(arrayClass));
+        newOpCodeFast(blockContext, arrayClass, length);
     }
 
     void MethodCompiler::newMultiArray(BlockContext &blockContext, const u2 index, const u1 dimension, llvm::Value *arrayDim) {
@@ -976,6 +1370,18 @@ namespace RexVM {
         irBuilder.CreateCondBr(valIsNull, endBB, isNotNull);
 
         changeBB(blockContext, isNotNull);
+        const auto typeProfile = profile != nullptr ? profile->getTypeProfile(blockContext.pc) : nullptr;
+        if (typeProfile != nullptr) {
+            //profile中只出现过一个类型且该类型通过检查 先比较类指针 命中时不调用helper
+            if (const auto profiledClass = typeProfile->getMonomorphicClass();
+                profiledClass != nullptr && checkClass->isAssignableFrom(profiledClass)) {
+                const auto slowPathBB = BasicBlock::Create(ctx);
+                const auto isProfiledClass = irBuilder.CreateICmpEQ(getOopClass(ref), getConstantPtr(profiledClass));
+                irBuilder.CreateCondBr(isProfiledClass, endBB, slowPathBB, MDBuilder(ctx).createBranchWeights(1 << 20, 1));
+                changeBB(blockContext, slowPathBB);
+            }
+        }
+
         const auto checkRet =
                 helpFunction->createCallMisc(
                     irBuilder,
@@ -985,8 +1391,17 @@ namespace RexVM {
                     LLVM_COMPILER_MISC_CHECK_INSTANCE_OF
                 );
 
-        const auto notInstanceOfBB = BasicBlock::Create(ctx);
         const auto cmpNotInstanceOf = irBuilder.CreateICmpEQ(checkRet, getZeroValue(SlotTypeEnum::I4));
+        //解释器中失败过的checkcast不推测
+        if (canSpeculate(blockContext) && (typeProfile == nullptr || typeProfile->failedCount.get() == 0)) {
+            //推测类型检查通过 失败时去优化 由解释器抛出ClassCastException
+            deoptimizeIf(blockContext, cmpNotInstanceOf, LLVM_COMPILER_DEOPT_CLASS_CHECK);
+            irBuilder.CreateBr(endBB);
+            changeBB(blockContext, endBB);
+            return;
+        }
+
+        const auto notInstanceOfBB = BasicBlock::Create(ctx);
         irBuilder.CreateCondBr(cmpNotInstanceOf, notInstanceOfBB, endBB);
 
         changeBB(blockContext, notInstanceOfBB);
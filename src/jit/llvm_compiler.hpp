@@ -2,12 +2,16 @@
 #define LLVM_COMPILER_HPP
 #include <vector>
 #include <unordered_set>
+#include <unordered_map>
 #include <llvm/IR/IRBuilder.h>
 #include "../basic.hpp"
 #include "../opcode.hpp"
 #include "../cfg.hpp"
 
 namespace RexVM {
+    constexpr auto JIT_CODE_CACHE_METHOD_NAME = "rex_compiled_method";
+    constexpr auto JIT_CONSTANT_SYMBOL_PREFIX = "rex_ref_";
+
     struct VM;
     struct ConstantInfo;
     struct InstanceClass;
@@ -16,6 +20,8 @@ namespace RexVM {
     struct LLVMHelpFunction;
     struct BlockContext;
     struct Class;
+    struct CompiledMethodDependency;
+    struct MethodProfile;
 
     struct MethodCompiler {
         explicit MethodCompiler(
@@ -39,7 +45,13 @@ namespace RexVM {
         bool useLVTOptimize; //使用block的本地变量表(不写frame的栈内存 把llvm::Value保存在context的数组中)
         bool checkStackError; //是否做字节码执行后的栈数量检查 如果开启则函数编译结束后如果栈的元素数量不为0会报错
         bool useException;
+        bool useSpeculate; //做推测优化 推测失败时去优化回解释器
+        bool useRelocatableConstant; //运行时指针不直接写进代码 改为外部符号引用 编译结果可以写入磁盘缓存
+        std::vector<void *> constantSymbols; //外部符号的地址 下标即符号名后缀
+        std::unordered_map<void *, llvm::GlobalVariable *> constantSymbolMap;
         std::unordered_set<Class *> initClasses;
+        CompiledMethodDependency *dependency{}; //CHA依赖 没有做去虚化时为空
+        MethodProfile *profile{}; //解释器收集的分支和类型profile 方法没有变热过时为空
 
         MethodCFG cfg;
         std::vector<std::unique_ptr<BlockContext>> cfgBlocks;
@@ -96,6 +108,12 @@ namespace RexVM {
 
         void throwNpeIfNull(BlockContext &blockContext, llvm::Value *val);
 
+        [[nodiscard]] bool canSpeculate(const BlockContext &blockContext) const;
+
+        void deoptimize(BlockContext &blockContext, u1 reason);
+
+        void deoptimizeIf(BlockContext &blockContext, llvm::Value *cond, u1 reason);
+
         void throwException(BlockContext &blockContext, llvm::Value *ex);
 
         void ldc(BlockContext &blockContext, u2 index);
@@ -104,8 +122,14 @@ namespace RexVM {
 
         void store(BlockContext &blockContext, u4 index, SlotTypeEnum slotType);
 
+        llvm::Value *getOopComClass(llvm::Value *oop);
+
+        llvm::Value *getOopClass(llvm::Value *oop);
+
         void arrayLength(BlockContext &blockContext, llvm::Value *arrayRef);
 
+        void markInvariantLoad(llvm::LoadInst *load) const;
+
         void arrayLoad(BlockContext &blockContext, llvm::Value *arrayRef, llvm::Value *index, uint8_t type);
 
         void arrayStore(BlockContext &blockContext, llvm::Value *arrayRef, llvm::Value *index, llvm::Value *value, uint8_t type);
@@ -116,6 +140,8 @@ namespace RexVM {
 
         static u4 offsetToPC(const BlockContext &blockContext, i4 offset);
 
+        [[nodiscard]] llvm::MDNode *getBranchWeights(u4 pc) const;
+
         void ifOp(const BlockContext &blockContext, i4 offset, llvm::Value *val1, llvm::Value *val2, OpCodeEnum op);
 
         void jumpToPC(u4 pc);
@@ -142,14 +168,24 @@ namespace RexVM {
 
         void invokeStaticMethod(BlockContext &blockContext, u2 index, bool isStatic);
 
+        Method *devirtualize(BlockContext &blockContext, cview className, cview methodName, cview methodDescriptor);
+
+        Method *speculateReceiverType(BlockContext &blockContext, cview methodName, cview methodDescriptor);
+
         void invokeVirtualMethod(BlockContext &blockContext, u2 index);
 
+        [[nodiscard]] Method *findIntrinsicMethod(cview className, cview methodName, cview methodDescriptor) const;
+
+        bool invokeIntrinsic(BlockContext &blockContext, const Method &targetMethod);
+
         void invokeDynamic(BlockContext &blockContext, u2 index);
 
         void processInvokeReturn(BlockContext &blockContext, cview returnType);
 
         void newOpCode(BlockContext &blockContext, uint8_t type, llvm::Value *length, llvm::Value *klass);
 
+        void newOpCodeFast(BlockContext &blockContext, Class *newClass, llvm::Value *length);
+
         void newObject(BlockContext &blockContext, u2 index);
 
         void newArray(BlockContext &blockContext, u1 type, llvm::Value *length);
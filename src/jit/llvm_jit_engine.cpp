@@ -1,11 +1,24 @@
 #include "llvm_jit_engine.hpp"
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/Error.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/ExecutionEngine/JITEventListener.h>
 #include "llvm_compiler.hpp"
 #include "jit_help_function.hpp"
 #include "../class_member.hpp"
 #include "../class.hpp"
 #include "../vm.hpp"
+#include "../class_loader.hpp"
+#include "../utils/binary.hpp"
+#include "../utils/file_utils.hpp"
+#include "llvm_jit_object_cache.hpp"
+#include "llvm_optimizer.hpp"
+#include "llvm_jit_perf_map.hpp"
 
 #define DEFINE_SYMBOL(hf_name) symbol_map[mangle(#hf_name)] = ExecutorSymbolDef(ExecutorAddr::fromPtr(&hf_name), JITSymbolFlags());
 
@@ -23,10 +36,76 @@ namespace RexVM {
         const auto compileOptimizeLevel = static_cast<CodeGenOptLevel>(vm.params.jitCompileOptimizeLevel);
         jitTarget->setCodeGenOptLevel(compileOptimizeLevel);
 
-        jit = cantFail(
-            LLJITBuilder()
-            .setJITTargetMachineBuilder(std::move(*jitTarget))
-            .create()
+        auto jitBuilder = LLJITBuilder();
+        if (const auto &cacheDir = vm.params.jitCodeCacheDir; !cacheDir.empty()) {
+            //缓存的目标文件会在其他进程中重新链接 必须是位置无关的
+            jitTarget->setRelocationModel(Reloc::PIC_);
+            //VM可执行文件变化(重新编译)后旧的目标文件作废 与类归档 堆快照使用同一个stamp
+            codeCacheSeed = fnv1aHash(LLVM_VERSION_STRING, getVMBuildStamp());
+            codeCacheSeed = fnv1aHash(jitTarget->getCPU(), codeCacheSeed);
+            codeCacheSeed = fnv1aHash(jitTarget->getFeatures().getString(), codeCacheSeed);
+            codeCacheSeed = fnv1aHash(
+                cformat(
+                    "{}_{}_{}_{}_{}_{}_{}",
+                    vm.params.jitCompileOptimizeLevel,
+                    vm.params.jitLVTOptimize,
+                    vm.params.jitCheckStack,
+                    vm.params.jitSupportException,
+                    vm.params.jitSpeculate,
+                    vm.params.jitVectorize,
+                    vm.params.intrinsicEnable
+                ),
+                codeCacheSeed
+            );
+            objectCache = std::make_unique<JITObjectCache>(cacheDir);
+            jitBuilder.setCompileFunctionCreator(
+                [cache = objectCache.get()](JITTargetMachineBuilder jtmb)
+                    -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+                    auto tm = jtmb.createTargetMachine();
+                    if (!tm) {
+                        return tm.takeError();
+                    }
+                    return std::make_unique<TMOwningSimpleCompiler>(std::move(*tm), cache);
+                }
+            );
+        }
+        if (vm.params.jitPerfMap || vm.params.jitDump) {
+            //perf需要的符号信息通过RuntimeDyld的JITEventListener获取
+            //perf map和jitdump都由JITPerfMap按请求编译的方法写入 不使用LLVM的PerfJITEventListener
+            //LLVM的监听器用目标文件中的符号名 开启代码缓存时所有方法都是同一个名字
+            perfMap = std::make_unique<JITPerfMap>(vm.params.jitPerfMap, vm.params.jitDump);
+            jitBuilder.setObjectLinkingLayerCreator(
+                [perfMap = perfMap.get()](ExecutionSession &executionSession, const Triple &)
+                    -> Expected<std::unique_ptr<ObjectLayer>> {
+                    auto objectLayer = std::make_unique<RTDyldObjectLinkingLayer>(
+                        executionSession,
+                        [] { return std::make_unique<SectionMemoryManager>(); }
+                    );
+                    objectLayer->registerJITEventListener(*perfMap);
+                    return objectLayer;
+                }
+            );
+        }
+
+        //detectHost已经带上了宿主机的CPU和特性 IR优化和代码生成使用同一份配置
+        optimizer = std::make_unique<LLVMOptimizer>(
+            cantFail(jitTarget->createTargetMachine()),
+            vm.params.jitCompileOptimizeLevel,
+            vm.params.jitVectorize
+        );
+        jitBuilder.setJITTargetMachineBuilder(std::move(*jitTarget));
+        jit = cantFail(jitBuilder.create());
+        jit->getIRTransformLayer().setTransform(
+            [this](ThreadSafeModule threadSafeModule, const MaterializationResponsibility &) -> Expected<ThreadSafeModule> {
+                threadSafeModule.withModuleDo([this](Module &module) {
+                    //磁盘缓存命中时会直接使用缓存的目标文件 不需要再优化
+                    if (objectCache != nullptr && objectCache->containsObject(module.getModuleIdentifier())) {
+                        return;
+                    }
+                    optimizer->optimize(module);
+                });
+                return std::move(threadSafeModule);
+            }
         );
 
         threadSafeContext = std::make_unique<ThreadSafeContext>(std::make_unique<LLVMContext>());
@@ -45,15 +124,51 @@ namespace RexVM {
         DEFINE_SYMBOL(llvm_compile_return_common)
         DEFINE_SYMBOL(llvm_compile_invoke_method_fixed)
         DEFINE_SYMBOL(llvm_compile_new_object)
+        DEFINE_SYMBOL(llvm_compile_new_object_fast)
         DEFINE_SYMBOL(llvm_compile_throw_exception)
         DEFINE_SYMBOL(llvm_compile_match_catch)
         DEFINE_SYMBOL(llvm_compile_misc)
+        DEFINE_SYMBOL(llvm_compile_deoptimize)
+        DEFINE_SYMBOL(llvm_compile_intrinsic)
 
         cantFail(jd.define(absoluteSymbols(symbol_map)));
     }
 
 
+    //分支权重来自解释器的profile 每次运行都不同 计入key的话其他进程永远命中不了 缓存只会越来越大
+    //权重只影响代码布局 不影响正确性 计算key时先去掉 打印完再放回去
+    cstring LLVM_JIT_Engine::getIRTextWithoutProfile(Function &function) {
+        std::vector<std::pair<Instruction *, MDNode *>> profMetadata;
+        for (auto &basicBlock : function) {
+            for (auto &inst : basicBlock) {
+                if (const auto metadata = inst.getMetadata(LLVMContext::MD_prof); metadata != nullptr) {
+                    profMetadata.emplace_back(&inst, metadata);
+                    inst.setMetadata(LLVMContext::MD_prof, nullptr);
+                }
+            }
+        }
+        cstring irText;
+        raw_string_ostream irStream(irText);
+        function.print(irStream);
+        irStream.flush();
+        for (const auto &[inst, metadata] : profMetadata) {
+            inst->setMetadata(LLVMContext::MD_prof, metadata);
+        }
+        return irText;
+    }
+
+    u8 LLVM_JIT_Engine::getCodeCacheKey(const Method &method) const {
+        auto key = fnv1aHash(method.getName(), codeCacheSeed);
+        key = fnv1aHash(method.getDescriptor(), key);
+        return key ^ method.klass.classFileHash;
+    }
+
+    bool LLVM_JIT_Engine::hasCachedMethod(const Method &method) const {
+        return objectCache != nullptr && objectCache->containsMethod(getCodeCacheKey(method));
+    }
+
     CompiledMethodHandler LLVM_JIT_Engine::compileMethod(Method &method) {
+        method.initCodeBody();
         if (!vm.params.jitSupportException && !method.exceptionCatches.empty()) {
             ++failedMethodCnt;
             method.canCompile = false;
@@ -61,8 +176,14 @@ namespace RexVM {
         }
         const auto ctx = threadSafeContext->getContext();
         const auto currentMethodCnt = methodCnt.fetch_add(1);
+        //使用缓存时 函数名固定 IR的文本才能在不同进程间保持一致
+        //否则使用方法的全限定名 jitdump和调试器中可以直接看到是哪个方法
+        const auto useCodeCache = objectCache != nullptr;
         const auto moduleName = cformat("module_{}", currentMethodCnt);
-        const auto compiledMethodName = cformat("{}_{}", method.getName(), currentMethodCnt);
+        const auto compiledMethodName =
+            useCodeCache
+                ? cstring(JIT_CODE_CACHE_METHOD_NAME)
+                : cformat("{}_{}", JITPerfMap::getMethodName(method), currentMethodCnt);
         auto module = std::make_unique<Module>(moduleName, *ctx);
 
         MethodCompiler methodCompiler(vm, method, *module, compiledMethodName);
@@ -73,19 +194,58 @@ namespace RexVM {
         }
         methodCompiler.verify();
 
+        auto jd = &jit->getMainJITDylib();
+        if (useCodeCache) {
+            //每个方法一个JITDylib 固定的函数名和常量符号名不会互相冲突
+            jd = &cantFail(jit->createJITDylib(cformat("method_{}", currentMethodCnt)));
+            jd->addToLinkOrder(jit->getMainJITDylib(), JITDylibLookupFlags::MatchAllSymbols);
+            defineConstantSymbols(*jd, methodCompiler.constantSymbols);
+
+            //ModuleIdentifier即缓存key IR不同(比如去优化后重新编译)时会生成新的缓存
+            const auto irText = getIRTextWithoutProfile(*methodCompiler.function);
+            module->setModuleIdentifier(JITObjectCache::getModuleIdentifier(getCodeCacheKey(method), fnv1aHash(irText)));
+        }
+
         auto TSM = ThreadSafeModule(std::move(module), *threadSafeContext);
-        cantFail(jit->addIRModule(std::move(TSM)));
+        cantFail(jit->addIRModule(*jd, std::move(TSM)));
 
-        const auto sym = jit->lookup(compiledMethodName);
+        const auto sym = jit->lookup(*jd, compiledMethodName);
         const auto ptr = sym->toPtr<CompiledMethodHandler>();
-        method.compiledMethodHandler = ptr;
+        if (perfMap != nullptr) {
+            perfMap->writeMethod(method, std::bit_cast<void *>(ptr));
+        }
+        if (const auto dependency = methodCompiler.dependency; dependency != nullptr) {
+            //有CHA依赖 安装时需要确认编译期间依赖没有失效
+            if (!method.klass.classLoader.installCompiledMethod(*dependency, ptr)) {
+                ++failedMethodCnt;
+                return nullptr;
+            }
+        } else {
+            method.compiledMethodHandler.store(ptr, std::memory_order_release);
+        }
         ++successMethodCnt;
         return ptr;
     }
 
+    void LLVM_JIT_Engine::defineConstantSymbols(JITDylib &jd, const std::vector<void *> &constantSymbols) const {
+        //缓存的目标文件中运行时指针都是外部符号 链接时绑定到当前进程中的地址
+        auto mangle = MangleAndInterner(jd.getExecutionSession(), jit->getDataLayout());
+        SymbolMap symbol_map;
+        for (size_t i = 0; i < constantSymbols.size(); ++i) {
+            symbol_map[mangle(cformat("{}{}", JIT_CONSTANT_SYMBOL_PREFIX, i))] =
+                ExecutorSymbolDef(ExecutorAddr::fromPtr(constantSymbols[i]), JITSymbolFlags());
+        }
+        if (!symbol_map.empty()) {
+            cantFail(jd.define(absoluteSymbols(symbol_map)));
+        }
+    }
+
     LLVM_JIT_Engine::~LLVM_JIT_Engine() {
 #ifdef DEBUG
         cprintln("jit compile success: {}, failed: {}", successMethodCnt.load(), failedMethodCnt.load());
+        if (objectCache != nullptr) {
+            cprintln("jit code cache hit: {}", objectCache->hitCnt.load());
+        }
 #endif
     }
 
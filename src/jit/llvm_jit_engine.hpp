@@ -9,6 +9,9 @@ namespace RexVM {
 
     struct Method;
     struct VM;
+    struct JITObjectCache;
+    struct LLVMOptimizer;
+    struct JITPerfMap;
 
     struct LLVM_JIT_Engine {
         VM &vm;
@@ -21,9 +24,21 @@ namespace RexVM {
 
         std::unique_ptr<llvm::orc::LLJIT> jit;
         std::unique_ptr<llvm::orc::ThreadSafeContext> threadSafeContext;
+        std::unique_ptr<JITObjectCache> objectCache; //JIT代码磁盘缓存 未配置缓存目录时为空
+        u8 codeCacheSeed{}; //VM版本 LLVM版本 JIT参数 CPU特性 任意一个变化缓存都失效
+        std::unique_ptr<LLVMOptimizer> optimizer;
+        std::unique_ptr<JITPerfMap> perfMap; //jitPerfMap和jitDump都没有开启时为空
 
         void registerHelpFunction() const;
 
+        void defineConstantSymbols(llvm::orc::JITDylib &jd, const std::vector<void *> &constantSymbols) const;
+
+        [[nodiscard]] u8 getCodeCacheKey(const Method &method) const;
+
+        [[nodiscard]] static cstring getIRTextWithoutProfile(llvm::Function &function);
+
+        [[nodiscard]] bool hasCachedMethod(const Method &method) const;
+
         CompiledMethodHandler compileMethod(Method &method);
 
 
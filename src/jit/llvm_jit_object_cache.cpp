@@ -0,0 +1,82 @@
+#include "llvm_jit_object_cache.hpp"
+#include <filesystem>
+#include <charconv>
+#include <mutex>
+#include <llvm/IR/Module.h>
+#include "../utils/file_utils.hpp"
+
+namespace RexVM {
+    using namespace llvm;
+
+    constexpr size_t METHOD_KEY_HEX_LENGTH = 16;
+    constexpr auto OBJECT_FILE_SUFFIX = ".o";
+
+    JITObjectCache::JITObjectCache(const cview cacheDir) : cacheDir(cacheDir) {
+        std::error_code ec;
+        std::filesystem::create_directories(this->cacheDir, ec);
+        if (ec) {
+            cprintlnErr("jit code cache dir error: {} {}", cacheDir, ec.message());
+            return;
+        }
+
+        //启动时扫描一次目录 记录有哪些方法已经有缓存
+        for (const auto &entry : std::filesystem::directory_iterator(this->cacheDir, ec)) {
+            const auto fileName = entry.path().filename().string();
+            if (fileName.size() <= METHOD_KEY_HEX_LENGTH || !fileName.ends_with(OBJECT_FILE_SUFFIX)) {
+                continue;
+            }
+            u8 methodKey{};
+            const auto keyBegin = fileName.data();
+            if (const auto [ptr, errc] = std::from_chars(keyBegin, keyBegin + METHOD_KEY_HEX_LENGTH, methodKey, 16);
+                errc == std::errc()) {
+                methodKeys.emplace(methodKey);
+            }
+        }
+    }
+
+    cstring JITObjectCache::getModuleIdentifier(const u8 methodKey, const u8 irHash) {
+        return cformat("{:016x}_{:016x}", methodKey, irHash);
+    }
+
+    cstring JITObjectCache::getObjectPath(const cview moduleIdentifier) const {
+        return cformat("{}/{}{}", cacheDir, moduleIdentifier, OBJECT_FILE_SUFFIX);
+    }
+
+    void JITObjectCache::notifyObjectCompiled(const Module *module, const MemoryBufferRef object) {
+        const auto &moduleIdentifier = module->getModuleIdentifier();
+        const auto objectPath = getObjectPath(moduleIdentifier);
+        //多个VM共享缓存目录 写不完整的目标文件不能出现在目录中
+        const auto written = writeFileAtomically(objectPath, [&](std::ostream &os) {
+            os.write(object.getBufferStart(), CAST_I8(object.getBufferSize()));
+        });
+        if (!written) {
+            return;
+        }
+
+        u8 methodKey{};
+        std::from_chars(moduleIdentifier.data(), moduleIdentifier.data() + METHOD_KEY_HEX_LENGTH, methodKey, 16);
+        std::lock_guard guard(methodKeysLock);
+        methodKeys.emplace(methodKey);
+    }
+
+    std::unique_ptr<MemoryBuffer> JITObjectCache::getObject(const Module *module) {
+        const auto objectPath = getObjectPath(module->getModuleIdentifier());
+        auto buffer = MemoryBuffer::getFile(objectPath, false, false);
+        if (!buffer) {
+            return nullptr;
+        }
+        ++hitCnt;
+        return std::move(*buffer);
+    }
+
+    bool JITObjectCache::containsObject(const cview moduleIdentifier) const {
+        std::error_code ec;
+        return std::filesystem::exists(getObjectPath(moduleIdentifier), ec);
+    }
+
+    bool JITObjectCache::containsMethod(const u8 methodKey) {
+        std::lock_guard guard(methodKeysLock);
+        return methodKeys.contains(methodKey);
+    }
+
+}
@@ -0,0 +1,38 @@
+#ifndef LLVM_JIT_OBJECT_CACHE_HPP
+#define LLVM_JIT_OBJECT_CACHE_HPP
+#include "../basic.hpp"
+#include <atomic>
+#include <unordered_set>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "../utils/spin_lock.hpp"
+
+namespace RexVM {
+
+    //JIT代码的磁盘缓存 挂在LLJIT的编译层上
+    //模块的ModuleIdentifier就是缓存key 格式为 {methodKey}_{irHash} 对应文件 {cacheDir}/{key}.o
+    struct JITObjectCache final : llvm::ObjectCache {
+        cstring cacheDir;
+        SpinLock methodKeysLock;
+        std::unordered_set<u8> methodKeys; //已有缓存的methodKey 类加载时据此判断是否命中
+        std::atomic_uint32_t hitCnt{0};
+
+        explicit JITObjectCache(cview cacheDir);
+
+        void notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef object) override;
+
+        std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override;
+
+        [[nodiscard]] bool containsMethod(u8 methodKey);
+
+        [[nodiscard]] bool containsObject(cview moduleIdentifier) const;
+
+        [[nodiscard]] static cstring getModuleIdentifier(u8 methodKey, u8 irHash);
+
+    private:
+        [[nodiscard]] cstring getObjectPath(cview moduleIdentifier) const;
+    };
+
+}
+
+#endif
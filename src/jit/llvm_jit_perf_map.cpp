@@ -0,0 +1,157 @@
+#include "llvm_jit_perf_map.hpp"
+#include <mutex>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#include <llvm/Object/SymbolSize.h>
+#include "../class.hpp"
+#include "../class_member.hpp"
+#include "../utils/class_utils.hpp"
+#include "../os_platform.hpp"
+
+namespace RexVM {
+    using namespace llvm;
+
+#if defined(__x86_64__) || defined(_M_X64)
+    constexpr u4 JIT_DUMP_ELF_MACH = 62; //EM_X86_64
+#else
+    constexpr u4 JIT_DUMP_ELF_MACH = 183; //EM_AARCH64
+#endif
+
+    //perf record -k mono 使用CLOCK_MONOTONIC 记录的时间戳需要一致
+    static u8 getJitDumpTimestamp() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return CAST_U8(ts.tv_sec) * 1000000000 + CAST_U8(ts.tv_nsec);
+    }
+
+    static u4 getJitDumpThreadId() {
+#if defined(__linux__)
+        return CAST_U4(syscall(SYS_gettid));
+#else
+        return CAST_U4(getpid());
+#endif
+    }
+
+    JITPerfMap::JITPerfMap(const bool perfMap, const bool jitDump) {
+        if (perfMap) {
+            const auto path = cformat("/tmp/perf-{}.map", getpid());
+            file = std::fopen(path.c_str(), "w");
+            if (file == nullptr) {
+                cprintlnErr("jit perf map open error: {}", path);
+            }
+        }
+        if (jitDump) {
+            openJitDump();
+        }
+    }
+
+    JITPerfMap::~JITPerfMap() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+        if (dumpMarker != nullptr) {
+            munmap(dumpMarker, dumpMarkerSize);
+        }
+        if (dumpFile != nullptr) {
+            std::fclose(dumpFile);
+        }
+    }
+
+    void JITPerfMap::openJitDump() {
+        const auto path = cformat("/tmp/jit-{}.dump", getpid());
+        dumpFile = std::fopen(path.c_str(), "w+");
+        if (dumpFile == nullptr) {
+            cprintlnErr("jit dump open error: {}", path);
+            return;
+        }
+        //perf record只记录mmap事件 映射一页可执行的jitdump文件 perf inject据此找到文件
+        dumpMarkerSize = getSystemPageSize();
+        dumpMarker = mmap(nullptr, dumpMarkerSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, fileno(dumpFile), 0);
+        if (dumpMarker == MAP_FAILED) {
+            dumpMarker = nullptr;
+            cprintlnErr("jit dump mmap error: {}", path);
+        }
+
+        JitDumpHeader header{};
+        header.magic = JIT_DUMP_MAGIC;
+        header.version = JIT_DUMP_VERSION;
+        header.totalSize = sizeof(JitDumpHeader);
+        header.elfMach = JIT_DUMP_ELF_MACH;
+        header.pid = CAST_U4(getpid());
+        header.timestamp = getJitDumpTimestamp();
+        std::fwrite(&header, sizeof(JitDumpHeader), 1, dumpFile);
+        std::fflush(dumpFile);
+    }
+
+    void JITPerfMap::notifyObjectLoaded(ObjectKey, const object::ObjectFile &object, const RuntimeDyld::LoadedObjectInfo &info) {
+        //debug object中的section地址已经是重定位后的加载地址
+        const auto debugObject = info.getObjectForDebug(object);
+        const auto loadedObject = debugObject.getBinary();
+        if (loadedObject == nullptr) {
+            return;
+        }
+        std::lock_guard guard(symbolLock);
+        for (const auto &[symbol, size] : object::computeSymbolSizes(*loadedObject)) {
+            auto symbolType = symbol.getType();
+            if (!symbolType || *symbolType != object::SymbolRef::ST_Function) {
+                consumeError(symbolType.takeError());
+                continue;
+            }
+            auto address = symbol.getAddress();
+            if (!address) {
+                consumeError(address.takeError());
+                continue;
+            }
+            symbolSizes[*address] = size;
+        }
+    }
+
+    cstring JITPerfMap::getMethodName(const Method &method) {
+        return cformat("{}.{}{}", getJavaClassName(method.klass.getClassName()), method.getName(), method.getDescriptor());
+    }
+
+    void JITPerfMap::writeJitDump(const cview name, const u8 start, const u8 size) {
+        JitDumpCodeLoad record{};
+        record.id = JIT_DUMP_CODE_LOAD;
+        record.totalSize = CAST_U4(sizeof(JitDumpCodeLoad) + name.size() + 1 + size);
+        record.timestamp = getJitDumpTimestamp();
+        record.pid = CAST_U4(getpid());
+        record.tid = getJitDumpThreadId();
+        record.vma = start;
+        record.codeAddress = start;
+        record.codeSize = size;
+        record.codeIndex = codeIndex++;
+        std::fwrite(&record, sizeof(JitDumpCodeLoad), 1, dumpFile);
+        std::fwrite(name.data(), 1, name.size(), dumpFile);
+        std::fputc('\0', dumpFile);
+        std::fwrite(std::bit_cast<const void *>(start), 1, size, dumpFile);
+        std::fflush(dumpFile);
+    }
+
+    void JITPerfMap::writeMethod(const Method &method, const void *address) {
+        const auto start = std::bit_cast<u8>(address);
+        u8 size{0};
+        std::lock_guard guard(symbolLock);
+        if (const auto iter = symbolSizes.find(start); iter != symbolSizes.end()) {
+            size = iter->second;
+            symbolSizes.erase(iter);
+        }
+        const auto name = getMethodName(method);
+        if (file != nullptr) {
+            const auto line = cformat("{:x} {:x} {}\n", start, size, name);
+            //perf随时可能读取 每条记录立即刷到文件
+            std::fwrite(line.data(), 1, line.size(), file);
+            std::fflush(file);
+        }
+        //不知道长度时没有机器码可写
+        if (dumpFile != nullptr && size > 0) {
+            writeJitDump(name, start, size);
+        }
+    }
+
+}
@@ -0,0 +1,71 @@
+#ifndef LLVM_JIT_PERF_MAP_HPP
+#define LLVM_JIT_PERF_MAP_HPP
+#include "../basic.hpp"
+#include <cstdio>
+#include <unordered_map>
+#include <llvm/ExecutionEngine/JITEventListener.h>
+#include "../utils/spin_lock.hpp"
+
+namespace RexVM {
+
+    struct Method;
+
+    //jitdump格式 见linux源码 tools/perf/Documentation/jitdump-specification.txt
+    constexpr u4 JIT_DUMP_MAGIC = 0x4A695444;
+    constexpr u4 JIT_DUMP_VERSION = 1;
+    constexpr u4 JIT_DUMP_CODE_LOAD = 0;
+
+    struct JitDumpHeader {
+        u4 magic;
+        u4 version;
+        u4 totalSize;
+        u4 elfMach;
+        u4 pad1;
+        u4 pid;
+        u8 timestamp;
+        u8 flags;
+    };
+
+    //之后跟着'\0'结尾的函数名和机器码
+    struct JitDumpCodeLoad {
+        u4 id;
+        u4 totalSize;
+        u8 timestamp;
+        u4 pid;
+        u4 tid;
+        u8 vma;
+        u8 codeAddress;
+        u8 codeSize;
+        u8 codeIndex;
+    };
+
+    //生成Linux perf使用的 /tmp/perf-<pid>.map 和 /tmp/jit-<pid>.dump
+    //作为RuntimeDyld的JITEventListener 记录加载后每个函数符号的地址和长度
+    //编译完成后由LLVM_JIT_Engine用请求编译的方法的全限定名写入记录
+    //开启代码缓存时目标文件中的函数名是固定的 不能用目标文件中的符号名
+    struct JITPerfMap final : llvm::JITEventListener {
+        SpinLock symbolLock;
+        std::unordered_map<u8, u8> symbolSizes; //函数地址 -> 函数长度
+        FILE *file{nullptr};
+        FILE *dumpFile{nullptr};
+        void *dumpMarker{nullptr}; //perf record通过这个可执行映射找到jitdump文件
+        size_t dumpMarkerSize{0};
+        u8 codeIndex{0};
+
+        explicit JITPerfMap(bool perfMap, bool jitDump);
+        ~JITPerfMap() override;
+
+        void notifyObjectLoaded(ObjectKey key, const llvm::object::ObjectFile &object, const llvm::RuntimeDyld::LoadedObjectInfo &info) override;
+
+        void writeMethod(const Method &method, const void *address);
+
+        [[nodiscard]] static cstring getMethodName(const Method &method);
+
+    private:
+        void openJitDump();
+        void writeJitDump(cview name, u8 start, u8 size);
+    };
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "llvm_optimizer.hpp"
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/PromoteMemToReg.h>
+#include "jit_help_function.hpp"
+
+namespace RexVM {
+    using namespace llvm;
+
+    bool isSafePointCall(const CallInst &call) {
+        const auto callee = call.getCalledFunction();
+        if (callee == nullptr || callee->getName() != "llvm_compile_misc") {
+            return false;
+        }
+        const auto type = dyn_cast<ConstantInt>(call.getArgOperand(call.arg_size() - 1));
+        return type != nullptr && type->getZExtValue() == LLVM_COMPILER_MISC_SAFE_POINT;
+    }
+
+    //只看循环自己的基本块 内层循环的块由内层循环处理
+    bool collectSafePointCalls(const Loop &loop, std::vector<CallInst *> &safePointCalls, size_t &bodySize) {
+        for (const auto basicBlock : loop.blocks()) {
+            bodySize += basicBlock->size();
+            for (auto &inst : *basicBlock) {
+                const auto call = dyn_cast<CallInst>(&inst);
+                if (call == nullptr || isa<IntrinsicInst>(call)) {
+                    continue;
+                }
+                if (!isSafePointCall(*call)) {
+                    return false;
+                }
+                safePointCalls.emplace_back(call);
+            }
+        }
+        return true;
+    }
+
+    //常量次数不超过SAFE_POINT_FREE_MAX_TRIP_COUNT 或者int计数且循环体不大 一次循环的耗时有上限 可以去掉safePoint
+    bool isSafePointFreeLoop(const Loop &loop, ScalarEvolution &scalarEvolution, const size_t bodySize) {
+        const auto tripCount = scalarEvolution.getSmallConstantTripCount(&loop);
+        if (tripCount != 0 && tripCount <= SAFE_POINT_FREE_MAX_TRIP_COUNT) {
+            return true;
+        }
+        //IndVars会把int归纳变量扩展成i64 这里按回边次数的上限判断是否是int计数
+        const auto maxBackedgeTakenCount = dyn_cast<SCEVConstant>(scalarEvolution.getConstantMaxBackedgeTakenCount(&loop));
+        if (maxBackedgeTakenCount == nullptr) {
+            return false;
+        }
+        return maxBackedgeTakenCount->getAPInt().getActiveBits() <= 32 &&
+               bodySize <= SAFE_POINT_FREE_MAX_BODY_SIZE;
+    }
+
+    //把safePoint改成每SAFE_POINT_STRIP_MINE_CHUNK次迭代执行一次
+    //计数器先用alloca表示 全部改完后提升成phi
+    AllocaInst *stripMineSafePoint(Function &function, const std::vector<CallInst *> &safePointCalls) {
+        auto &context = function.getContext();
+        IRBuilder<> builder(&*function.getEntryBlock().getFirstInsertionPt());
+        const auto counter = builder.CreateAlloca(builder.getInt32Ty(), nullptr, "safePointCounter");
+        builder.CreateStore(builder.getInt32(0), counter);
+
+        const auto branchWeights = MDBuilder(context).createBranchWeights(1, SAFE_POINT_STRIP_MINE_CHUNK - 1);
+        for (const auto call : safePointCalls) {
+            builder.SetInsertPoint(call);
+            const auto count = builder.CreateAdd(builder.CreateLoad(builder.getInt32Ty(), counter), builder.getInt32(1));
+            const auto reach = builder.CreateICmpUGE(count, builder.getInt32(SAFE_POINT_STRIP_MINE_CHUNK));
+            builder.CreateStore(builder.CreateSelect(reach, builder.getInt32(0), count), counter);
+            const auto thenTerminator = SplitBlockAndInsertIfThen(reach, call, false, branchWeights);
+            call->moveBefore(thenTerminator);
+        }
+        return counter;
+    }
+
+    PreservedAnalyses CountedLoopSafePointEliminatePass::run(Function &function, FunctionAnalysisManager &analysisManager) {
+        auto &loopInfo = analysisManager.getResult<LoopAnalysis>(function);
+        auto &scalarEvolution = analysisManager.getResult<ScalarEvolutionAnalysis>(function);
+
+        //只处理最内层循环 外层循环回边上的safePoint保留 整个循环嵌套不会一次都不检查
+        std::vector<CallInst *> removeCalls;
+        std::vector<std::vector<CallInst *>> stripMineCalls;
+        for (const auto loop : loopInfo.getLoopsInPreorder()) {
+            if (!loop->isInnermost()) {
+                continue;
+            }
+            std::vector<CallInst *> safePointCalls;
+            size_t bodySize = 0;
+            if (!collectSafePointCalls(*loop, safePointCalls, bodySize) || safePointCalls.empty()) {
+                continue;
+            }
+            if (isSafePointFreeLoop(*loop, scalarEvolution, bodySize)) {
+                removeCalls.insert(removeCalls.end(), safePointCalls.begin(), safePointCalls.end());
+            } else {
+                stripMineCalls.emplace_back(std::move(safePointCalls));
+            }
+        }
+
+        if (removeCalls.empty() && stripMineCalls.empty()) {
+            return PreservedAnalyses::all();
+        }
+        for (const auto call : removeCalls) {
+            call->eraseFromParent();
+        }
+        if (stripMineCalls.empty()) {
+            PreservedAnalyses preservedAnalyses;
+            preservedAnalyses.preserveSet<CFGAnalyses>();
+            return preservedAnalyses;
+        }
+
+        std::vector<AllocaInst *> counters;
+        for (const auto &safePointCalls : stripMineCalls) {
+            counters.emplace_back(stripMineSafePoint(function, safePointCalls));
+        }
+        DominatorTree dominatorTree(function);
+        PromoteMemToReg(counters, dominatorTree);
+        return PreservedAnalyses::none();
+    }
+
+    OptimizationLevel getOptimizationLevel(const size_t optimizeLevel) {
+        switch (optimizeLevel) {
+            case 0:
+                return OptimizationLevel::O0;
+            case 1:
+                return OptimizationLevel::O1;
+            case 2:
+                return OptimizationLevel::O2;
+            default:
+                return OptimizationLevel::O3;
+        }
+    }
+
+    LLVMOptimizer::LLVMOptimizer(std::unique_ptr<TargetMachine> targetMachine, const size_t optimizeLevel, const bool vectorize)
+        : targetMachine(std::move(targetMachine)),
+          optimizationLevel(getOptimizationLevel(optimizeLevel)),
+          vectorize(vectorize) {
+    }
+
+    void LLVMOptimizer::optimize(Module &module) const {
+        if (optimizationLevel == OptimizationLevel::O0) {
+            return;
+        }
+        //向量化的代价模型依赖TargetTransformInfo 模块需要带上宿主机的triple和dataLayout
+        module.setTargetTriple(targetMachine->getTargetTriple().str());
+        module.setDataLayout(targetMachine->createDataLayout());
+
+        LoopAnalysisManager loopAnalysisManager;
+        FunctionAnalysisManager functionAnalysisManager;
+        CGSCCAnalysisManager cgsccAnalysisManager;
+        ModuleAnalysisManager moduleAnalysisManager;
+
+        PipelineTuningOptions tuningOptions;
+        tuningOptions.LoopVectorization = vectorize;
+        tuningOptions.SLPVectorization = vectorize;
+        tuningOptions.LoopUnrolling = true;
+
+        PassBuilder passBuilder(targetMachine.get(), tuningOptions);
+        passBuilder.registerModuleAnalyses(moduleAnalysisManager);
+        passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
+        passBuilder.registerFunctionAnalyses(functionAnalysisManager);
+        passBuilder.registerLoopAnalyses(loopAnalysisManager);
+        passBuilder.crossRegisterProxies(
+            loopAnalysisManager,
+            functionAnalysisManager,
+            cgsccAnalysisManager,
+            moduleAnalysisManager
+        );
+        //在函数简化流水线的最后(IndVars之后 向量化之前)去掉计数循环里的safePoint
+        passBuilder.registerScalarOptimizerLateEPCallback([](FunctionPassManager &functionPassManager, OptimizationLevel) {
+            functionPassManager.addPass(CountedLoopSafePointEliminatePass());
+        });
+
+        auto modulePassManager = passBuilder.buildPerModuleDefaultPipeline(optimizationLevel);
+        modulePassManager.run(module, moduleAnalysisManager);
+    }
+
+}
@@ -0,0 +1,35 @@
+#ifndef LLVM_OPTIMIZER_HPP
+#define LLVM_OPTIMIZER_HPP
+#include "../basic.hpp"
+#include <llvm/IR/PassManager.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Target/TargetMachine.h>
+
+namespace RexVM {
+
+    constexpr unsigned SAFE_POINT_FREE_MAX_TRIP_COUNT = 1000;
+    constexpr size_t SAFE_POINT_FREE_MAX_BODY_SIZE = 128;
+    constexpr u4 SAFE_POINT_STRIP_MINE_CHUNK = 1000;
+
+    //最内层循环中如果除了safePoint没有其他调用:
+    //  常量次数较小 或者int计数且循环体不超过SAFE_POINT_FREE_MAX_BODY_SIZE条指令 去掉safePoint(和HotSpot对int计数循环的处理一样)
+    //  否则做strip mining 每SAFE_POINT_STRIP_MINE_CHUNK次迭代执行一次safePoint 避免长循环让STW一直等待
+    //循环体里的函数调用会让LLVM的循环向量化失败 外层循环的safePoint不动
+    struct CountedLoopSafePointEliminatePass : llvm::PassInfoMixin<CountedLoopSafePointEliminatePass> {
+        llvm::PreservedAnalyses run(llvm::Function &function, llvm::FunctionAnalysisManager &analysisManager);
+    };
+
+    //在代码生成前跑LLVM的IR优化 TargetMachine来自detectHost 向量化会用到宿主CPU的特性(AVX2/NEON)
+    struct LLVMOptimizer {
+        std::unique_ptr<llvm::TargetMachine> targetMachine;
+        llvm::OptimizationLevel optimizationLevel;
+        bool vectorize;
+
+        explicit LLVMOptimizer(std::unique_ptr<llvm::TargetMachine> targetMachine, size_t optimizeLevel, bool vectorize);
+
+        void optimize(llvm::Module &module) const;
+    };
+
+}
+
+#endif
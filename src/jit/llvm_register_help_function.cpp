@@ -26,6 +26,14 @@ namespace RexVM {
         const auto newObjectType = FunctionType::get(ptrTy, {ptrTy, int8Ty, int32Ty, ptrTy, ptrTy}, false);
         newObject = module.getOrInsertFunction("llvm_compile_new_object", newObjectType);
 
+        //返回的是新分配的对象 标记noalias和nonnull 方便LLVM做别名分析
+        const auto newObjectFastType = FunctionType::get(ptrTy, {ptrTy, ptrTy, int32Ty}, false);
+        newObjectFast = module.getOrInsertFunction("llvm_compile_new_object_fast", newObjectFastType);
+        if (const auto newObjectFastFunction = dyn_cast<Function>(newObjectFast.getCallee())) {
+            newObjectFastFunction->addRetAttr(Attribute::NoAlias);
+            newObjectFastFunction->addRetAttr(Attribute::NonNull);
+        }
+
         const auto throwType = FunctionType::get(voidTy, {ptrTy, ptrTy, int32Ty, int8Ty, ptrTy}, false);
         throwException = module.getOrInsertFunction("llvm_compile_throw_exception", throwType);
 
@@ -34,6 +42,12 @@ namespace RexVM {
 
         const auto miscType = FunctionType::get(int32Ty, {ptrTy, ptrTy, ptrTy, int8Ty}, false);
         misc = module.getOrInsertFunction("llvm_compile_misc", miscType);
+
+        const auto deoptimizeType = FunctionType::get(voidTy, {ptrTy, int32Ty, int16Ty, int8Ty}, false);
+        deoptimize = module.getOrInsertFunction("llvm_compile_deoptimize", deoptimizeType);
+
+        const auto intrinsicType = FunctionType::get(int64Ty, {ptrTy, ptrTy, ptrTy, int64Ty, int32Ty, int8Ty}, false);
+        intrinsic = module.getOrInsertFunction("llvm_compile_intrinsic", intrinsicType);
     }
 
 
@@ -63,6 +77,10 @@ namespace RexVM {
         return irBuilder.CreateCall(newObject, {framePtr, irBuilder.getInt8(type), length, klass, hasException});
     }
 
+    Value *LLVMHelpFunction::createCallNewFast(IRBuilder<> &irBuilder, Value *framePtr, Value *klass, Value *length) const {
+        return irBuilder.CreateCall(newObjectFast, {framePtr, klass, length});
+    }
+
     void LLVMHelpFunction::createCallThrowException(
         IRBuilder<> &irBuilder, Value *framePtr, Value *exception,
         const u4 pc, const u1 fixedException, Value *exField
@@ -83,5 +101,18 @@ namespace RexVM {
         return irBuilder.CreateCall(misc, {framePtr, pa, pb, irBuilder.getInt8(type)});
     }
 
+    void LLVMHelpFunction::createCallDeoptimize(IRBuilder<> &irBuilder, Value *framePtr, const u4 pc,
+                                                const u2 stackSize, const u1 reason) const {
+        irBuilder.CreateCall(
+            deoptimize,
+            {framePtr, irBuilder.getInt32(pc), irBuilder.getInt16(stackSize), irBuilder.getInt8(reason)}
+        );
+    }
+
+    Value *LLVMHelpFunction::createCallIntrinsic(IRBuilder<> &irBuilder, Value *framePtr, Value *pa, Value *pb,
+                                                 Value *va, Value *vb, const u1 type) const {
+        return irBuilder.CreateCall(intrinsic, {framePtr, pa, pb, va, vb, irBuilder.getInt8(type)});
+    }
+
 
 }
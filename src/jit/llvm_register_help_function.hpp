@@ -15,9 +15,12 @@ namespace RexVM {
         llvm::FunctionCallee returnCommon{};
         llvm::FunctionCallee invokeMethodFixed{};
         llvm::FunctionCallee newObject{};
+        llvm::FunctionCallee newObjectFast{};
         llvm::FunctionCallee throwException{};
         llvm::FunctionCallee matchCatch{};
         llvm::FunctionCallee misc{};
+        llvm::FunctionCallee deoptimize{};
+        llvm::FunctionCallee intrinsic{};
 
         llvm::Value *createCallGetInstanceConstant(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, u2 index) const;
 
@@ -27,12 +30,18 @@ namespace RexVM {
 
         llvm::Value *createCallNew(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, uint8_t type, llvm::Value *length, llvm::Value *klass, llvm::Value *hasException) const;
 
+        llvm::Value *createCallNewFast(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, llvm::Value *klass, llvm::Value *length) const;
+
         void createCallThrowException(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, llvm::Value *exception, u4 pc, u1 fixedException, llvm::Value *exField) const;
 
         llvm::Value *createCallMatchCatch(llvm::IRBuilder<> &irBuilder, llvm::Value *oop, llvm::Value *catchClasses, u4 size) const;
 
         llvm::Value * createCallMisc(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, llvm::Value *pa, llvm::Value *pb, u1 type) const;
 
+        void createCallDeoptimize(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, u4 pc, u2 stackSize, u1 reason) const;
+
+        llvm::Value *createCallIntrinsic(llvm::IRBuilder<> &irBuilder, llvm::Value *framePtr, llvm::Value *pa, llvm::Value *pb, llvm::Value *va, llvm::Value *vb, u1 type) const;
+
     };
 
 }
@@ -1,6 +1,9 @@
 #include "jit_manager.hpp"
+#include <algorithm>
 #include "vm.hpp"
+#include "class.hpp"
 #include "class_member.hpp"
+#include "class_loader.hpp"
 #ifdef LLVM_JIT
 #include "jit/llvm_jit_engine.hpp"
 #endif
@@ -28,7 +31,7 @@ namespace RexVM {
                         }
                         if (!stayCompileMethod->canCompile
                             || stayCompileMethod->isNative()
-                            || stayCompileMethod->compiledMethodHandler != nullptr) {
+                            || stayCompileMethod->compiledMethodHandler.load(std::memory_order_acquire) != nullptr) {
                             continue;
                         }
                         llvmEngine->compileMethod(*stayCompileMethod);
@@ -36,15 +39,45 @@ namespace RexVM {
                 }
             }
         });
+
+        if (!vm.params.jitCodeCacheDir.empty()) {
+            //JITManager创建前已经加载的基础类 在这里补一次缓存检查
+            std::vector<InstanceClass *> loadedClasses; {
+                auto &classLoader = *vm.bootstrapClassLoader;
+                std::lock_guard guard(classLoader.clMutex);
+                for (const auto &[name, klass]: classLoader.classMap) {
+                    if (klass->isInstanceClass()) {
+                        loadedClasses.emplace_back(CAST_INSTANCE_CLASS(klass.get()));
+                    }
+                }
+            }
+            for (const auto &klass: loadedClasses) {
+                checkCodeCache(*klass);
+            }
+        }
     }
 
     void JITManager::checkCompile(Method &method) {
-        if (!vm.params.jitEnable
-            || !method.canCompile
+        if (!vm.params.jitEnable) {
+            return;
+        }
+        //方法变热后开始收集profile 编译时使用
+        if (vm.params.jitProfile
+            && method.canCompile
+            && !method.isNative()
+            && method.invokeCounter >= vm.params.jitProfileMethodInvokeCountThreshold
+            && method.getProfile() == nullptr) {
+            method.initProfile();
+        }
+        const auto compileThreshold =
+            method.hasCachedCode
+                ? vm.params.jitProfileMethodInvokeCountThreshold
+                : vm.params.jitCompileMethodInvokeCountThreshold;
+        if (!method.canCompile
             || method.markCompile
             || method.isNative()
-            || method.compiledMethodHandler != nullptr
-            || method.invokeCounter < vm.params.jitCompileMethodInvokeCountThreshold) {
+            || method.compiledMethodHandler.load(std::memory_order_acquire) != nullptr
+            || method.invokeCounter < compileThreshold) {
             return;
         }
         method.markCompile = true;
@@ -52,6 +85,49 @@ namespace RexVM {
         compileMethods.emplace(&method);
     }
 
+    void JITManager::deoptimize(Method &method, const u4 pc, const u1 reason) {
+        //记录推测失败的pc 让旧的编译代码失效 后续调用走解释器
+        //调用次数重新达到阈值后会再次编译 新代码在这些pc上不再推测
+        method.addDeoptPC(pc);
+        method.compiledMethodHandler.store(nullptr, std::memory_order_release);
+#ifdef DEBUG
+        cprintln("jit deoptimize {}#{} pc: {}, reason: {}", method.klass.getClassName(), method.getName(), pc, reason);
+#endif
+        //invokeCounter在每次去优化时清零 这里是上次去优化以来的调用次数
+        //稳定运行了足够久的方法按调用次数衰减去优化计数 程序阶段变化引起的偶尔去优化不会让方法永久解释执行
+        const auto decayCount = vm.params.jitDeoptDecayInvokeCount;
+        const auto decay = decayCount > 0 ? method.invokeCounter / decayCount : 0;
+        auto deoptCounter = method.deoptCounter.load(std::memory_order_relaxed);
+        u2 newDeoptCounter;
+        do {
+            newDeoptCounter = CAST_U2(deoptCounter - std::min<size_t>(deoptCounter, decay) + 1);
+        } while (!method.deoptCounter.compare_exchange_weak(deoptCounter, newDeoptCounter, std::memory_order_relaxed));
+        if (newDeoptCounter > vm.params.jitDeoptRecompileLimit) {
+            method.canCompile = false;
+            return;
+        }
+        method.invokeCounter = 0;
+        method.markCompile = false;
+    }
+
+    void JITManager::checkCodeCache(InstanceClass &klass) {
+        //类加载时标记命中磁盘缓存的方法 调用次数达到profile阈值时就编译 不等编译阈值
+        //命中时只需重建IR 跳过代码生成 直接链接缓存中的目标文件
+        //没有执行过的冷方法不编译 也不会把没有profile的代码写进缓存
+        if (!vm.params.jitEnable || vm.params.jitCodeCacheDir.empty()) {
+            return;
+        }
+        for (const auto &method: klass.methods) {
+            if (method->isNative()
+                || method->isAbstract()
+                || method->codeLength == 0
+                || !method->canCompile) {
+                continue;
+            }
+            method->hasCachedCode = llvmEngine->hasCachedMethod(*method);
+        }
+    }
+
     JITManager::~JITManager() {
         if (compileThread.joinable()) {
             compileThread.join();
@@ -60,6 +136,8 @@ namespace RexVM {
 #else
     JITManager::JITManager(VM &vm) {}
     void JITManager::checkCompile(Method &method) {};
+    void JITManager::deoptimize(Method &method, u4 pc, u1 reason) {};
+    void JITManager::checkCodeCache(InstanceClass &klass) {};
     JITManager::~JITManager() = default;
 #endif
 }
@@ -9,6 +9,7 @@ namespace RexVM {
 
     struct VM;
     struct Method;
+    struct InstanceClass;
     struct Frame;
     struct LLVM_JIT_Engine;
 
@@ -30,6 +31,10 @@ namespace RexVM {
 
         void checkCompile(Method &method);
 
+        void deoptimize(Method &method, u4 pc, u1 reason);
+
+        void checkCodeCache(InstanceClass &klass);
+
         CompiledMethodHandler compileMethod(Method &method);
     };
 
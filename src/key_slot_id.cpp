@@ -3,6 +3,7 @@
 namespace RexVM {
 
     u2 stringClassValueFieldSlotId;
+    u2 stringClassHashFieldSlotId;
 
     u2 throwableClassDetailMessageFieldSlotId;
     u2 throwableClassBacktraceFID;
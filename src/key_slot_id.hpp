@@ -5,6 +5,7 @@
 namespace RexVM {
 
     extern u2 stringClassValueFieldSlotId;
+    extern u2 stringClassHashFieldSlotId;
 
     extern u2 throwableClassDetailMessageFieldSlotId;
     extern u2 throwableClassBacktraceFID;
@@ -1,9 +1,29 @@
 #include <vector>
+#include <cstring>
 #include "utils/format.hpp"
 #include "vm.hpp"
 
+constexpr auto SHARED_ARCHIVE_FILE_OPTION = "-XX:SharedArchiveFile=";
+constexpr auto SHARED_CLASS_LIST_FILE_OPTION = "-XX:SharedClassListFile=";
+constexpr auto DUMP_LOADED_CLASS_LIST_OPTION = "-XX:DumpLoadedClassList=";
+constexpr auto HEAP_SNAPSHOT_FILE_OPTION = "-XX:HeapSnapshotFile=";
+constexpr auto JIT_OPTIMIZE_LEVEL_OPTION = "-XX:JitOptimizeLevel=";
+constexpr auto JIT_CODE_CACHE_DIR_OPTION = "-XX:JitCodeCacheDir=";
+
 void printUsage() {
-    RexVM::cprintln("Usage: rex [-cp <classpath>] <MainClass> [params...]");
+    RexVM::cprintln("Usage: rex [-cp <classpath>] [-XX:SharedArchiveFile=<file>] [-Xshare:dump] [-XX:SharedClassListFile=<file>] [-XX:DumpLoadedClassList=<file>] [-XX:HeapSnapshotFile=<file>] [-XX:+DumpHeapSnapshot] [-XX:+ClassPrefetch] "
+                    "[-XX:JitOptimizeLevel=<0-3>] [-XX:JitCodeCacheDir=<dir>] [-XX:+/-JitSpeculate] [-XX:+/-JitVectorize] [-XX:+/-JitProfile] [-XX:+PerfMap] [-XX:+JitDump] "
+                    "[-Xint] [-XX:+/-UseSuperInstructions] [-XX:+/-UseRegisterCode] "
+                    "<MainClass> [params...]");
+}
+
+//-XX:+Name 打开 -XX:-Name 关闭
+bool parseBoolOption(const char *arg, const char *name, bool &value) {
+    if (strncmp(arg, "-XX:", 4) != 0 || (arg[4] != '+' && arg[4] != '-') || strcmp(arg + 5, name) != 0) {
+        return false;
+    }
+    value = arg[4] == '+';
+    return true;
 }
 
 int parseArgs(int argc, char *argv[], RexVM::ApplicationParameter &applicationParameter) {
@@ -20,11 +40,54 @@ int parseArgs(int argc, char *argv[], RexVM::ApplicationParameter &applicationPa
             if (i + 1 < argc) {
                 applicationParameter.userClassPath = argv[++i];
             }
+        } else if (strncmp(argv[i], SHARED_ARCHIVE_FILE_OPTION, strlen(SHARED_ARCHIVE_FILE_OPTION)) == 0) {
+            applicationParameter.classArchivePath = argv[i] + strlen(SHARED_ARCHIVE_FILE_OPTION);
+        } else if (strncmp(argv[i], SHARED_CLASS_LIST_FILE_OPTION, strlen(SHARED_CLASS_LIST_FILE_OPTION)) == 0) {
+            applicationParameter.classListPath = argv[i] + strlen(SHARED_CLASS_LIST_FILE_OPTION);
+        } else if (strncmp(argv[i], DUMP_LOADED_CLASS_LIST_OPTION, strlen(DUMP_LOADED_CLASS_LIST_OPTION)) == 0) {
+            applicationParameter.classListDumpPath = argv[i] + strlen(DUMP_LOADED_CLASS_LIST_OPTION);
+        } else if (strncmp(argv[i], HEAP_SNAPSHOT_FILE_OPTION, strlen(HEAP_SNAPSHOT_FILE_OPTION)) == 0) {
+            applicationParameter.heapSnapshotPath = argv[i] + strlen(HEAP_SNAPSHOT_FILE_OPTION);
+        } else if (strcmp(argv[i], "-XX:+DumpHeapSnapshot") == 0) {
+            applicationParameter.heapSnapshotDump = true;
+        } else if (strncmp(argv[i], JIT_OPTIMIZE_LEVEL_OPTION, strlen(JIT_OPTIMIZE_LEVEL_OPTION)) == 0) {
+            const auto level = argv[i] + strlen(JIT_OPTIMIZE_LEVEL_OPTION);
+            if (strlen(level) != 1 || level[0] < '0' || level[0] > '3') {
+                RexVM::cprintlnErr("{} requires a level between 0 and 3", JIT_OPTIMIZE_LEVEL_OPTION);
+                return 1;
+            }
+            applicationParameter.jitCompileOptimizeLevel = level[0] - '0';
+        } else if (strncmp(argv[i], JIT_CODE_CACHE_DIR_OPTION, strlen(JIT_CODE_CACHE_DIR_OPTION)) == 0) {
+            applicationParameter.jitCodeCacheDir = argv[i] + strlen(JIT_CODE_CACHE_DIR_OPTION);
+        } else if (parseBoolOption(argv[i], "ClassPrefetch", applicationParameter.classPrefetchEnable) ||
+                   parseBoolOption(argv[i], "JitSpeculate", applicationParameter.jitSpeculate) ||
+                   parseBoolOption(argv[i], "JitVectorize", applicationParameter.jitVectorize) ||
+                   parseBoolOption(argv[i], "JitProfile", applicationParameter.jitProfile) ||
+                   parseBoolOption(argv[i], "PerfMap", applicationParameter.jitPerfMap) ||
+                   parseBoolOption(argv[i], "JitDump", applicationParameter.jitDump) ||
+                   parseBoolOption(argv[i], "UseSuperInstructions", applicationParameter.superInstructionEnable) ||
+                   parseBoolOption(argv[i], "UseRegisterCode", applicationParameter.registerCodeEnable)) {
+            continue;
+        } else if (strcmp(argv[i], "-Xint") == 0) {
+            //只用解释器执行 测试时作为其他执行方式的对照
+            applicationParameter.jitEnable = false;
+        } else if (strcmp(argv[i], "-Xshare:dump") == 0) {
+            applicationParameter.classArchiveDump = true;
         } else {
             params.emplace_back(argv[i]);
         }
     }
 
+    if (applicationParameter.classArchiveDump && applicationParameter.classArchivePath.empty()) {
+        RexVM::cprintlnErr("-Xshare:dump requires -XX:SharedArchiveFile=<file>");
+        return 1;
+    }
+
+    if (applicationParameter.heapSnapshotDump && applicationParameter.heapSnapshotPath.empty()) {
+        RexVM::cprintlnErr("-XX:+DumpHeapSnapshot requires -XX:HeapSnapshotFile=<file>");
+        return 1;
+    }
+
     applicationParameter.userParams = params;
     return 0;
 }
@@ -1,4 +1,5 @@
 #include "memory.hpp"
+#include <bit>
 
 #include "vm.hpp"
 #include "thread.hpp"
@@ -124,8 +125,14 @@ namespace RexVM {
     }
 
     TypeArrayOop *OopManager::newTypeArrayOop(VMThread *thread, BasicType type, size_t length) {
-        TypeArrayOop *oop = nullptr;
         const auto klass = vm.bootstrapClassLoader->getTypeArrayClass(type);
+        return newTypeArrayOop(thread, klass, length);
+    }
+
+    //数组类已经解析好的版本 不需要再按类名查找数组类
+    TypeArrayOop *OopManager::newTypeArrayOop(VMThread *thread, TypeArrayClass *klass, size_t length) {
+        TypeArrayOop *oop = nullptr;
+        const auto type = klass->elementType;
         switch (type) {
             case BasicType::T_BOOLEAN:
             case BasicType::T_BYTE:
@@ -255,4 +262,13 @@ namespace RexVM {
         ++allocatedOopCount;
         allocatedOopMemory += oop->getMemorySize();
     }
+
+    i4 OopManager::getIdentityHash(ref oop) const {
+        if (!restoredIdentityHashes.empty()) [[unlikely]] {
+            if (const auto hash = restoredIdentityHashes.try_get(oop); hash != nullptr) {
+                return *hash;
+            }
+        }
+        return CAST_I4(std::bit_cast<u8>(oop));
+    }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <map>
 #include <vector>
 #include <atomic>
+#include <hash_table8.hpp>
 #include "utils/spin_lock.hpp"
 
 namespace RexVM {
@@ -19,6 +20,7 @@ namespace RexVM {
     struct CharTypeArrayOop;
     struct InstanceClass;
     struct ObjArrayClass;
+    struct TypeArrayClass;
 
     struct OopHolder {
         std::vector<ref> oops;
@@ -48,6 +50,7 @@ namespace RexVM {
         [[nodiscard]] ObjArrayOop *newStringObjArrayOop(VMThread *thread, size_t length);
 
         [[nodiscard]] TypeArrayOop *newTypeArrayOop(VMThread *thread, BasicType type, size_t length);
+        [[nodiscard]] TypeArrayOop *newTypeArrayOop(VMThread *thread, TypeArrayClass *klass, size_t length);
         [[nodiscard]] ByteTypeArrayOop *newByteArrayOop(VMThread *thread, size_t length);
         [[nodiscard]] ByteTypeArrayOop *newByteArrayOop(VMThread *thread, size_t length, const u1 *initBuffer);
         [[nodiscard]] CharTypeArrayOop *newCharArrayOop(VMThread *thread, size_t length);
@@ -64,6 +67,13 @@ namespace RexVM {
 
         void addToOopHolder(VMThread *thread, ref oop);
 
+        //Object.hashCode和System.identityHashCode的值 默认是对象地址
+        [[nodiscard]] i4 getIdentityHash(ref oop) const;
+
+        //从堆快照恢复的对象地址变了 保留快照时的identity hash 以identity hash为key的集合才能继续使用
+        //只在恢复时(其他线程启动前)写入 GC回收对象时(StopTheWorld中)删除
+        emhash8::HashMap<ref, i4> restoredIdentityHashes;
+
         std::atomic_size_t allocatedOopCount {0};
         std::atomic_size_t allocatedOopMemory {0};
 
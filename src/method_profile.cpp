@@ -0,0 +1,94 @@
+#include "method_profile.hpp"
+#include "class_member.hpp"
+#include "opcode.hpp"
+
+namespace RexVM {
+
+    void ProfileCounter::increment() {
+        value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    u4 ProfileCounter::get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+    void BranchProfile::record(const bool jump) {
+        if (jump) {
+            taken.increment();
+        } else {
+            notTaken.increment();
+        }
+    }
+
+    void TypeProfile::record(Class *klass) {
+        for (size_t i = 0; i < TYPE_PROFILE_ROW_COUNT; ++i) {
+            auto current = types[i].load(std::memory_order_relaxed);
+            if (current == nullptr) {
+                //空行 抢占失败说明被其他线程占了 重新比较
+                if (types[i].compare_exchange_strong(current, klass, std::memory_order_relaxed)) {
+                    current = klass;
+                }
+            }
+            if (current == klass) {
+                counts[i].increment();
+                return;
+            }
+        }
+        otherCount.increment();
+    }
+
+    void TypeProfile::recordNull() {
+        if (!nullSeen.load(std::memory_order_relaxed)) {
+            nullSeen.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    Class *TypeProfile::getMonomorphicClass() const {
+        if (otherCount.get() != 0) {
+            return nullptr;
+        }
+        const auto klass = types[0].load(std::memory_order_relaxed);
+        for (size_t i = 1; i < TYPE_PROFILE_ROW_COUNT; ++i) {
+            if (types[i].load(std::memory_order_relaxed) != nullptr) {
+                return nullptr;
+            }
+        }
+        return klass;
+    }
+
+    MethodProfile::MethodProfile(const Method &method) : profileIndex(method.codeLength, PROFILE_NO_INDEX) {
+        const auto code = method.code;
+        size_t branchCount{0};
+        size_t typeCount{0};
+        for (u4 pc = 0; pc < method.codeLength; pc += getOpCodeLength(code, pc)) {
+            switch (const auto opCode = static_cast<OpCodeEnum>(code[pc]); opCode) {
+                case OpCodeEnum::INVOKEVIRTUAL:
+                case OpCodeEnum::INVOKEINTERFACE:
+                case OpCodeEnum::CHECKCAST:
+                case OpCodeEnum::INSTANCEOF:
+                    profileIndex[pc] = CAST_U2(typeCount++);
+                    break;
+
+                default:
+                    if (isConditionalJumpOpCode(opCode)) {
+                        profileIndex[pc] = CAST_U2(branchCount++);
+                    }
+                    break;
+            }
+        }
+        //profile中有atomic 不能移动 一次性按数量构造
+        branchProfiles = std::vector<BranchProfile>(branchCount);
+        typeProfiles = std::vector<TypeProfile>(typeCount);
+    }
+
+    BranchProfile *MethodProfile::getBranchProfile(const u4 pc) {
+        const auto index = profileIndex[pc];
+        return index == PROFILE_NO_INDEX ? nullptr : &branchProfiles[index];
+    }
+
+    TypeProfile *MethodProfile::getTypeProfile(const u4 pc) {
+        const auto index = profileIndex[pc];
+        return index == PROFILE_NO_INDEX ? nullptr : &typeProfiles[index];
+    }
+
+}
@@ -0,0 +1,63 @@
+#ifndef METHOD_PROFILE_HPP
+#define METHOD_PROFILE_HPP
+#include "basic.hpp"
+#include <atomic>
+#include <array>
+#include <vector>
+#include <limits>
+
+namespace RexVM {
+
+    struct Method;
+    struct Class;
+
+    constexpr u2 PROFILE_NO_INDEX = std::numeric_limits<u2>::max();
+    constexpr size_t TYPE_PROFILE_ROW_COUNT = 2;
+
+    //解释器更新计数不加锁 也不做原子加 多线程下丢失少量计数可以接受
+    struct ProfileCounter {
+        std::atomic_uint32_t value{0};
+
+        void increment();
+        [[nodiscard]] u4 get() const;
+    };
+
+    //if系列指令
+    struct BranchProfile {
+        ProfileCounter taken;
+        ProfileCounter notTaken;
+
+        void record(bool jump);
+    };
+
+    //invokevirtual invokeinterface 的接收者类型 checkcast instanceof 的对象类型
+    struct TypeProfile {
+        std::array<std::atomic<Class *>, TYPE_PROFILE_ROW_COUNT> types{};
+        std::array<ProfileCounter, TYPE_PROFILE_ROW_COUNT> counts{};
+        ProfileCounter otherCount; //行都被占满后 其他类型的次数
+        ProfileCounter failedCount; //checkcast失败(抛出ClassCastException)的次数
+        std::atomic_bool nullSeen{false};
+
+        void record(Class *klass);
+        void recordNull();
+
+        //只出现过一个类型 返回该类型 否则返回nullptr
+        [[nodiscard]] Class *getMonomorphicClass() const;
+    };
+
+    //方法变热(调用次数达到jitProfileMethodInvokeCountThreshold)后才创建 由解释器更新 编译器读取
+    //按pc找到对应的profile: profileIndex[pc] 是分支或类型profile数组的下标
+    struct MethodProfile {
+        std::vector<u2> profileIndex;
+        std::vector<BranchProfile> branchProfiles;
+        std::vector<TypeProfile> typeProfiles;
+
+        explicit MethodProfile(const Method &method);
+
+        [[nodiscard]] BranchProfile *getBranchProfile(u4 pc);
+        [[nodiscard]] TypeProfile *getTypeProfile(u4 pc);
+    };
+
+}
+
+#endif
@@ -21,7 +21,7 @@ namespace RexVM::Native::Core {
     }
 
     void hashCode(Frame &frame) {
-        frame.returnI4(CAST_I4(std::bit_cast<u8>(frame.getThis())));
+        frame.returnI4(frame.vm.oopManager->getIdentityHash(frame.getThis()));
     }
 
     template<typename T>
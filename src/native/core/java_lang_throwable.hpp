@@ -23,12 +23,16 @@ namespace RexVM::Native::Core {
         return stackTraceElementOop;
     }
 
+    //backtrace中每个栈帧占两个元素: Method指针和pc
+    constexpr size_t BACKTRACE_ELEMENT_SIZE = 2;
+
+    //只记录栈帧的Method和pc StackTraceElement在getStackTraceElement中按需创建
+    //大部分用于控制流的异常不会打印栈 不需要转换类名和查找行号
+    //类不会被卸载 Method指针一直有效 类的mirror由gc从类加载器中作为根扫描
     void fillInStackTrace(Frame &frame) {
         const auto self = frame.getThisInstance();
         const auto throwableClass = frame.mem.getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_THROWABLE);
-        const auto stackTraceElementClass = frame.mem.getBasicJavaClass(BasicJavaClassEnum::JAVA_LANG_STACK_TRACE_ELEMENT);
-        const auto stackTraceElementArrayClass = frame.mem.getObjectArrayClass(*stackTraceElementClass);
-        std::vector<InstanceOop *> stackTraceElements;
+        std::vector<std::pair<const Method *, u4>> backtraceFrames;
         auto notCheck = false; //用于少进行一些 isSubClassOf 检测 提升性能 跳过Exception的栈后就不用再check了
         //frame is native fillInStackTrace
         //frame->previous is public synchronized Throwable fillInStackTrace()
@@ -41,42 +45,49 @@ namespace RexVM::Native::Core {
                 continue;
             }
             notCheck = true;
-            const auto className = getJavaClassName(klass.getClassName());
-            const auto methodName = method.getName();
-            const auto sourceFileName = method.klass.sourceFile;
-            const auto lineNumber = method.getLineNumber(currentFrame->pc());
-            stackTraceElements.emplace_back(createStackTraceElement(frame, className, methodName, sourceFileName, CAST_I4(lineNumber)));
+            backtraceFrames.emplace_back(&method, currentFrame->pc());
         }
 
-        const auto arrayOop = frame.mem.newObjArrayOop(stackTraceElementArrayClass, stackTraceElements.size());
-        std::ranges::copy(stackTraceElements, arrayOop->data.get());
+        const auto backtrace =
+            CAST_LONG_TYPE_ARRAY_OOP(frame.mem.newTypeArrayOop(BasicType::T_LONG, backtraceFrames.size() * BACKTRACE_ELEMENT_SIZE));
+        for (size_t i = 0; i < backtraceFrames.size(); ++i) {
+            const auto [method, pc] = backtraceFrames[i];
+            backtrace->data[i * BACKTRACE_ELEMENT_SIZE] = std::bit_cast<i8>(method);
+            backtrace->data[i * BACKTRACE_ELEMENT_SIZE + 1] = CAST_I8(pc);
+        }
         self->setFieldValue(throwableClassStacktraceFID, Slot(nullptr));
-        self->setFieldValue(throwableClassBacktraceFID, Slot(arrayOop));
+        self->setFieldValue(throwableClassBacktraceFID, Slot(backtrace));
         frame.returnRef(self);
     }
 
     //native StackTraceElement getStackTraceElement(int index);
+    //Throwable.getOurStackTrace会把结果缓存到stackTrace字段 每个元素只创建一次
     void getStackTraceElement(Frame &frame) {
         const auto self = frame.getThisInstance();
-        const auto index = frame.getLocalI4(1);
-        const auto stackTraceElements = CAST_OBJ_ARRAY_OOP(self->getFieldValue(throwableClassBacktraceFID).refVal);
-        if (stackTraceElements == nullptr) {
+        const auto index = CAST_SIZE_T(frame.getLocalI4(1));
+        const auto backtrace = CAST_LONG_TYPE_ARRAY_OOP(self->getFieldValue(throwableClassBacktraceFID).refVal);
+        if (backtrace == nullptr) {
             frame.returnRef(nullptr);
             return;
         }
-        frame.returnRef(stackTraceElements->data[index]);
+        const auto method = std::bit_cast<const Method *>(backtrace->data[index * BACKTRACE_ELEMENT_SIZE]);
+        const auto pc = CAST_U4(backtrace->data[index * BACKTRACE_ELEMENT_SIZE + 1]);
+        const auto &klass = method->klass;
+        const auto className = getJavaClassName(klass.getClassName());
+        const auto lineNumber = method->getLineNumber(pc);
+        frame.returnRef(createStackTraceElement(frame, className, method->getName(), klass.sourceFile, CAST_I4(lineNumber)));
     }
 
     //native int getStackTraceDepth();
     void getStackTraceDepth(Frame &frame) {
         const auto self = frame.getThisInstance();
-        const auto stackTraceElements = CAST_OBJ_ARRAY_OOP(self->getFieldValue(throwableClassBacktraceFID).refVal);
-        if (stackTraceElements == nullptr) {
+        const auto backtrace = CAST_LONG_TYPE_ARRAY_OOP(self->getFieldValue(throwableClassBacktraceFID).refVal);
+        if (backtrace == nullptr) {
             frame.returnI4(0);
             return;
         }
-        frame.returnI4(CAST_I4(stackTraceElements->getDataLength()));
+        frame.returnI4(CAST_I4(backtrace->getDataLength() / BACKTRACE_ELEMENT_SIZE));
     }
 }
 
-#endif
\ No newline at end of file
+#endif
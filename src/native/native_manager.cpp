@@ -21,20 +21,40 @@ namespace RexVM {
     void
     NativeManager::regNativeMethod(cview className, cview methodName, cview descriptor,
                                    bool isStatic, NativeMethodHandler handler) {
-        const auto key = cformat("{}:{}:{}", className, methodName, descriptor);
+        const NativeMethodKey key{internSymbol(className), internSymbol(methodName), internSymbol(descriptor)};
         nativeMethods.emplace(key, handler);
     }
 
     NativeMethodHandler
     NativeManager::getNativeMethod(cview className, cview methodName,
                                    cview descriptor, bool isStatic) {
-
         if (methodName == "registerNatives" || methodName == "initIDs") {
             return nopMethod;
         }
 
-        const auto key = cformat("{}:{}:{}", className, methodName, descriptor);
-        if (const auto iter = nativeMethods.find(key); iter != nativeMethods.end()) {
+        //没有驻留过的名字不可能注册过
+        auto &symbolTable = SymbolTable::instance();
+        const auto classNameSymbol = symbolTable.find(className);
+        const auto methodNameSymbol = symbolTable.find(methodName);
+        const auto descriptorSymbol = symbolTable.find(descriptor);
+        if (classNameSymbol == nullptr || methodNameSymbol == nullptr || descriptorSymbol == nullptr) {
+            return nullptr;
+        }
+        return getNativeMethod(classNameSymbol, methodNameSymbol, descriptorSymbol, isStatic);
+    }
+
+    NativeMethodHandler
+    NativeManager::getNativeMethod(const Symbol *className, const Symbol *methodName,
+                                   const Symbol *descriptor, bool isStatic) {
+        static const auto registerNativesSymbol = internSymbol("registerNatives");
+        static const auto initIDsSymbol = internSymbol("initIDs");
+
+        if (methodName == registerNativesSymbol || methodName == initIDsSymbol) {
+            return nopMethod;
+        }
+
+        if (const auto iter = nativeMethods.find(NativeMethodKey{className, methodName, descriptor});
+                iter != nativeMethods.end()) {
             return iter->second;
         }
         return nullptr;
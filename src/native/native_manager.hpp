@@ -3,12 +3,30 @@
 
 #include <hash_table8.hpp>
 #include "../basic.hpp"
+#include "../symbol_table.hpp"
 
 namespace RexVM {
 
+    //类名 方法名 描述符都是驻留的符号 按指针比较和哈希
+    struct NativeMethodKey {
+        const Symbol *className;
+        const Symbol *methodName;
+        const Symbol *descriptor;
+
+        bool operator==(const NativeMethodKey &other) const = default;
+    };
+
+    struct NativeMethodKeyHash {
+        size_t operator()(const NativeMethodKey &key) const {
+            auto hash = std::hash<const Symbol *>{}(key.className);
+            hash = hash * 31 + std::hash<const Symbol *>{}(key.methodName);
+            return hash * 31 + std::hash<const Symbol *>{}(key.descriptor);
+        }
+    };
+
     struct NativeManager {
 
-        emhash8::HashMap<cstring, NativeMethodHandler> nativeMethods;
+        emhash8::HashMap<NativeMethodKey, NativeMethodHandler, NativeMethodKeyHash> nativeMethods;
 
         void regNativeMethod(
                 cview className, cview methodName, cview descriptor,
@@ -19,6 +37,10 @@ namespace RexVM {
                 cview className, cview methodName, cview descriptor, bool isStatic
         );
 
+        NativeMethodHandler getNativeMethod(
+                const Symbol *className, const Symbol *methodName, const Symbol *descriptor, bool isStatic
+        );
+
         //static safe
         static NativeManager instance;
 
@@ -165,42 +165,10 @@ namespace RexVM {
         }
     }
 
-    void initInstanceField(const InstanceOop *oop, const InstanceClass *klass) {
-        //std::memset(oop->data.get(), 0, sizeof(Slot) * oop->getDataLength());
-        for (const auto &field: klass->fields) {
-            if (!field->isStatic()) {
-                const auto slotType = field->getFieldSlotType();
-                const auto slotId = field->slotId;
-                switch (slotType) {
-                    case SlotTypeEnum::I4:
-                        oop->data[slotId] = Slot(CAST_I4(0));
-                        break;
-                    case SlotTypeEnum::F4:
-                        oop->data[slotId] = Slot(CAST_F4(0));
-                        break;
-                    case SlotTypeEnum::I8:
-                        oop->data[slotId] = Slot(CAST_I8(0));
-                        break;
-                    case SlotTypeEnum::F8:
-                        oop->data[slotId] = Slot(CAST_F8(0));
-                        break;
-                    case SlotTypeEnum::REF:
-                        oop->data[slotId] = Slot(nullptr);
-                        break;
-                    default:
-                        panic("initInstanceField error");
-                }
-            }
-        }
-        if (klass->getSuperClass() != nullptr) {
-            initInstanceField(oop, klass->getSuperClass());
-        }
-    }
-
     InstanceOop::InstanceOop(InstanceClass *klass, const size_t dataLength) :
             Oop(klass, dataLength),
             data(std::make_unique<Slot[]>(dataLength)) {
-        initInstanceField(this, klass);
+        //make_unique<Slot[]>会值初始化 Slot默认构造即全0 对应所有类型字段的默认值(0 0.0 null) 不需要再按字段逐个初始化
         if (klass->overrideFinalize) {
             setFinalized(false);
         }
@@ -250,44 +218,37 @@ namespace RexVM {
             ArrayOop(OopTypeEnum::TYPE_ARRAY_OOP, klass, dataLength) {
     }
 
+    //数组的data都由make_unique<T[]>值初始化为0 不需要再fill
     ObjArrayOop::ObjArrayOop(ObjArrayClass *klass, const size_t dataLength) :
             ArrayOop(OopTypeEnum::OBJ_ARRAY_OOP, klass, dataLength), data(std::make_unique<ref[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, nullptr);
     }
 
     ByteTypeArrayOop::ByteTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<u1[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, CAST_U1(0));
     }
 
     ShortTypeArrayOop::ShortTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<i2[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, CAST_I2(0));
     }
 
     IntTypeArrayOop::IntTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<i4[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, CAST_I4(0));
     }
 
     LongTypeArrayOop::LongTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<i8[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, CAST_I8(0));
     }
 
     CharTypeArrayOop::CharTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<cchar_16[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, '\0');
     }
 
     FloatTypeArrayOop::FloatTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<f4[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, CAST_F4(0));
     }
 
     DoubleTypeArrayOop::DoubleTypeArrayOop(TypeArrayClass *klass, const size_t dataLength) :
         TypeArrayOop(klass, dataLength), data(std::make_unique<f8[]>(dataLength)) {
-            std::fill_n(data.get(), dataLength, CAST_F8(0));
     }
 
 }
\ No newline at end of file
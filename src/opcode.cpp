@@ -1,5 +1,6 @@
 #include "opcode.hpp"
 #include "basic.hpp"
+#include <algorithm>
 
 namespace RexVM {
     const std::array<cview, OPCODE_ENUM_COUNT> OPCODE_NAMES = {
@@ -284,4 +285,189 @@ namespace RexVM {
         return isJumpOpCode(opCode) || isReturnOpCode(opCode);
     }
 
+    bool isConditionalJumpOpCode(const OpCodeEnum opCode) {
+        switch (opCode) {
+            case OpCodeEnum::IFEQ:
+            case OpCodeEnum::IFNE:
+            case OpCodeEnum::IFLT:
+            case OpCodeEnum::IFGE:
+            case OpCodeEnum::IFGT:
+            case OpCodeEnum::IFLE:
+            case OpCodeEnum::IF_ICMPEQ:
+            case OpCodeEnum::IF_ICMPNE:
+            case OpCodeEnum::IF_ICMPLT:
+            case OpCodeEnum::IF_ICMPGE:
+            case OpCodeEnum::IF_ICMPGT:
+            case OpCodeEnum::IF_ICMPLE:
+            case OpCodeEnum::IF_ACMPEQ:
+            case OpCodeEnum::IF_ACMPNE:
+            case OpCodeEnum::IFNULL:
+            case OpCodeEnum::IFNONNULL:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    u4 getOpCodeLength(const u1 *code, const u4 pc) {
+        const auto readI4 = [code](const u4 index) {
+            return CAST_I4(
+                (CAST_U4(code[index]) << 24) |
+                (CAST_U4(code[index + 1]) << 16) |
+                (CAST_U4(code[index + 2]) << 8) |
+                CAST_U4(code[index + 3])
+            );
+        };
+
+        switch (const auto opCode = static_cast<OpCodeEnum>(code[pc])) {
+            case OpCodeEnum::BIPUSH:
+            case OpCodeEnum::LDC:
+            case OpCodeEnum::ILOAD:
+            case OpCodeEnum::LLOAD:
+            case OpCodeEnum::FLOAD:
+            case OpCodeEnum::DLOAD:
+            case OpCodeEnum::ALOAD:
+            case OpCodeEnum::ISTORE:
+            case OpCodeEnum::LSTORE:
+            case OpCodeEnum::FSTORE:
+            case OpCodeEnum::DSTORE:
+            case OpCodeEnum::ASTORE:
+            case OpCodeEnum::RET:
+            case OpCodeEnum::NEWARRAY:
+                return 2;
+
+            case OpCodeEnum::SIPUSH:
+            case OpCodeEnum::LDC_W:
+            case OpCodeEnum::LDC2_W:
+            case OpCodeEnum::IINC:
+            case OpCodeEnum::GOTO:
+            case OpCodeEnum::JSR:
+            case OpCodeEnum::GETSTATIC:
+            case OpCodeEnum::PUTSTATIC:
+            case OpCodeEnum::GETFIELD:
+            case OpCodeEnum::PUTFIELD:
+            case OpCodeEnum::INVOKEVIRTUAL:
+            case OpCodeEnum::INVOKESPECIAL:
+            case OpCodeEnum::INVOKESTATIC:
+            case OpCodeEnum::NEW:
+            case OpCodeEnum::ANEWARRAY:
+            case OpCodeEnum::CHECKCAST:
+            case OpCodeEnum::INSTANCEOF:
+                return 3;
+
+            case OpCodeEnum::MULTIANEWARRAY:
+                return 4;
+
+            case OpCodeEnum::INVOKEINTERFACE:
+            case OpCodeEnum::INVOKEDYNAMIC:
+            case OpCodeEnum::GOTO_W:
+            case OpCodeEnum::JSR_W:
+                return 5;
+
+            case OpCodeEnum::WIDE:
+                return static_cast<OpCodeEnum>(code[pc + 1]) == OpCodeEnum::IINC ? 6 : 4;
+
+            case OpCodeEnum::TABLESWITCH: {
+                //操作码后补齐到4字节 default low high 然后是 high - low + 1 个offset
+                const auto base = (pc + 4) & ~CAST_U4(3);
+                const auto low = readI4(base + 4);
+                const auto high = readI4(base + 8);
+                return base + 12 + CAST_U4(high - low + 1) * 4 - pc;
+            }
+
+            case OpCodeEnum::LOOKUPSWITCH: {
+                //操作码后补齐到4字节 default npairs 然后是 npairs 个 [key offset]
+                const auto base = (pc + 4) & ~CAST_U4(3);
+                const auto npairs = readI4(base + 4);
+                return base + 8 + CAST_U4(npairs) * 8 - pc;
+            }
+
+            default:
+                return isConditionalJumpOpCode(opCode) ? 3 : 1;
+        }
+    }
+
+    //只替换序列的第一个操作码 后续指令保持原样 超级指令执行时从字节码中读取它们的操作数
+    //所有指令的pc不变 异常表 行号表 跳转目标(包括跳到序列中间)都不受影响
+    std::unique_ptr<u1[]> createSuperInstructionCode(const u1 *code, const u4 codeLength) {
+        const auto opCodeAt = [code, codeLength](const u4 pc) {
+            //越界时返回NOP 不会匹配任何序列
+            return pc < codeLength ? static_cast<OpCodeEnum>(code[pc]) : OpCodeEnum::NOP;
+        };
+        const auto nextPcOf = [code, codeLength](const u4 pc) {
+            return pc < codeLength ? pc + getOpCodeLength(code, pc) : codeLength;
+        };
+        const auto isILoad = [](const OpCodeEnum opCode) {
+            return opCode == OpCodeEnum::ILOAD || (opCode >= OpCodeEnum::ILOAD_0 && opCode <= OpCodeEnum::ILOAD_3);
+        };
+
+        std::unique_ptr<u1[]> superCode;
+        for (u4 pc = 0; pc < codeLength; pc = nextPcOf(pc)) {
+            const auto opCode = opCodeAt(pc);
+            const auto nextPc = nextPcOf(pc);
+            const auto next = opCodeAt(nextPc);
+            auto superOpCode = opCode;
+            switch (opCode) {
+                case OpCodeEnum::ALOAD_0:
+                    if (next == OpCodeEnum::GETFIELD) {
+                        superOpCode = OpCodeEnum::SUPER_ALOAD_0_GETFIELD;
+                    } else if (next == OpCodeEnum::INVOKESPECIAL) {
+                        superOpCode = OpCodeEnum::SUPER_ALOAD_0_INVOKESPECIAL;
+                    } else if (next == OpCodeEnum::ARRAYLENGTH) {
+                        superOpCode = OpCodeEnum::SUPER_ALOAD_0_ARRAYLENGTH;
+                    }
+                    break;
+
+                case OpCodeEnum::ALOAD_1:
+                case OpCodeEnum::ALOAD_2:
+                case OpCodeEnum::ALOAD_3:
+                    if (next == OpCodeEnum::ARRAYLENGTH) {
+                        superOpCode = static_cast<OpCodeEnum>(
+                            CAST_U1(OpCodeEnum::SUPER_ALOAD_0_ARRAYLENGTH) + CAST_U1(opCode) - CAST_U1(OpCodeEnum::ALOAD_0)
+                        );
+                    }
+                    break;
+
+                case OpCodeEnum::ALOAD:
+                    if (next == OpCodeEnum::ARRAYLENGTH) {
+                        superOpCode = OpCodeEnum::SUPER_ALOAD_ARRAYLENGTH;
+                    }
+                    break;
+
+                case OpCodeEnum::ILOAD:
+                case OpCodeEnum::ILOAD_0:
+                case OpCodeEnum::ILOAD_1:
+                case OpCodeEnum::ILOAD_2:
+                case OpCodeEnum::ILOAD_3:
+                    if (isILoad(next) && opCodeAt(nextPcOf(nextPc)) == OpCodeEnum::IF_ICMPGE) {
+                        superOpCode =
+                            opCode == OpCodeEnum::ILOAD
+                                ? OpCodeEnum::SUPER_ILOAD_ILOAD_IF_ICMPGE
+                                : static_cast<OpCodeEnum>(
+                                    CAST_U1(OpCodeEnum::SUPER_ILOAD_0_ILOAD_IF_ICMPGE) + CAST_U1(opCode) - CAST_U1(OpCodeEnum::ILOAD_0)
+                                );
+                    }
+                    break;
+
+                case OpCodeEnum::IINC:
+                    if (next == OpCodeEnum::GOTO) {
+                        superOpCode = OpCodeEnum::SUPER_IINC_GOTO;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            if (superOpCode != opCode) {
+                if (superCode == nullptr) {
+                    superCode = std::make_unique<u1[]>(codeLength);
+                    std::copy_n(code, codeLength, superCode.get());
+                }
+                superCode[pc] = CAST_U1(superOpCode);
+            }
+        }
+        return superCode;
+    }
+
 }
@@ -3,6 +3,7 @@
 
 #include "basic.hpp"
 #include <array>
+#include <memory>
 
 namespace RexVM {
     enum class OpCodeEnum : u1 {
@@ -234,6 +235,20 @@ namespace RexVM {
         INVOKEVIRTUAL_QUICK_W = 226,
         GETFIELD_QUICK_W = 227,
         PUTFIELD_QUICK_W = 228,
+        //解释器内部的超级指令 只出现在Method::superInstructionCode中 替换常见指令序列的第一个操作码
+        SUPER_ALOAD_0_GETFIELD = 229,
+        SUPER_ALOAD_0_INVOKESPECIAL = 230,
+        SUPER_ILOAD_ILOAD_IF_ICMPGE = 231,
+        SUPER_ILOAD_0_ILOAD_IF_ICMPGE = 232,
+        SUPER_ILOAD_1_ILOAD_IF_ICMPGE = 233,
+        SUPER_ILOAD_2_ILOAD_IF_ICMPGE = 234,
+        SUPER_ILOAD_3_ILOAD_IF_ICMPGE = 235,
+        SUPER_ALOAD_ARRAYLENGTH = 236,
+        SUPER_ALOAD_0_ARRAYLENGTH = 237,
+        SUPER_ALOAD_1_ARRAYLENGTH = 238,
+        SUPER_ALOAD_2_ARRAYLENGTH = 239,
+        SUPER_ALOAD_3_ARRAYLENGTH = 240,
+        SUPER_IINC_GOTO = 241,
         IMPDEP1 = 254,
         IMPDEP2 = 255,
     };
@@ -244,6 +259,12 @@ namespace RexVM {
     bool isJumpOpCode(OpCodeEnum opCode);
     bool isReturnOpCode(OpCodeEnum opCode);
     bool isEndOpCode(OpCodeEnum opCode);
+    bool isConditionalJumpOpCode(OpCodeEnum opCode);
+    //指令总长度(包含操作码本身) switch指令需要按pc计算对齐
+    u4 getOpCodeLength(const u1 *code, u4 pc);
+
+    //识别常见的指令序列 返回第一个操作码替换成超级指令后的字节码副本 没有可替换的序列时返回nullptr
+    std::unique_ptr<u1[]> createSuperInstructionCode(const u1 *code, u4 codeLength);
 }
 
 #endif
\ No newline at end of file
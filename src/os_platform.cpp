@@ -6,6 +6,12 @@
 #else
 #include <unistd.h>
 #include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
 #endif
 
 
@@ -65,4 +71,94 @@ namespace RexVM {
 #endif
     }
 
+    std::size_t getProcessId() {
+#if defined(_MSC_VER)
+        return static_cast<std::size_t>(GetCurrentProcessId());
+#else
+        return static_cast<std::size_t>(getpid());
+#endif
+    }
+
+    std::string getExecutablePath() {
+#if defined(_MSC_VER)
+        std::array<char, MAX_PATH> buffer{};
+        const auto length = GetModuleFileNameA(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()));
+        return length == 0 || length >= buffer.size() ? std::string{} : std::string(buffer.data(), length);
+#elif defined(__APPLE__)
+        std::array<char, 4096> buffer{};
+        auto size = static_cast<uint32_t>(buffer.size());
+        return _NSGetExecutablePath(buffer.data(), &size) == 0 ? std::string(buffer.data()) : std::string{};
+#else
+        std::array<char, 4096> buffer{};
+        const auto length = readlink("/proc/self/exe", buffer.data(), buffer.size());
+        return length <= 0 || static_cast<std::size_t>(length) >= buffer.size() ? std::string{} : std::string(buffer.data(), length);
+#endif
+    }
+
+    MappedFile mapFileReadOnly(const char *path) {
+        MappedFile file{};
+
+#if defined(_MSC_VER)
+        const auto fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            return file;
+        }
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(fileHandle);
+            return file;
+        }
+        const auto mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        //映射对象持有文件的引用 文件句柄可以直接关闭
+        CloseHandle(fileHandle);
+        if (mappingHandle == nullptr) {
+            return file;
+        }
+        const auto data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            CloseHandle(mappingHandle);
+            return file;
+        }
+        file.data = data;
+        file.size = static_cast<std::size_t>(fileSize.QuadPart);
+        file.handle = mappingHandle;
+#else
+        const auto fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return file;
+        }
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+            close(fd);
+            return file;
+        }
+        const auto size = static_cast<std::size_t>(fileStat.st_size);
+        const auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        //mmap之后关闭fd不影响映射
+        close(fd);
+        if (data == MAP_FAILED) {
+            return file;
+        }
+        file.data = data;
+        file.size = size;
+#endif
+
+        return file;
+    }
+
+    void unmapFile(MappedFile &file) {
+        if (file.data == nullptr) {
+            return;
+        }
+
+#if defined(_MSC_VER)
+        UnmapViewOfFile(file.data);
+        CloseHandle(file.handle);
+#else
+        munmap(const_cast<void *>(file.data), file.size);
+#endif
+
+        file = MappedFile{};
+    }
+
 }
\ No newline at end of file
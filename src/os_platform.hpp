@@ -26,11 +26,24 @@
 #endif
 
 #include <string>
+#include <cstddef>
 
 namespace RexVM {
+    //只读映射的文件 data为nullptr表示映射失败
+    struct MappedFile {
+        const void *data{nullptr};
+        std::size_t size{0};
+        void *handle{nullptr};
+    };
+
     std::size_t getSystemPageSize();
     std::string getSystemTimeZoneId();
     void setThreadName(const char *name);
+    std::size_t getProcessId();
+    //当前进程的可执行文件 取不到时为空
+    std::string getExecutablePath();
+    MappedFile mapFileReadOnly(const char *path);
+    void unmapFile(MappedFile &file);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,897 @@
+#include "register_code.hpp"
+#include <functional>
+#include "interpreter_op.hpp"
+#include "opcode.hpp"
+#include "cfg.hpp"
+#include "frame.hpp"
+#include "class_member.hpp"
+#include "oop.hpp"
+#include "method_profile.hpp"
+#include "exception_helper.hpp"
+#include "utils/byte_reader.hpp"
+
+namespace RexVM {
+
+    namespace RegisterOp {
+
+        template<typename T>
+        inline T readRegister(const Frame &frame, const u2 reg) {
+            return StackValue<T>::get(frame.localVariableTable[reg]);
+        }
+
+        //写入值和类型标记 宽类型的第二个槽位和lstore/dstore一样写0 gc按类型标记扫描lvt
+        template<typename T>
+        inline void writeRegister(const Frame &frame, const u2 reg, const T val) {
+            using V = StackValue<T>;
+            frame.localVariableTable[reg] = Slot(val);
+            frame.localVariableTableType[reg] = V::type;
+            if constexpr (V::size == 2) {
+                frame.localVariableTable[reg + 1] = ZERO_SLOT;
+                frame.localVariableTableType[reg + 1] = V::type;
+            }
+        }
+
+        //抛出异常时的pc是原始字节码的pc 由handleThrowValue查找异常表 有catch时在栈解释器中继续执行
+        inline u4 throwAt(Frame &frame, const RegisterInstruction &instruction, void (*thrower)(Frame &)) {
+            frame.pcCode = instruction.pc;
+            thrower(frame);
+            return REGISTER_CODE_EXIT;
+        }
+
+        inline u4 jumpIf(Frame &frame, const RegisterInstruction &instruction, const u4 index, const bool jump) {
+            if (const auto profile = frame.profile; profile != nullptr) [[unlikely]] {
+                profile->getBranchProfile(instruction.pc)->record(jump);
+            }
+            return jump ? CAST_U4(instruction.operand.i4Val) : index + 1;
+        }
+
+        template<typename T>
+        u4 move(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            writeRegister<T>(frame, instruction.dst, readRegister<T>(frame, instruction.src1));
+            return index + 1;
+        }
+
+        template<typename T>
+        u4 constant(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            writeRegister<T>(frame, instruction.dst, StackValue<T>::get(instruction.operand));
+            return index + 1;
+        }
+
+        u4 iinc(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            auto &slot = frame.localVariableTable[instruction.dst];
+            slot = Slot(AddOp{}(slot.i4Val, instruction.operand.i4Val));
+            return index + 1;
+        }
+
+        template<typename T, typename Op>
+        u4 binary(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto val1 = readRegister<T>(frame, instruction.src1);
+            const auto val2 = readRegister<T>(frame, instruction.src2);
+            writeRegister<T>(frame, instruction.dst, static_cast<T>(Op{}(val1, val2)));
+            return index + 1;
+        }
+
+        template<typename T, bool remainder>
+        u4 integerDivide(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto val1 = readRegister<T>(frame, instruction.src1);
+            const auto val2 = readRegister<T>(frame, instruction.src2);
+            if (val2 == 0) [[unlikely]] {
+                return throwAt(frame, instruction, throwArithmeticExceptionDivByZero);
+            }
+            writeRegister<T>(frame, instruction.dst, integerDivideValue<T, remainder>(val1, val2));
+            return index + 1;
+        }
+
+        template<typename T>
+        u4 negate(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto val = readRegister<T>(frame, instruction.src1);
+            if constexpr (std::is_integral_v<T>) {
+                writeRegister<T>(frame, instruction.dst, static_cast<T>(0 - static_cast<std::make_unsigned_t<T>>(val)));
+            } else {
+                writeRegister<T>(frame, instruction.dst, -val);
+            }
+            return index + 1;
+        }
+
+        template<typename T, typename Op>
+        u4 shift(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto s = CAST_U4(readRegister<i4>(frame, instruction.src2)) & (sizeof(T) * 8 - 1);
+            writeRegister<T>(frame, instruction.dst, Op{}(readRegister<T>(frame, instruction.src1), s));
+            return index + 1;
+        }
+
+        template<typename From, typename To>
+        u4 convert(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            writeRegister<To>(frame, instruction.dst, static_cast<To>(readRegister<From>(frame, instruction.src1)));
+            return index + 1;
+        }
+
+        template<typename Narrow>
+        u4 narrow(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            writeRegister<i4>(frame, instruction.dst, CAST_I4(static_cast<Narrow>(readRegister<i4>(frame, instruction.src1))));
+            return index + 1;
+        }
+
+        template<typename T, i4 nanResult>
+        u4 compare(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto val1 = readRegister<T>(frame, instruction.src1);
+            const auto val2 = readRegister<T>(frame, instruction.src2);
+            writeRegister<i4>(frame, instruction.dst, compareValue<T, nanResult>(val1, val2));
+            return index + 1;
+        }
+
+        template<typename T, typename Cmp>
+        u4 ifZero(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            return jumpIf(frame, instruction, index, Cmp{}(readRegister<T>(frame, instruction.src1), T{}));
+        }
+
+        template<typename T, typename Cmp>
+        u4 ifCompare(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto val1 = readRegister<T>(frame, instruction.src1);
+            const auto val2 = readRegister<T>(frame, instruction.src2);
+            return jumpIf(frame, instruction, index, Cmp{}(val1, val2));
+        }
+
+        u4 goto_(Frame &frame, const RegisterInstruction &instruction, [[maybe_unused]] const u4 index) {
+            //块边界上没有临时寄存器中的值 gc只需要扫描lvt
+            frame.mem.safePoint();
+            return CAST_U4(instruction.operand.i4Val);
+        }
+
+        u4 arraylength(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto array = CAST_ARRAY_OOP(readRegister<ref>(frame, instruction.src1));
+            if (array == nullptr) [[unlikely]] {
+                return throwAt(frame, instruction, throwNullPointException);
+            }
+            writeRegister<i4>(frame, instruction.dst, CAST_I4(array->getDataLength()));
+            return index + 1;
+        }
+
+        template<typename ArrayOopType, typename T>
+        u4 arrayLoad(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto array = static_cast<ArrayOopType *>(readRegister<ref>(frame, instruction.src1));
+            if (array == nullptr) [[unlikely]] {
+                return throwAt(frame, instruction, throwNullPointException);
+            }
+            writeRegister<T>(frame, instruction.dst, static_cast<T>(array->data[readRegister<i4>(frame, instruction.src2)]));
+            return index + 1;
+        }
+
+        template<typename ArrayOopType, typename T>
+        u4 arrayStore(Frame &frame, const RegisterInstruction &instruction, const u4 index) {
+            const auto array = static_cast<ArrayOopType *>(readRegister<ref>(frame, instruction.src1));
+            if (array == nullptr) [[unlikely]] {
+                return throwAt(frame, instruction, throwNullPointException);
+            }
+            using ElementType = std::remove_reference_t<decltype(array->data[0])>;
+            array->data[readRegister<i4>(frame, instruction.src2)] =
+                static_cast<ElementType>(readRegister<T>(frame, instruction.dst));
+            return index + 1;
+        }
+
+        template<typename T>
+        u4 returnValue(Frame &frame, const RegisterInstruction &instruction, [[maybe_unused]] const u4 index) {
+            frame.returnSlot(Slot(readRegister<T>(frame, instruction.src1)), StackValue<T>::type);
+            return REGISTER_CODE_EXIT;
+        }
+
+        u4 returnVoid(Frame &frame, [[maybe_unused]] const RegisterInstruction &instruction, [[maybe_unused]] const u4 index) {
+            frame.returnVoid();
+            return REGISTER_CODE_EXIT;
+        }
+
+        //不支持的块 回到栈解释器从块的起始pc继续执行 此时操作数栈为空
+        u4 fallback(Frame &frame, const RegisterInstruction &instruction, [[maybe_unused]] const u4 index) {
+            frame.reader.gotoOffset(CAST_I4(instruction.pc));
+            return REGISTER_CODE_EXIT;
+        }
+
+        RegisterHandler moveHandler(const SlotTypeEnum type) {
+            switch (type) {
+                case SlotTypeEnum::I4:
+                    return move<i4>;
+                case SlotTypeEnum::I8:
+                    return move<i8>;
+                case SlotTypeEnum::F4:
+                    return move<f4>;
+                case SlotTypeEnum::F8:
+                    return move<f8>;
+                default:
+                    return move<ref>;
+            }
+        }
+
+    }
+
+    //翻译时模拟的操作数栈项 reg小于maxLocals时是还没有读取的局部变量 运算时直接使用局部变量的寄存器
+    struct RegisterStackEntry {
+        u2 reg;
+        u2 position; //在操作数栈中的槽位 需要把值放进临时寄存器时使用maxLocals + position
+        SlotTypeEnum type;
+    };
+
+    struct RegisterTranslator {
+        const Method &method;
+        const u2 maxLocals;
+        ByteReader reader{};
+
+        std::vector<RegisterInstruction> instructions;
+        std::vector<size_t> branches; //operand中暂存跳转目标pc的指令 翻译完成后改成指令下标
+        std::vector<u4> blockIndex; //块的起始pc对应的指令下标
+
+        std::vector<RegisterStackEntry> stack;
+        u2 depth{0};
+        size_t lastValueIndex{std::numeric_limits<size_t>::max()}; //最后一条写临时寄存器的指令
+        u4 pc{0};
+        bool underflow{false}; //块开始时栈中的值在其他块 只能由栈解释器执行
+        bool stackShapeError{false}; //块边界上操作数栈不为空(比如三元表达式) 整个方法不翻译
+
+        explicit RegisterTranslator(const Method &method) :
+            method(method),
+            maxLocals(method.maxLocals),
+            blockIndex(method.codeLength, REGISTER_CODE_EXIT) {
+            reader.init(method.code, method.codeLength);
+        }
+
+        size_t emit(const RegisterHandler handler, const u2 dst, const u2 src1 = 0, const u2 src2 = 0, const Slot operand = {}) {
+            instructions.emplace_back(RegisterInstruction{handler, dst, src1, src2, pc, operand});
+            return instructions.size() - 1;
+        }
+
+        void emitValue(const RegisterHandler handler, const u2 dst, const u2 src1 = 0, const u2 src2 = 0, const Slot operand = {}) {
+            lastValueIndex = emit(handler, dst, src1, src2, operand);
+        }
+
+        void emitBranch(const RegisterHandler handler, const u2 src1, const u2 src2, const i4 offset) {
+            if (!stack.empty()) {
+                stackShapeError = true;
+            }
+            branches.emplace_back(emit(handler, 0, src1, src2, Slot(CAST_I4(pc) + offset)));
+        }
+
+        void pushLocal(const u2 reg, const SlotTypeEnum type) {
+            stack.emplace_back(RegisterStackEntry{reg, depth, type});
+            depth += isWideSlotType(type) ? 2 : 1;
+        }
+
+        u2 pushTemp(const SlotTypeEnum type) {
+            const auto reg = CAST_U2(maxLocals + depth);
+            pushLocal(reg, type);
+            return reg;
+        }
+
+        RegisterStackEntry pop() {
+            if (stack.empty()) {
+                underflow = true;
+                return RegisterStackEntry{maxLocals, 0, SlotTypeEnum::I4};
+            }
+            const auto entry = stack.back();
+            stack.pop_back();
+            depth = entry.position;
+            return entry;
+        }
+
+        //写局部变量之前 栈中还引用这个局部变量的项先复制到临时寄存器
+        void materialize(const u2 reg, const u2 size) {
+            for (auto &entry : stack) {
+                const auto entrySize = isWideSlotType(entry.type) ? 2 : 1;
+                if (entry.reg < reg + size && reg < entry.reg + entrySize) {
+                    const auto temp = CAST_U2(maxLocals + entry.position);
+                    emit(RegisterOp::moveHandler(entry.type), temp, entry.reg);
+                    entry.reg = temp;
+                }
+            }
+        }
+
+        template<typename T>
+        void constant(const T value) {
+            emitValue(RegisterOp::constant<T>, pushTemp(StackValue<T>::type), 0, 0, Slot(value));
+        }
+
+        template<typename T>
+        void load(const u2 index) {
+            pushLocal(index, StackValue<T>::type);
+        }
+
+        template<typename T>
+        void store(const u2 index) {
+            materialize(index, StackValue<T>::size);
+            const auto entry = pop();
+            //值刚由上一条指令写入临时寄存器 直接改成写入局部变量
+            if (entry.reg >= maxLocals
+                && !instructions.empty()
+                && lastValueIndex == instructions.size() - 1
+                && instructions.back().dst == entry.reg) {
+                instructions.back().dst = index;
+            } else {
+                emit(RegisterOp::move<T>, index, entry.reg);
+            }
+            lastValueIndex = std::numeric_limits<size_t>::max();
+        }
+
+        //T是结果的类型
+        template<typename T>
+        void binary(const RegisterHandler handler) {
+            const auto val2 = pop();
+            const auto val1 = pop();
+            emitValue(handler, pushTemp(StackValue<T>::type), val1.reg, val2.reg);
+        }
+
+        template<typename T>
+        void unary(const RegisterHandler handler) {
+            const auto val = pop();
+            emitValue(handler, pushTemp(StackValue<T>::type), val.reg);
+        }
+
+        template<typename ArrayOopType, typename T>
+        void arrayLoad() {
+            const auto arrayIndex = pop();
+            const auto array = pop();
+            emitValue(RegisterOp::arrayLoad<ArrayOopType, T>, pushTemp(StackValue<T>::type), array.reg, arrayIndex.reg);
+        }
+
+        template<typename ArrayOopType, typename T>
+        void arrayStore() {
+            const auto value = pop();
+            const auto arrayIndex = pop();
+            const auto array = pop();
+            emit(RegisterOp::arrayStore<ArrayOopType, T>, value.reg, array.reg, arrayIndex.reg);
+        }
+
+        template<typename T, typename Cmp>
+        void ifZero() {
+            const auto val = pop();
+            const auto offset = reader.readI2();
+            emitBranch(RegisterOp::ifZero<T, Cmp>, val.reg, 0, offset);
+        }
+
+        template<typename T, typename Cmp>
+        void ifCompare() {
+            const auto val2 = pop();
+            const auto val1 = pop();
+            const auto offset = reader.readI2();
+            emitBranch(RegisterOp::ifCompare<T, Cmp>, val1.reg, val2.reg, offset);
+        }
+
+        void jump(const i4 offset) {
+            emitBranch(RegisterOp::goto_, 0, 0, offset);
+            stack.clear();
+            depth = 0;
+        }
+
+        template<typename T>
+        void returnValue() {
+            emit(RegisterOp::returnValue<T>, 0, pop().reg);
+            stack.clear();
+            depth = 0;
+        }
+
+        //返回false表示块中有不支持的指令
+        bool translateInstruction(const OpCodeEnum opCode);
+
+        bool translateBlock(const MethodBlock &block) {
+            reader.gotoOffset(CAST_I4(block.startPC));
+            while (CAST_U4(reader.ptr - reader.begin) < block.endPC) {
+                pc = CAST_U4(reader.ptr - reader.begin);
+                if (!translateInstruction(static_cast<OpCodeEnum>(reader.readU1())) || underflow) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::unique_ptr<RegisterCode> translate() {
+            const MethodCFG cfg(method);
+            for (const auto &block : cfg.blocks) {
+                if (!stack.empty()) {
+                    //上一个块带着操作数栈中的值进入这个块
+                    return nullptr;
+                }
+                const auto firstIndex = instructions.size();
+                const auto branchCount = branches.size();
+                blockIndex[block->startPC] = CAST_U4(firstIndex);
+                lastValueIndex = std::numeric_limits<size_t>::max();
+                underflow = false;
+                //异常处理块开始时栈中有异常对象 由栈解释器执行
+                if (block->exceptionHandlerBlock || !translateBlock(*block)) {
+                    instructions.resize(firstIndex);
+                    branches.resize(branchCount);
+                    stack.clear();
+                    depth = 0;
+                    pc = block->startPC;
+                    emit(RegisterOp::fallback, 0);
+                }
+                if (stackShapeError) {
+                    return nullptr;
+                }
+            }
+            if (instructions.empty() || instructions.front().handler == RegisterOp::fallback) {
+                return nullptr;
+            }
+
+            for (const auto index : branches) {
+                auto &operand = instructions[index].operand;
+                operand = Slot(CAST_I4(blockIndex[CAST_U4(operand.i4Val)]));
+            }
+            auto code = std::make_unique<RegisterCode>();
+            code->instructions = std::move(instructions);
+            return code;
+        }
+    };
+
+    bool RegisterTranslator::translateInstruction(const OpCodeEnum opCode) {
+        using namespace RegisterOp;
+        switch (opCode) {
+            case OpCodeEnum::NOP:
+                break;
+
+            case OpCodeEnum::ACONST_NULL:
+                constant<ref>(nullptr);
+                break;
+            case OpCodeEnum::ICONST_M1:
+            case OpCodeEnum::ICONST_0:
+            case OpCodeEnum::ICONST_1:
+            case OpCodeEnum::ICONST_2:
+            case OpCodeEnum::ICONST_3:
+            case OpCodeEnum::ICONST_4:
+            case OpCodeEnum::ICONST_5:
+                constant<i4>(CAST_I4(opCode) - CAST_I4(OpCodeEnum::ICONST_0));
+                break;
+            case OpCodeEnum::LCONST_0:
+            case OpCodeEnum::LCONST_1:
+                constant<i8>(CAST_I8(opCode) - CAST_I8(OpCodeEnum::LCONST_0));
+                break;
+            case OpCodeEnum::FCONST_0:
+            case OpCodeEnum::FCONST_1:
+            case OpCodeEnum::FCONST_2:
+                constant<f4>(static_cast<f4>(CAST_I4(opCode) - CAST_I4(OpCodeEnum::FCONST_0)));
+                break;
+            case OpCodeEnum::DCONST_0:
+            case OpCodeEnum::DCONST_1:
+                constant<f8>(static_cast<f8>(CAST_I4(opCode) - CAST_I4(OpCodeEnum::DCONST_0)));
+                break;
+            case OpCodeEnum::BIPUSH:
+                constant<i4>(reader.readI1());
+                break;
+            case OpCodeEnum::SIPUSH:
+                constant<i4>(reader.readI2());
+                break;
+
+            case OpCodeEnum::ILOAD:
+                load<i4>(reader.readU1());
+                break;
+            case OpCodeEnum::LLOAD:
+                load<i8>(reader.readU1());
+                break;
+            case OpCodeEnum::FLOAD:
+                load<f4>(reader.readU1());
+                break;
+            case OpCodeEnum::DLOAD:
+                load<f8>(reader.readU1());
+                break;
+            case OpCodeEnum::ALOAD:
+                load<ref>(reader.readU1());
+                break;
+            case OpCodeEnum::ILOAD_0:
+            case OpCodeEnum::ILOAD_1:
+            case OpCodeEnum::ILOAD_2:
+            case OpCodeEnum::ILOAD_3:
+                load<i4>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::ILOAD_0)));
+                break;
+            case OpCodeEnum::LLOAD_0:
+            case OpCodeEnum::LLOAD_1:
+            case OpCodeEnum::LLOAD_2:
+            case OpCodeEnum::LLOAD_3:
+                load<i8>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::LLOAD_0)));
+                break;
+            case OpCodeEnum::FLOAD_0:
+            case OpCodeEnum::FLOAD_1:
+            case OpCodeEnum::FLOAD_2:
+            case OpCodeEnum::FLOAD_3:
+                load<f4>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::FLOAD_0)));
+                break;
+            case OpCodeEnum::DLOAD_0:
+            case OpCodeEnum::DLOAD_1:
+            case OpCodeEnum::DLOAD_2:
+            case OpCodeEnum::DLOAD_3:
+                load<f8>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::DLOAD_0)));
+                break;
+            case OpCodeEnum::ALOAD_0:
+            case OpCodeEnum::ALOAD_1:
+            case OpCodeEnum::ALOAD_2:
+            case OpCodeEnum::ALOAD_3:
+                load<ref>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::ALOAD_0)));
+                break;
+
+            case OpCodeEnum::IALOAD:
+                arrayLoad<IntTypeArrayOop, i4>();
+                break;
+            case OpCodeEnum::LALOAD:
+                arrayLoad<LongTypeArrayOop, i8>();
+                break;
+            case OpCodeEnum::FALOAD:
+                arrayLoad<FloatTypeArrayOop, f4>();
+                break;
+            case OpCodeEnum::DALOAD:
+                arrayLoad<DoubleTypeArrayOop, f8>();
+                break;
+            case OpCodeEnum::AALOAD:
+                arrayLoad<ObjArrayOop, ref>();
+                break;
+            case OpCodeEnum::BALOAD:
+                arrayLoad<ByteTypeArrayOop, i4>();
+                break;
+            case OpCodeEnum::CALOAD:
+                arrayLoad<CharTypeArrayOop, i4>();
+                break;
+            case OpCodeEnum::SALOAD:
+                arrayLoad<ShortTypeArrayOop, i4>();
+                break;
+
+            case OpCodeEnum::ISTORE:
+                store<i4>(reader.readU1());
+                break;
+            case OpCodeEnum::LSTORE:
+                store<i8>(reader.readU1());
+                break;
+            case OpCodeEnum::FSTORE:
+                store<f4>(reader.readU1());
+                break;
+            case OpCodeEnum::DSTORE:
+                store<f8>(reader.readU1());
+                break;
+            case OpCodeEnum::ASTORE:
+                store<ref>(reader.readU1());
+                break;
+            case OpCodeEnum::ISTORE_0:
+            case OpCodeEnum::ISTORE_1:
+            case OpCodeEnum::ISTORE_2:
+            case OpCodeEnum::ISTORE_3:
+                store<i4>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::ISTORE_0)));
+                break;
+            case OpCodeEnum::LSTORE_0:
+            case OpCodeEnum::LSTORE_1:
+            case OpCodeEnum::LSTORE_2:
+            case OpCodeEnum::LSTORE_3:
+                store<i8>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::LSTORE_0)));
+                break;
+            case OpCodeEnum::FSTORE_0:
+            case OpCodeEnum::FSTORE_1:
+            case OpCodeEnum::FSTORE_2:
+            case OpCodeEnum::FSTORE_3:
+                store<f4>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::FSTORE_0)));
+                break;
+            case OpCodeEnum::DSTORE_0:
+            case OpCodeEnum::DSTORE_1:
+            case OpCodeEnum::DSTORE_2:
+            case OpCodeEnum::DSTORE_3:
+                store<f8>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::DSTORE_0)));
+                break;
+            case OpCodeEnum::ASTORE_0:
+            case OpCodeEnum::ASTORE_1:
+            case OpCodeEnum::ASTORE_2:
+            case OpCodeEnum::ASTORE_3:
+                store<ref>(CAST_U2(CAST_U1(opCode) - CAST_U1(OpCodeEnum::ASTORE_0)));
+                break;
+
+            //aastore需要检查元素类型 由栈解释器执行
+            case OpCodeEnum::IASTORE:
+                arrayStore<IntTypeArrayOop, i4>();
+                break;
+            case OpCodeEnum::LASTORE:
+                arrayStore<LongTypeArrayOop, i8>();
+                break;
+            case OpCodeEnum::FASTORE:
+                arrayStore<FloatTypeArrayOop, f4>();
+                break;
+            case OpCodeEnum::DASTORE:
+                arrayStore<DoubleTypeArrayOop, f8>();
+                break;
+            case OpCodeEnum::BASTORE:
+                arrayStore<ByteTypeArrayOop, i4>();
+                break;
+            case OpCodeEnum::CASTORE:
+                arrayStore<CharTypeArrayOop, i4>();
+                break;
+            case OpCodeEnum::SASTORE:
+                arrayStore<ShortTypeArrayOop, i4>();
+                break;
+
+            case OpCodeEnum::POP:
+                pop();
+                break;
+            case OpCodeEnum::POP2:
+                if (!isWideSlotType(pop().type)) {
+                    pop();
+                }
+                break;
+            case OpCodeEnum::DUP: {
+                const auto entry = pop();
+                pushLocal(entry.reg, entry.type);
+                if (entry.reg < maxLocals) {
+                    pushLocal(entry.reg, entry.type);
+                } else {
+                    emit(moveHandler(entry.type), pushTemp(entry.type), entry.reg);
+                }
+                break;
+            }
+
+            case OpCodeEnum::IADD:
+                binary<i4>(RegisterOp::binary<i4, AddOp>);
+                break;
+            case OpCodeEnum::LADD:
+                binary<i8>(RegisterOp::binary<i8, AddOp>);
+                break;
+            case OpCodeEnum::FADD:
+                binary<f4>(RegisterOp::binary<f4, AddOp>);
+                break;
+            case OpCodeEnum::DADD:
+                binary<f8>(RegisterOp::binary<f8, AddOp>);
+                break;
+            case OpCodeEnum::ISUB:
+                binary<i4>(RegisterOp::binary<i4, SubOp>);
+                break;
+            case OpCodeEnum::LSUB:
+                binary<i8>(RegisterOp::binary<i8, SubOp>);
+                break;
+            case OpCodeEnum::FSUB:
+                binary<f4>(RegisterOp::binary<f4, SubOp>);
+                break;
+            case OpCodeEnum::DSUB:
+                binary<f8>(RegisterOp::binary<f8, SubOp>);
+                break;
+            case OpCodeEnum::IMUL:
+                binary<i4>(RegisterOp::binary<i4, MulOp>);
+                break;
+            case OpCodeEnum::LMUL:
+                binary<i8>(RegisterOp::binary<i8, MulOp>);
+                break;
+            case OpCodeEnum::FMUL:
+                binary<f4>(RegisterOp::binary<f4, MulOp>);
+                break;
+            case OpCodeEnum::DMUL:
+                binary<f8>(RegisterOp::binary<f8, MulOp>);
+                break;
+            case OpCodeEnum::IDIV:
+                binary<i4>(integerDivide<i4, false>);
+                break;
+            case OpCodeEnum::LDIV:
+                binary<i8>(integerDivide<i8, false>);
+                break;
+            case OpCodeEnum::FDIV:
+                binary<f4>(RegisterOp::binary<f4, std::divides<>>);
+                break;
+            case OpCodeEnum::DDIV:
+                binary<f8>(RegisterOp::binary<f8, std::divides<>>);
+                break;
+            case OpCodeEnum::IREM:
+                binary<i4>(integerDivide<i4, true>);
+                break;
+            case OpCodeEnum::LREM:
+                binary<i8>(integerDivide<i8, true>);
+                break;
+            case OpCodeEnum::FREM:
+                binary<f4>(RegisterOp::binary<f4, FRemOp>);
+                break;
+            case OpCodeEnum::DREM:
+                binary<f8>(RegisterOp::binary<f8, FRemOp>);
+                break;
+            case OpCodeEnum::INEG:
+                unary<i4>(negate<i4>);
+                break;
+            case OpCodeEnum::LNEG:
+                unary<i8>(negate<i8>);
+                break;
+            case OpCodeEnum::FNEG:
+                unary<f4>(negate<f4>);
+                break;
+            case OpCodeEnum::DNEG:
+                unary<f8>(negate<f8>);
+                break;
+            case OpCodeEnum::ISHL:
+                binary<i4>(shift<i4, ShlOp>);
+                break;
+            case OpCodeEnum::LSHL:
+                binary<i8>(shift<i8, ShlOp>);
+                break;
+            case OpCodeEnum::ISHR:
+                binary<i4>(shift<i4, ShrOp>);
+                break;
+            case OpCodeEnum::LSHR:
+                binary<i8>(shift<i8, ShrOp>);
+                break;
+            case OpCodeEnum::IUSHR:
+                binary<i4>(shift<i4, UShrOp>);
+                break;
+            case OpCodeEnum::LUSHR:
+                binary<i8>(shift<i8, UShrOp>);
+                break;
+            case OpCodeEnum::IAND:
+                binary<i4>(RegisterOp::binary<i4, std::bit_and<>>);
+                break;
+            case OpCodeEnum::LAND:
+                binary<i8>(RegisterOp::binary<i8, std::bit_and<>>);
+                break;
+            case OpCodeEnum::IOR:
+                binary<i4>(RegisterOp::binary<i4, std::bit_or<>>);
+                break;
+            case OpCodeEnum::LOR:
+                binary<i8>(RegisterOp::binary<i8, std::bit_or<>>);
+                break;
+            case OpCodeEnum::IXOR:
+                binary<i4>(RegisterOp::binary<i4, std::bit_xor<>>);
+                break;
+            case OpCodeEnum::LXOR:
+                binary<i8>(RegisterOp::binary<i8, std::bit_xor<>>);
+                break;
+
+            case OpCodeEnum::IINC: {
+                const auto index = reader.readU1();
+                const auto value = reader.readI1();
+                materialize(index, 1);
+                emit(iinc, index, 0, 0, Slot(CAST_I4(value)));
+                break;
+            }
+
+            case OpCodeEnum::I2L:
+                unary<i8>(convert<i4, i8>);
+                break;
+            case OpCodeEnum::I2F:
+                unary<f4>(convert<i4, f4>);
+                break;
+            case OpCodeEnum::I2D:
+                unary<f8>(convert<i4, f8>);
+                break;
+            case OpCodeEnum::L2I:
+                unary<i4>(convert<i8, i4>);
+                break;
+            case OpCodeEnum::L2F:
+                unary<f4>(convert<i8, f4>);
+                break;
+            case OpCodeEnum::L2D:
+                unary<f8>(convert<i8, f8>);
+                break;
+            case OpCodeEnum::F2I:
+                unary<i4>(convert<f4, i4>);
+                break;
+            case OpCodeEnum::F2L:
+                unary<i8>(convert<f4, i8>);
+                break;
+            case OpCodeEnum::F2D:
+                unary<f8>(convert<f4, f8>);
+                break;
+            case OpCodeEnum::D2I:
+                unary<i4>(convert<f8, i4>);
+                break;
+            case OpCodeEnum::D2L:
+                unary<i8>(convert<f8, i8>);
+                break;
+            case OpCodeEnum::D2F:
+                unary<f4>(convert<f8, f4>);
+                break;
+            case OpCodeEnum::I2B:
+                unary<i4>(narrow<i1>);
+                break;
+            case OpCodeEnum::I2C:
+                unary<i4>(narrow<u2>);
+                break;
+            case OpCodeEnum::I2S:
+                unary<i4>(narrow<i2>);
+                break;
+
+            case OpCodeEnum::LCMP:
+                binary<i4>(RegisterOp::compare<i8, -1>);
+                break;
+            case OpCodeEnum::FCMPL:
+                binary<i4>(RegisterOp::compare<f4, -1>);
+                break;
+            case OpCodeEnum::FCMPG:
+                binary<i4>(RegisterOp::compare<f4, 1>);
+                break;
+            case OpCodeEnum::DCMPL:
+                binary<i4>(RegisterOp::compare<f8, -1>);
+                break;
+            case OpCodeEnum::DCMPG:
+                binary<i4>(RegisterOp::compare<f8, 1>);
+                break;
+
+            case OpCodeEnum::IFEQ:
+                ifZero<i4, std::equal_to<>>();
+                break;
+            case OpCodeEnum::IFNE:
+                ifZero<i4, std::not_equal_to<>>();
+                break;
+            case OpCodeEnum::IFLT:
+                ifZero<i4, std::less<>>();
+                break;
+            case OpCodeEnum::IFGE:
+                ifZero<i4, std::greater_equal<>>();
+                break;
+            case OpCodeEnum::IFGT:
+                ifZero<i4, std::greater<>>();
+                break;
+            case OpCodeEnum::IFLE:
+                ifZero<i4, std::less_equal<>>();
+                break;
+            case OpCodeEnum::IF_ICMPEQ:
+                ifCompare<i4, std::equal_to<>>();
+                break;
+            case OpCodeEnum::IF_ICMPNE:
+                ifCompare<i4, std::not_equal_to<>>();
+                break;
+            case OpCodeEnum::IF_ICMPLT:
+                ifCompare<i4, std::less<>>();
+                break;
+            case OpCodeEnum::IF_ICMPGE:
+                ifCompare<i4, std::greater_equal<>>();
+                break;
+            case OpCodeEnum::IF_ICMPGT:
+                ifCompare<i4, std::greater<>>();
+                break;
+            case OpCodeEnum::IF_ICMPLE:
+                ifCompare<i4, std::less_equal<>>();
+                break;
+            case OpCodeEnum::IF_ACMPEQ:
+                ifCompare<ref, std::equal_to<>>();
+                break;
+            case OpCodeEnum::IF_ACMPNE:
+                ifCompare<ref, std::not_equal_to<>>();
+                break;
+            case OpCodeEnum::IFNULL:
+                ifZero<ref, std::equal_to<>>();
+                break;
+            case OpCodeEnum::IFNONNULL:
+                ifZero<ref, std::not_equal_to<>>();
+                break;
+            case OpCodeEnum::GOTO:
+                jump(reader.readI2());
+                break;
+            case OpCodeEnum::GOTO_W:
+                jump(reader.readI4());
+                break;
+
+            case OpCodeEnum::IRETURN:
+                returnValue<i4>();
+                break;
+            case OpCodeEnum::LRETURN:
+                returnValue<i8>();
+                break;
+            case OpCodeEnum::FRETURN:
+                returnValue<f4>();
+                break;
+            case OpCodeEnum::DRETURN:
+                returnValue<f8>();
+                break;
+            case OpCodeEnum::ARETURN:
+                returnValue<ref>();
+                break;
+            case OpCodeEnum::RETURN:
+                emit(returnVoid, 0);
+                stack.clear();
+                depth = 0;
+                break;
+
+            case OpCodeEnum::ARRAYLENGTH:
+                unary<i4>(arraylength);
+                break;
+
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<RegisterCode> translateRegisterCode(const Method &method) {
+        RegisterTranslator translator(method);
+        return translator.translate();
+    }
+
+    void executeRegisterCode(Frame &frame, const RegisterCode &code) {
+        const auto instructions = code.instructions.data();
+        for (u4 index = 0; index != REGISTER_CODE_EXIT;) {
+            const auto &instruction = instructions[index];
+            index = instruction.handler(frame, instruction, index);
+        }
+    }
+
+}
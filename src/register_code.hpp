@@ -0,0 +1,44 @@
+#ifndef REGISTER_CODE_HPP
+#define REGISTER_CODE_HPP
+#include <memory>
+#include <limits>
+#include <vector>
+#include "basic.hpp"
+
+namespace RexVM {
+
+    struct Frame;
+    struct Method;
+    struct RegisterInstruction;
+
+    //返回下一条指令的下标 REGISTER_CODE_EXIT表示离开寄存器形式(返回 抛出异常 或回到栈解释器)
+    using RegisterHandler = u4 (*)(Frame &frame, const RegisterInstruction &instruction, u4 index);
+
+    constexpr u4 REGISTER_CODE_EXIT = std::numeric_limits<u4>::max();
+
+    //寄存器编号直接对应Frame中的槽位: [0, maxLocals)是局部变量 [maxLocals, maxLocals + maxStack)是临时寄存器
+    //临时寄存器就是操作数栈上对应深度的槽位 lvt和操作数栈是连续的 所以都通过localVariableTable访问
+    struct RegisterInstruction {
+        RegisterHandler handler{};
+        u2 dst{}; //结果寄存器 xastore中是存入的值
+        u2 src1{};
+        u2 src2{};
+        u4 pc{}; //原始字节码pc 用于异常表 分支profile和回到栈解释器
+        Slot operand{}; //常量 iinc的增量 跳转目标指令的下标
+    };
+
+    //方法变热后把字节码翻译成寄存器形式 load/store和常量在翻译时变成寄存器编号 运算直接读写寄存器
+    //只翻译进入和离开时操作数栈为空的块 不支持的块翻译成回到栈解释器的指令
+    struct RegisterCode {
+        std::vector<RegisterInstruction> instructions;
+    };
+
+    //无法翻译或者第一个块就不支持时返回nullptr
+    [[nodiscard]] std::unique_ptr<RegisterCode> translateRegisterCode(const Method &method);
+
+    //从方法开始执行寄存器形式 结束时frame已经markReturn或markThrow 或者reader已经指向需要继续解释执行的pc
+    void executeRegisterCode(Frame &frame, const RegisterCode &code);
+
+}
+
+#endif
@@ -77,6 +77,19 @@ namespace RexVM {
         return false;
     }
 
+    bool StringTable::contains(const Value value) const {
+        const auto [hasHash, index] = value->getStringHash();
+        if (!hasHash) {
+            return false;
+        }
+        for (auto current = table[index]; current != nullptr; current = current->next) {
+            if (current->value == value) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     void StringTable::insert(const Value value) {
         const auto [hasHash, index] = value->getStringHash();
         const auto newNode = new Node(value);
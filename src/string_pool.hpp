@@ -56,6 +56,7 @@ namespace RexVM {
         ~StringTable();
 
         bool find(ccstr str, size_t size, Value &ret) const;
+        [[nodiscard]] bool contains(Value value) const;
         void insert(Value value);
         void erase(Value value);
         void clear();
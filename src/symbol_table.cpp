@@ -0,0 +1,103 @@
+#include "symbol_table.hpp"
+#include <cstring>
+
+namespace RexVM {
+
+    u4 getSymbolHash(const cview str) {
+        return CAST_U4(std::hash<cview>{}(str));
+    }
+
+    //从hash对应的槽位开始线性探测 返回相同内容的Symbol所在槽位 或者遇到的第一个空槽
+    //只在锁内使用 不会有并发写入
+    std::atomic<const Symbol *> &probeSymbol(const SymbolHashTable &hashTable, const cview str, const u4 hash) {
+        for (auto index = hash & hashTable.mask;; index = (index + 1) & hashTable.mask) {
+            auto &slot = hashTable.slots[index];
+            const auto symbol = slot.load(std::memory_order_relaxed);
+            if (symbol == nullptr ||
+                (symbol->hash == hash && symbol->view() == str)) {
+                return slot;
+            }
+        }
+    }
+
+    SymbolHashTable::SymbolHashTable(const size_t capacity)
+        : mask(capacity - 1), slots(std::make_unique<std::atomic<const Symbol *>[]>(capacity)) {
+    }
+
+    SymbolTable::SymbolTable() {
+        table.store(tables.emplace_back(std::make_unique<SymbolHashTable>(SYMBOL_TABLE_INIT_CAPACITY)).get(), std::memory_order_release);
+    }
+
+    SymbolTable &SymbolTable::instance() {
+        static SymbolTable symbolTable;
+        return symbolTable;
+    }
+
+    const char *SymbolTable::allocate(const cview str) {
+        if (str.size() > chunkRemain) {
+            //超长的字符串单独分配 不浪费当前块剩下的空间
+            if (str.size() > SYMBOL_ARENA_CHUNK_SIZE / 4) {
+                auto &chunk = chunks.emplace_back(std::make_unique<char[]>(str.size()));
+                std::memcpy(chunk.get(), str.data(), str.size());
+                return chunk.get();
+            }
+            chunkPtr = chunks.emplace_back(std::make_unique<char[]>(SYMBOL_ARENA_CHUNK_SIZE)).get();
+            chunkRemain = SYMBOL_ARENA_CHUNK_SIZE;
+        }
+        const auto ptr = chunkPtr;
+        std::memcpy(ptr, str.data(), str.size());
+        chunkPtr += str.size();
+        chunkRemain -= str.size();
+        return ptr;
+    }
+
+    void SymbolTable::insert(SymbolHashTable &hashTable, const Symbol *symbol) const {
+        probeSymbol(hashTable, symbol->view(), symbol->hash).store(symbol, std::memory_order_release);
+    }
+
+    //负载超过一半时容量翻倍 新表填满后再发布
+    void SymbolTable::grow() {
+        const auto oldTable = table.load(std::memory_order_relaxed);
+        const auto newTable = tables.emplace_back(std::make_unique<SymbolHashTable>((oldTable->mask + 1) * 2)).get();
+        for (const auto &symbol : symbolStorage) {
+            insert(*newTable, &symbol);
+        }
+        table.store(newTable, std::memory_order_release);
+    }
+
+    const Symbol *SymbolTable::intern(const cview str) {
+        if (const auto symbol = find(str); symbol != nullptr) {
+            return symbol;
+        }
+        std::lock_guard guard(lock);
+        const auto hash = getSymbolHash(str);
+        //加锁前可能已经被其他线程驻留
+        auto &slot = probeSymbol(*table.load(std::memory_order_relaxed), str, hash);
+        if (const auto symbol = slot.load(std::memory_order_relaxed); symbol != nullptr) {
+            return symbol;
+        }
+        const auto data = allocate(str);
+        const auto &symbol = symbolStorage.emplace_back(Symbol{data, CAST_U4(str.size()), hash});
+        slot.store(&symbol, std::memory_order_release);
+        if (++symbolCount * 2 > table.load(std::memory_order_relaxed)->mask + 1) {
+            grow();
+        }
+        return &symbol;
+    }
+
+    const Symbol *SymbolTable::find(const cview str) {
+        const auto &hashTable = *table.load(std::memory_order_acquire);
+        const auto hash = getSymbolHash(str);
+        //槽位可能被并发写入 每个槽位只读一次
+        for (auto index = hash & hashTable.mask;; index = (index + 1) & hashTable.mask) {
+            const auto symbol = hashTable.slots[index].load(std::memory_order_acquire);
+            if (symbol == nullptr) {
+                return nullptr;
+            }
+            if (symbol->hash == hash && symbol->view() == str) {
+                return symbol;
+            }
+        }
+    }
+
+}
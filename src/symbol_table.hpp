@@ -0,0 +1,71 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+#include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include "basic.hpp"
+
+namespace RexVM {
+
+    //驻留的UTF-8字符串 相同内容在VM中只有一个Symbol 相等比较和hash都只需要比较指针
+    struct Symbol {
+        const char *data;
+        u4 length;
+        u4 hash; //查找时先比较hash 再比较内容
+
+        [[nodiscard]] cview view() const {
+            return {data, length};
+        }
+    };
+
+    constexpr size_t SYMBOL_ARENA_CHUNK_SIZE = 64 * 1024;
+    constexpr size_t SYMBOL_TABLE_INIT_CAPACITY = 16 * 1024; //必须是2的幂
+
+    //开放寻址 只增不删 槽位为空表示查找结束
+    struct SymbolHashTable {
+        size_t mask;
+        std::unique_ptr<std::atomic<const Symbol *>[]> slots;
+
+        explicit SymbolHashTable(size_t capacity);
+    };
+
+    //常量池中的名字 描述符都驻留在这里 类不会卸载 Symbol一直有效
+    //常量池的解析可能在预取线程中进行 新增Symbol和扩容在锁内进行
+    //查找不加锁(getField/getMethod按名字查找时会频繁调用): Symbol写完后才用release写入槽位
+    //扩容时新表填满后才用release替换表指针 旧表可能还有线程在读 不释放
+    struct SymbolTable {
+        std::mutex lock;
+        std::atomic<SymbolHashTable *> table{};
+        std::vector<std::unique_ptr<SymbolHashTable>> tables;
+        size_t symbolCount{0};
+        std::deque<Symbol> symbolStorage;
+        std::vector<std::unique_ptr<char[]>> chunks;
+        char *chunkPtr{nullptr};
+        size_t chunkRemain{0};
+
+        explicit SymbolTable();
+        SymbolTable(const SymbolTable &) = delete;
+        SymbolTable &operator=(const SymbolTable &) = delete;
+
+        const Symbol *intern(cview str);
+        //没有驻留过返回nullptr 用于查找 不会新增Symbol
+        [[nodiscard]] const Symbol *find(cview str);
+
+        //函数内的静态变量 其他静态对象(NativeManager)初始化时也可以使用
+        static SymbolTable &instance();
+
+    private:
+        const char *allocate(cview str);
+        void insert(SymbolHashTable &hashTable, const Symbol *symbol) const;
+        void grow();
+    };
+
+    inline const Symbol *internSymbol(const cview str) {
+        return SymbolTable::instance().intern(str);
+    }
+
+}
+
+#endif
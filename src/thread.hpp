@@ -4,9 +4,12 @@
 #include <vector>
 #include <thread>
 #include <queue>
+#include <memory>
+#include <cstddef>
 #include "basic.hpp"
 #include "oop.hpp"
 #include "memory.hpp"
+#include "frame_memory_handler.hpp"
 
 namespace RexVM {
 
@@ -34,6 +37,11 @@ namespace RexVM {
         OopHolder oopHolder;
 
         Frame *currentFrame{nullptr};
+        //解释器内联调用时Frame对象的存储 按调用深度复用 只在本线程中访问
+        std::vector<std::unique_ptr<std::byte[]>> frameStorage;
+        size_t frameStorageTop{0};
+        bool throwingStackOverflow{false};
+        ExecuteCache executeCache;
         std::atomic_bool interrupted{false};
         volatile bool stopForCollect{false};
         volatile bool gcSafe{true};
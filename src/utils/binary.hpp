@@ -4,8 +4,10 @@
 #include <bit>
 #include <fstream>
 #include <memory>
+#include <cstring>
 #include "format.hpp"
 #include "../basic.hpp"
+#include "../exception.hpp"
 
 namespace RexVM {
 
@@ -70,31 +72,6 @@ namespace RexVM {
                              std::is_same_v<T, i1> || std::is_same_v<T, i2> ||
                              std::is_same_v<T, i4> || std::is_same_v<T, i8>;
 
-    template<StreamByteType T>
-    T read(std::istream &is) {
-        constexpr auto size = sizeof(T);
-        T val;
-        is.read(reinterpret_cast<char *>(&val), size);
-        return byteSwap(val);
-    }
-
-    template<StreamByteType T>
-    void read(T &val, std::istream &is) {
-        val = read<T>(is);
-    }
-
-    template<StreamByteType T>
-    T peek(std::istream &is) {
-        constexpr auto size = sizeof(T);
-        if constexpr (size == 1) {
-            return is.peek();
-        }
-        const auto &fpos = is.tellg();
-        const auto val = read<T>(is);
-        is.seekg(fpos);
-        return val;
-    }
-
     template<std::size_t ...Is>
     consteval void loop(std::index_sequence<Is...>, auto &&f) {
         (f.template operator()<Is>(), ...);
@@ -125,12 +102,6 @@ namespace RexVM {
         }
     }
 
-    inline std::unique_ptr<u1[]> readBuffer(std::istream &is, const std::size_t size) {
-        auto buffer = std::make_unique<u1[]>(size);
-        is.read(reinterpret_cast<char *>(buffer.get()), size);
-        return buffer;
-    }
-
     template<StreamByteType T>
     T read(const u1 *bytes) {
         constexpr auto size = sizeof(T);
@@ -139,6 +110,80 @@ namespace RexVM {
         return byteSwap(val);
     }
 
+    //解析类文件用的字节游标 直接读取内存中的类文件 越界时panic
+    struct ClassFileStream {
+        const u1 *ptr;
+        const u1 *end;
+
+        explicit ClassFileStream(const u1 *data, const size_t length) : ptr(data), end(data + length) {
+        }
+
+        [[nodiscard]] const u1 *peekBytes(const size_t size) const {
+            if (CAST_SIZE_T(end - ptr) < size) {
+                panic("class file truncated");
+            }
+            return ptr;
+        }
+
+        const u1 *readBytes(const size_t size) {
+            const auto current = peekBytes(size);
+            ptr += size;
+            return current;
+        }
+
+        void skip(const size_t size) {
+            readBytes(size);
+        }
+    };
+
+    template<StreamByteType T>
+    T read(ClassFileStream &is) {
+        return read<T>(is.readBytes(sizeof(T)));
+    }
+
+    template<StreamByteType T>
+    void read(T &val, ClassFileStream &is) {
+        val = read<T>(is);
+    }
+
+    template<StreamByteType T>
+    T peek(const ClassFileStream &is) {
+        return read<T>(is.peekBytes(sizeof(T)));
+    }
+
+    inline std::unique_ptr<u1[]> readBuffer(ClassFileStream &is, const std::size_t size) {
+        auto buffer = std::make_unique<u1[]>(size);
+        std::memcpy(buffer.get(), is.readBytes(size), size);
+        return buffer;
+    }
+
+    constexpr u8 FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+    constexpr u8 FNV_PRIME = 0x100000001b3;
+
+    //FNV-1a 用于生成缓存的key 可以传入上一次的结果做连续计算
+    inline u8 fnv1aHash(const void *data, const size_t length, u8 hash = FNV_OFFSET_BASIS) noexcept {
+        const auto bytes = static_cast<const u1 *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    inline u8 fnv1aHash(const cview str, const u8 hash = FNV_OFFSET_BASIS) noexcept {
+        return fnv1aHash(str.data(), str.size(), hash);
+    }
+
+    //murmur3的64位finalizer 指针之类低位恒为0的值在作为hash前先打散
+    inline u8 mixHash64(u8 hash) noexcept {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccd;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
 }
 
 #endif
\ No newline at end of file
@@ -3,16 +3,6 @@
 
 namespace RexVM {
 
-    ByteReader::ByteReader() : ptr(nullptr) {
-    }
-
-    void ByteReader::init(u1 *in, const size_t length_) {
-        begin = in;
-        ptr = in;
-        length = length_;
-        codeEnd = begin + length;
-    }
-
     bool ByteReader::eof() const {
         return ptr >= codeEnd;
     }
@@ -5,15 +5,21 @@
 namespace RexVM {
 
     struct ByteReader {
-        u1 *begin{nullptr};
-        u1 *ptr{nullptr};
+        const u1 *begin{nullptr};
+        const u1 *ptr{nullptr};
         size_t length{0};
         i4 cycleOffset{0};
-        u1 *codeEnd{nullptr};
+        const u1 *codeEnd{nullptr};
 
-        explicit ByteReader();
-        
-        void init(u1 *in, size_t length_);
+        //每次方法调用都会创建 构造和init保持内联
+        explicit ByteReader() = default;
+
+        void init(const u1 *in, const size_t length_) {
+            begin = in;
+            ptr = in;
+            length = length_;
+            codeEnd = begin + length;
+        }
 
         [[nodiscard]] bool eof() const;
 
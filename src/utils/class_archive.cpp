@@ -0,0 +1,137 @@
+#include "class_archive.hpp"
+#include "class_path.hpp"
+#include "file_utils.hpp"
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace RexVM {
+
+    constexpr char ARCHIVE_MAGIC[8] = {'R', 'E', 'X', 'C', 'D', 'S', '0', '1'};
+
+    ClassArchive::ClassArchive(const cview path, const u8 stamp, const bool dump) : path(path), stamp(stamp), dump(dump) {
+        if (dump) {
+            return;
+        }
+        file = mapFileReadOnly(this->path.c_str());
+        if (file.data == nullptr) {
+            cprintlnErr("class archive open error: {}", path);
+            return;
+        }
+        if (!validate()) {
+            cprintlnErr("class archive is stale or corrupted, ignored: {}", path);
+            unmapFile(file);
+            entries = nullptr;
+            classCount = 0;
+        }
+    }
+
+    ClassArchive::~ClassArchive() {
+        unmapFile(file);
+    }
+
+    bool ClassArchive::validate() {
+        if (file.size < sizeof(ArchiveHeader)) {
+            return false;
+        }
+        const auto base = static_cast<const u1 *>(file.data);
+        ArchiveHeader header{};
+        std::memcpy(&header, base, sizeof(ArchiveHeader));
+        if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.stamp != stamp) {
+            return false;
+        }
+        const auto entriesEnd = sizeof(ArchiveHeader) + CAST_SIZE_T(header.classCount) * sizeof(ArchiveEntry);
+        if (entriesEnd > file.size) {
+            return false;
+        }
+        //mmap的起始地址按页对齐 header大小是8的倍数 entries可以直接按结构体访问
+        entries = reinterpret_cast<const ArchiveEntry *>(base + sizeof(ArchiveHeader));
+        classCount = header.classCount;
+        for (u4 i = 0; i < classCount; ++i) {
+            const auto &entry = entries[i];
+            if (CAST_SIZE_T(entry.nameOffset) + entry.nameLength > file.size ||
+                CAST_SIZE_T(entry.dataOffset) + entry.dataLength > file.size) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ClassArchive::isMapped() const {
+        return entries != nullptr;
+    }
+
+    cview ClassArchive::getName(const ArchiveEntry &entry) const {
+        return {static_cast<const char *>(file.data) + entry.nameOffset, entry.nameLength};
+    }
+
+    const ArchiveEntry *ClassArchive::findClass(const cview filePath) const {
+        if (entries == nullptr) {
+            return nullptr;
+        }
+        const auto end = entries + classCount;
+        const auto iter = std::lower_bound(entries, end, filePath, [this](const ArchiveEntry &entry, const cview name) {
+            return getName(entry) < name;
+        });
+        if (iter == end || getName(*iter) != filePath) {
+            return nullptr;
+        }
+        return iter;
+    }
+
+    std::unique_ptr<ClassBytes> ClassArchive::getBytes(const ArchiveEntry &entry) const {
+        //归档在VM退出前一直映射着 不需要拷贝
+        auto bytes = std::make_unique<ClassBytes>();
+        bytes->data = static_cast<const u1 *>(file.data) + entry.dataOffset;
+        bytes->length = entry.dataLength;
+        return bytes;
+    }
+
+    void ClassArchive::recordClass(const cview filePath, const u4 classPathIndex, const cview bytes) {
+        std::lock_guard lock(dumpLock);
+        dumpClasses.try_emplace(cstring(filePath), classPathIndex, cstring(bytes));
+    }
+
+    void ClassArchive::writeArchive() {
+        std::lock_guard lock(dumpLock);
+        //dumpClasses是有序的 写出的entries可以直接二分查找
+        std::vector<ArchiveEntry> archiveEntries;
+        archiveEntries.reserve(dumpClasses.size());
+        auto offset = sizeof(ArchiveHeader) + dumpClasses.size() * sizeof(ArchiveEntry);
+        for (const auto &[name, item] : dumpClasses) {
+            const auto &[classPathIndex, bytes] = item;
+            ArchiveEntry entry{};
+            entry.nameOffset = CAST_U4(offset);
+            entry.nameLength = CAST_U4(name.size());
+            offset += name.size();
+            entry.dataOffset = CAST_U4(offset);
+            entry.dataLength = CAST_U4(bytes.size());
+            offset += bytes.size();
+            entry.classPathIndex = classPathIndex;
+            archiveEntries.emplace_back(entry);
+        }
+        if (offset > std::numeric_limits<u4>::max()) {
+            cprintlnErr("class archive too large: {}", path);
+            return;
+        }
+
+        ArchiveHeader header{};
+        std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        header.stamp = stamp;
+        header.classCount = CAST_U4(archiveEntries.size());
+
+        const auto written = writeFileAtomically(path, [&](std::ostream &os) {
+            os.write(reinterpret_cast<const char *>(&header), sizeof(ArchiveHeader));
+            os.write(reinterpret_cast<const char *>(archiveEntries.data()), CAST_I8(archiveEntries.size() * sizeof(ArchiveEntry)));
+            for (const auto &[name, item] : dumpClasses) {
+                os.write(name.data(), CAST_I8(name.size()));
+                os.write(item.second.data(), CAST_I8(item.second.size()));
+            }
+        });
+        if (!written) {
+            cprintlnErr("class archive write error: {}", path);
+        }
+    }
+
+}
@@ -0,0 +1,63 @@
+#ifndef CLASS_ARCHIVE_HPP
+#define CLASS_ARCHIVE_HPP
+
+#include <memory>
+#include <map>
+#include <mutex>
+#include "../basic.hpp"
+
+namespace RexVM {
+
+    //类数据共享归档 保存jar中加载过的类文件内容 下次启动时mmap进来 类在第一次被请求时才解析
+    //jar中的类每次都要定位和解压 归档之后直接从映射的内存中读取
+    //文件格式(偏移都相对文件开头 和本机字节序一致 归档只在生成它的机器上使用):
+    //  ArchiveHeader
+    //  ArchiveEntry[classCount] 按类文件名排序 查找时二分
+    //  类文件名和类文件内容
+    struct ClassBytes;
+
+    struct ArchiveHeader {
+        char magic[8];
+        u8 stamp; //classpath和jar的修改时间 大小算出的hash 不一致时整个归档作废
+        u4 classCount;
+        u4 reserved;
+    };
+
+    struct ArchiveEntry {
+        u4 nameOffset;
+        u4 nameLength;
+        u4 dataOffset;
+        u4 dataLength;
+        u4 classPathIndex; //类来自CombineClassPath中的第几个jar
+    };
+
+    struct ClassArchive {
+        const cstring path;
+        const u8 stamp;
+        const bool dump; //dump模式下不读取旧的归档 只记录加载的类 退出时写入
+
+        MappedFile file{};
+        const ArchiveEntry *entries{nullptr};
+        u4 classCount{0};
+
+        std::mutex dumpLock;
+        std::map<cstring, std::pair<u4, cstring>> dumpClasses;
+
+        explicit ClassArchive(cview path, u8 stamp, bool dump);
+        ~ClassArchive();
+
+        [[nodiscard]] bool isMapped() const;
+        [[nodiscard]] const ArchiveEntry *findClass(cview filePath) const;
+        [[nodiscard]] std::unique_ptr<ClassBytes> getBytes(const ArchiveEntry &entry) const;
+
+        void recordClass(cview filePath, u4 classPathIndex, cview bytes);
+        void writeArchive();
+
+    private:
+        [[nodiscard]] cview getName(const ArchiveEntry &entry) const;
+        bool validate();
+    };
+
+}
+
+#endif
@@ -1,8 +1,11 @@
 #include "class_path.hpp"
 #include <filesystem>
-#include <sstream>
+#include <fstream>
 #include <cstdlib>
 #include "string_utils.hpp"
+#include "binary.hpp"
+#include "class_archive.hpp"
+#include "file_utils.hpp"
 #include "../exception.hpp"
 #include "../file_system.hpp"
 
@@ -12,17 +15,55 @@ namespace RexVM {
         return path;
     }
 
-    std::unique_ptr<std::istream> DirClassPath::getStream(cview filePath) {
+    bool DirClassPath::contains(cview filePath) {
+        const auto separatorPos = filePath.rfind('/');
+        const cstring packageDir{separatorPos == cview::npos ? cview{} : filePath.substr(0, separatorPos + 1)};
+        if (!listedDirs.contains(packageDir)) {
+            listedDirs.emplace(packageDir);
+            std::error_code ec;
+            for (const auto &entry : std::filesystem::directory_iterator(cformat("{}{}", path, packageDir), ec)) {
+                if (entry.is_regular_file(ec)) {
+                    files.emplace(packageDir + entry.path().filename().string());
+                }
+            }
+        }
+        const cstring file{filePath};
+        if (files.contains(file)) {
+            return true;
+        }
+        if (stable) {
+            return false;
+        }
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(cformat("{}{}", path, filePath), ec)) {
+            return false;
+        }
+        files.emplace(file);
+        return true;
+    }
+
+    std::unique_ptr<ClassBytes> DirClassPath::getBytes(cview filePath) {
         const auto fullPath = cformat("{}{}", path, filePath);
-        if (std::filesystem::exists(fullPath)) {
-            return std::make_unique<std::ifstream>(fullPath, std::ios::binary);
+        std::ifstream is(fullPath, std::ios::binary | std::ios::ate);
+        if (!is) {
+            return nullptr;
         }
-        return nullptr;
+        const auto length = CAST_SIZE_T(is.tellg());
+        auto bytes = std::make_unique<ClassBytes>();
+        bytes->buffer = std::make_unique<u1[]>(length);
+        is.seekg(0);
+        if (!is.read(reinterpret_cast<char *>(bytes->buffer.get()), CAST_I8(length))) {
+            return nullptr;
+        }
+        bytes->data = bytes->buffer.get();
+        bytes->length = length;
+        return bytes;
     }
 
     ZipClassPath::ZipClassPath(cview path) : ClassPath(ClassPathTypeEnum::ZIP, path) {
-        if (std::filesystem::exists(path)) {
-            isOpened = mz_zip_reader_init_file(&archive, path.data(), 0);
+        file = mapFileReadOnly(this->path.c_str());
+        if (file.data != nullptr) {
+            isOpened = mz_zip_reader_init_mem(&archive, file.data, file.size, 0);
         }
     }
 
@@ -31,9 +72,23 @@ namespace RexVM {
             mz_zip_reader_end(&archive);
             isOpened = false;
         }
+        unmapFile(file);
+    }
+
+    //zip local file header: 固定30字节 之后是文件名和extra 再之后才是数据
+    constexpr size_t ZIP_LOCAL_HEADER_SIZE = 30;
+    constexpr u4 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+
+    //zip中的整数是小端序
+    static u4 readZipInt(const u1 *ptr, const size_t size) {
+        u4 val = 0;
+        for (size_t i = 0; i < size; ++i) {
+            val |= CAST_U4(ptr[i]) << (i * 8);
+        }
+        return val;
     }
 
-    std::unique_ptr<std::istream> ZipClassPath::getStream(cview filePath) {
+    std::unique_ptr<ClassBytes> ZipClassPath::getBytes(cview filePath) {
 
         if (!isOpened) {
             return nullptr;
@@ -43,19 +98,42 @@ namespace RexVM {
         if (fileIndex == -1) {
             return nullptr;
         }
+        return getBytes(CAST_U4(fileIndex));
+    }
 
+    std::unique_ptr<ClassBytes> ZipClassPath::getBytes(const u4 fileIndex) {
         mz_zip_archive_file_stat fileStat{0};
         if (!mz_zip_reader_file_stat(&archive, fileIndex, &fileStat)) {
             return nullptr;
         }
 
-
         const auto uncompressedSize = CAST_SIZE_T(fileStat.m_uncomp_size);
-        cstring buffer(uncompressedSize, 0);
-        if (!mz_zip_reader_extract_to_mem(&archive, fileIndex, reinterpret_cast<voidPtr>(buffer.data()), uncompressedSize, 0)) {
+        auto bytes = std::make_unique<ClassBytes>();
+        if (fileStat.m_method == 0 && fileStat.m_comp_size == fileStat.m_uncomp_size) {
+            //未压缩的类直接使用jar映射中的数据
+            const auto base = static_cast<const u1 *>(file.data);
+            const auto headerOffset = CAST_SIZE_T(fileStat.m_local_header_ofs);
+            if (headerOffset + ZIP_LOCAL_HEADER_SIZE <= file.size &&
+                readZipInt(base + headerOffset, 4) == ZIP_LOCAL_HEADER_SIGNATURE) {
+                const auto nameLength = readZipInt(base + headerOffset + 26, 2);
+                const auto extraLength = readZipInt(base + headerOffset + 28, 2);
+                const auto dataOffset = headerOffset + ZIP_LOCAL_HEADER_SIZE + nameLength + extraLength;
+                if (dataOffset + uncompressedSize <= file.size) {
+                    bytes->data = base + dataOffset;
+                    bytes->length = uncompressedSize;
+                    return bytes;
+                }
+            }
+        }
+
+        //压缩的类只解压一次 直接解压到最终的缓冲区
+        bytes->buffer = std::make_unique<u1[]>(uncompressedSize);
+        if (!mz_zip_reader_extract_to_mem(&archive, fileIndex, bytes->buffer.get(), uncompressedSize, 0)) {
             return nullptr;
         }
-        return std::make_unique<std::istringstream>(buffer);
+        bytes->data = bytes->buffer.get();
+        bytes->length = uncompressedSize;
+        return bytes;
     }
 
     CombineClassPath::CombineClassPath(cview path, cview javaHome) 
@@ -75,15 +153,16 @@ namespace RexVM {
                     }
                 }
             } else if (std::filesystem::is_directory(childPath)) {
+                const auto stable = !javaHome.empty() && childPath.starts_with(javaHome);
                 if (endsWith(childPath, fileSep)) {
                     if (!processedPath.contains(childPath)) {
-                        classPaths.push_back(std::make_unique<DirClassPath>(cstring(childPath)));
+                        classPaths.push_back(std::make_unique<DirClassPath>(cstring(childPath), stable));
                         processedPath.insert(childPath);
                     }
                 } else {
                     const cstring spath = childPath + fileSep;
                     if (!processedPath.contains(spath)) {
-                        classPaths.push_back(std::make_unique<DirClassPath>(spath));
+                        classPaths.push_back(std::make_unique<DirClassPath>(spath, stable));
                         processedPath.insert(spath);
                     }
                 }
@@ -91,17 +170,116 @@ namespace RexVM {
         }
     }
 
-    std::unique_ptr<std::istream> CombineClassPath::getStream(cview filePath) {
-        for (auto &&cp: classPaths) {
-            auto stream = cp->getStream(filePath);
-            if (stream != nullptr) {
-                return stream;
+    void CombineClassPath::initClassIndex() {
+        classIndexInitialized = true;
+        for (size_t i = 0; i < classPaths.size(); ++i) {
+            if (classPaths[i]->type != ClassPathTypeEnum::ZIP) {
+                continue;
+            }
+            auto &zipClassPath = static_cast<ZipClassPath &>(*classPaths[i]);
+            if (!zipClassPath.isOpened) {
+                continue;
+            }
+            const auto fileCount = mz_zip_reader_get_num_files(&zipClassPath.archive);
+            for (u4 fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+                //返回值包含结尾的'\0'
+                const auto nameSize = mz_zip_reader_get_filename(&zipClassPath.archive, fileIndex, nullptr, 0);
+                if (nameSize <= 1) {
+                    continue;
+                }
+                cstring name(nameSize - 1, '\0');
+                mz_zip_reader_get_filename(&zipClassPath.archive, fileIndex, name.data(), nameSize);
+                if (!name.ends_with(".class") || classIndex.contains(cview{name})) {
+                    continue;
+                }
+                const auto &storedName = classIndexNames.emplace_back(std::move(name));
+                classIndex.emplace(cview{storedName}, ClassIndexItem{CAST_U4(i), fileIndex});
             }
         }
+    }
 
+    ClassIndexItem CombineClassPath::findClassIndex(cview filePath) {
+        std::lock_guard guard(indexLock);
+        if (!classIndexInitialized) {
+            initClassIndex();
+        }
+        if (const auto item = classIndex.try_get(filePath); item != nullptr) {
+            return *item;
+        }
+        //记录jar中没有的类 Class.forName和ServiceLoader的探测经常找不到类
+        //类名可能来自用户输入 记录的数量有上限 超过后不再记录
+        if (classIndexMissCount >= CLASS_INDEX_MISS_LIMIT) {
+            return {};
+        }
+        ++classIndexMissCount;
+        const auto &storedName = classIndexNames.emplace_back(filePath);
+        classIndex.emplace(cview{storedName}, ClassIndexItem{});
+        return {};
+    }
+
+    std::unique_ptr<ClassBytes> CombineClassPath::getBytesFromDir(cview filePath, const size_t endIndex) {
+        for (size_t i = 0; i < endIndex && i < classPaths.size(); ++i) {
+            if (classPaths[i]->type != ClassPathTypeEnum::DIR) {
+                continue;
+            }
+            auto &dirClassPath = static_cast<DirClassPath &>(*classPaths[i]);
+            bool contains;
+            {
+                std::lock_guard guard(indexLock);
+                contains = dirClassPath.contains(filePath);
+            }
+            if (contains) {
+                if (auto bytes = dirClassPath.getBytes(filePath); bytes != nullptr) {
+                    return bytes;
+                }
+            }
+        }
         return nullptr;
     }
 
+    std::unique_ptr<ClassBytes> CombineClassPath::getBytes(cview filePath) {
+        if (archive != nullptr && archive->isMapped()) {
+            if (const auto entry = archive->findClass(filePath); entry != nullptr && entry->classPathIndex < classPaths.size()) {
+                //stamp保证jar没有变化 来源jar之前的jar都不包含这个类 只需要检查之前的目录
+                if (auto bytes = getBytesFromDir(filePath, entry->classPathIndex); bytes != nullptr) {
+                    return bytes;
+                }
+                return archive->getBytes(*entry);
+            }
+        }
+
+        //索引中是第一个包含该类的jar 它之前的目录优先
+        const auto item = findClassIndex(filePath);
+        if (auto bytes = getBytesFromDir(filePath, item.classPathIndex); bytes != nullptr) {
+            return bytes;
+        }
+        if (item.classPathIndex == CLASS_INDEX_NOT_FOUND) {
+            return nullptr;
+        }
+
+        auto bytes = static_cast<ZipClassPath &>(*classPaths[item.classPathIndex]).getBytes(item.fileIndex);
+        //目录中的类随时可能被修改 只归档jar中的类
+        if (bytes != nullptr && archive != nullptr && archive->dump) {
+            archive->recordClass(filePath, item.classPathIndex, cview(reinterpret_cast<const char *>(bytes->data), bytes->length));
+        }
+        return bytes;
+    }
+
+    u8 CombineClassPath::getArchiveStamp() const {
+        //归档中有按VM结构体布局保存的数据 VM重新编译后作废
+        auto stamp = getVMBuildStamp();
+        for (const auto &cp : classPaths) {
+            stamp = fnv1aHash(cformat("{}:{}", static_cast<int>(cp->type), cp->path), stamp);
+            if (cp->type == ClassPathTypeEnum::ZIP) {
+                std::error_code ec;
+                const auto writeTime = std::filesystem::last_write_time(cp->path, ec).time_since_epoch().count();
+                const auto fileSize = std::filesystem::file_size(cp->path, ec);
+                stamp = fnv1aHash(cformat("{}:{}", writeTime, fileSize), stamp);
+            }
+        }
+        return stamp;
+    }
+
     cstring CombineClassPath::getVMClassPath() const {
         return joinString(processedPath, {PATH_SEPARATOR});
     }
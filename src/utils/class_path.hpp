@@ -2,14 +2,42 @@
 #define CLASS_PATH_HPP
 
 #include <memory>
-#include <fstream>
 #include <vector>
 #include <unordered_set>
+#include <deque>
+#include <mutex>
+#include <limits>
+#include <cstring>
 #include <miniz.h>
+#include <hash_table8.hpp>
 #include "../basic.hpp"
 
 namespace RexVM {
 
+    struct ClassArchive;
+
+    //类文件内容 指向jar或归档的映射(进程内一直有效 不会被修改) 或者自己持有的缓冲区
+    //目录中的类文件会被重新编译覆盖 映射后截断会SIGBUS 只能读到自己的缓冲区里
+    struct ClassBytes {
+        const u1 *data{nullptr};
+        size_t length{0};
+        std::unique_ptr<u1[]> buffer;
+
+        explicit ClassBytes() = default;
+        ClassBytes(const ClassBytes &) = delete;
+        ClassBytes &operator=(const ClassBytes &) = delete;
+
+        //defineClass等传入的字节不归VM所有 复制一份由类保留
+        static std::unique_ptr<ClassBytes> copyOf(const u1 *data, const size_t length) {
+            auto classBytes = std::make_unique<ClassBytes>();
+            classBytes->buffer = std::make_unique<u1[]>(length);
+            std::memcpy(classBytes->buffer.get(), data, length);
+            classBytes->data = classBytes->buffer.get();
+            classBytes->length = length;
+            return classBytes;
+        }
+    };
+
     enum class ClassPathTypeEnum {
         DIR,
         ZIP,
@@ -25,7 +53,7 @@ namespace RexVM {
 
         virtual ~ClassPath() = default;
 
-        virtual std::unique_ptr<std::istream> getStream(cview filePath) = 0;
+        virtual std::unique_ptr<ClassBytes> getBytes(cview filePath) = 0;
         [[nodiscard]] virtual cstring getVMClassPath() const;
 
         bool operator==(const ClassPath &other) const {
@@ -34,33 +62,67 @@ namespace RexVM {
     };
 
     struct DirClassPath : ClassPath {
-        explicit DirClassPath(cview path) : ClassPath(ClassPathTypeEnum::DIR, path) {
+        //每个包目录在第一次查找时列出一次
+        //JAVA_HOME中的目录不会变化 列表中没有就是没有 其他目录可能在运行中生成新的类 列表中没有时再stat一次
+        const bool stable;
+        std::unordered_set<cstring> listedDirs;
+        std::unordered_set<cstring> files;
+
+        explicit DirClassPath(cview path, const bool stable = false) : ClassPath(ClassPathTypeEnum::DIR, path), stable(stable) {
         }
 
-        std::unique_ptr<std::istream> getStream(cview filePath) override;
+        [[nodiscard]] bool contains(cview filePath);
+        std::unique_ptr<ClassBytes> getBytes(cview filePath) override;
 
     };
 
     struct ZipClassPath : ClassPath {
         bool isOpened{false};
         mz_zip_archive archive{0};
+        MappedFile file{}; //整个jar映射到内存 未压缩的类直接指向映射 从内存读取时miniz可以多线程同时解压
 
         explicit ZipClassPath(cview path);
 
         ~ZipClassPath() override;
 
-        std::unique_ptr<std::istream> getStream(cview filePath) override;
+        std::unique_ptr<ClassBytes> getBytes(cview filePath) override;
+        std::unique_ptr<ClassBytes> getBytes(u4 fileIndex);
+    };
+
+    constexpr u4 CLASS_INDEX_NOT_FOUND = std::numeric_limits<u4>::max();
+    constexpr size_t CLASS_INDEX_MISS_LIMIT = 4096; //最多记录这么多个jar中没有的类名
+
+    struct ClassIndexItem {
+        u4 classPathIndex{CLASS_INDEX_NOT_FOUND}; //CLASS_INDEX_NOT_FOUND表示所有jar中都没有
+        u4 fileIndex{};
     };
 
     struct CombineClassPath : ClassPath {
         cview javaHome{};
         std::vector<std::unique_ptr<ClassPath>> classPaths;
         std::unordered_set<cstring> processedPath;
+        ClassArchive *archive{nullptr};
+
+        //所有jar中的类文件名 -> (第几个classpath, jar中的下标) 第一次查找时建立 前面的jar优先
+        //jar中找不到的类也会记录下来(最多CLASS_INDEX_MISS_LIMIT个) 之后的查找只需要检查目录
+        //类加载线程和预取线程会同时查找 索引和目录列表的修改都在indexLock下
+        std::mutex indexLock;
+        bool classIndexInitialized{false};
+        emhash8::HashMap<cview, ClassIndexItem> classIndex;
+        std::deque<cstring> classIndexNames;
+        size_t classIndexMissCount{0};
 
         explicit CombineClassPath(cview path, cview javaHome = {});
         [[nodiscard]] cstring getVMClassPath() const override;
+        //VM可执行文件 classpath的顺序和其中jar的修改时间 大小 用于判断类数据共享归档是否还有效
+        [[nodiscard]] u8 getArchiveStamp() const;
+
+        void initClassIndex();
+        [[nodiscard]] ClassIndexItem findClassIndex(cview filePath);
+        //依次检查[0, endIndex)中的目录
+        std::unique_ptr<ClassBytes> getBytesFromDir(cview filePath, size_t endIndex);
 
-        std::unique_ptr<std::istream> getStream(cview filePath) override;
+        std::unique_ptr<ClassBytes> getBytes(cview filePath) override;
 
         static std::unique_ptr<CombineClassPath> getDefaultCombineClassPath(cview javaHome, cview userClassPath);
     };
@@ -0,0 +1,49 @@
+#include "file_utils.hpp"
+#include <filesystem>
+#include <fstream>
+#include "binary.hpp"
+
+namespace RexVM {
+
+    bool writeFileAtomically(const cview path, const std::function<void(std::ostream &)> &writer) {
+        const cstring pathString{path};
+        const auto tempPath = cformat("{}.{}", pathString, getProcessId());
+        std::error_code ec;
+        std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+        if (!os) {
+            return false;
+        }
+        writer(os);
+        //close会flush 写入失败时设置failbit
+        os.close();
+        if (os.fail()) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        std::filesystem::rename(tempPath, pathString, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    static u8 computeVMBuildStamp() {
+        const auto executablePath = getExecutablePath();
+        if (!executablePath.empty()) {
+            auto file = mapFileReadOnly(executablePath.c_str());
+            if (file.data != nullptr) {
+                const auto stamp = fnv1aHash(file.data, file.size);
+                unmapFile(file);
+                return stamp;
+            }
+        }
+        return fnv1aHash(__DATE__ " " __TIME__);
+    }
+
+    u8 getVMBuildStamp() {
+        static const auto stamp = computeVMBuildStamp();
+        return stamp;
+    }
+
+}
@@ -0,0 +1,21 @@
+#ifndef FILE_UTILS_HPP
+#define FILE_UTILS_HPP
+
+#include <functional>
+#include <ostream>
+#include "../basic.hpp"
+
+namespace RexVM {
+
+    //先写临时文件再rename 其他VM不会读到写了一半的文件
+    //临时文件名带进程号 多个VM同时写同一个文件时互不覆盖
+    //写入(包括磁盘满导致的短写) 或rename失败时删除临时文件 返回false
+    bool writeFileAtomically(cview path, const std::function<void(std::ostream &)> &writer);
+
+    //VM可执行文件内容的hash 重新编译后改变 持久化的格式(类归档 堆快照)用来判断是否是同一个VM写出的
+    //取不到可执行文件时退回到本文件的编译时间
+    u8 getVMBuildStamp();
+
+}
+
+#endif
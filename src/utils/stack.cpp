@@ -3,17 +3,10 @@
 
 namespace RexVM {
 
-    StackContext::StackContext(Slot *memory, SlotTypeEnum *memoryType, const i4 pos) :
-        sp(pos), maxSp(sp), memory(memory), memoryType(memoryType) {
-    }
-
     void StackContext::push(const Slot val, const SlotTypeEnum slotType) {
         ++sp;
         memory[sp] = val;
         memoryType[sp] = slotType;
-        if (sp > maxSp) {
-            maxSp = sp;
-        }
     }
 
     void StackContext::push(std::tuple<Slot, SlotTypeEnum> valWithType) {
@@ -12,12 +12,13 @@ namespace RexVM {
     struct StackContext {
         //栈顶指针 默认值为-1 始终指向最后一个插入的元素
         i4 sp;
-        i4 maxSp;
 
         Slot *memory;
         SlotTypeEnum *memoryType;
 
-        explicit StackContext(Slot *memory, SlotTypeEnum *memoryType, i4 pos);
+        explicit StackContext(Slot *memory, SlotTypeEnum *memoryType, const i4 pos) :
+            sp(pos), memory(memory), memoryType(memoryType) {
+        }
 
         void push(Slot val, SlotTypeEnum slotType);
         void push(std::tuple<Slot, SlotTypeEnum> valWithType);
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "basic_java_class.hpp"
 #include "utils/class_path.hpp"
+#include "utils/class_archive.hpp"
 #include "class_loader.hpp"
 #include "string_pool.hpp"
 #include "thread.hpp"
@@ -11,6 +12,7 @@
 #include "bootstrap_helper.hpp"
 #include "class.hpp"
 #include "jit_manager.hpp"
+#include "heap_snapshot.hpp"
 
 namespace RexVM {
 
@@ -23,7 +25,19 @@ namespace RexVM {
         }
 
         //init basic class path
-        classPath = CombineClassPath::getDefaultCombineClassPath(javaHome, params.userClassPath);
+        auto combineClassPath = CombineClassPath::getDefaultCombineClassPath(javaHome, params.userClassPath);
+        if (!params.classArchivePath.empty() || !params.heapSnapshotPath.empty()) {
+            classPathStamp = combineClassPath->getArchiveStamp();
+        }
+        if (!params.classArchivePath.empty()) {
+            classArchive = std::make_unique<ClassArchive>(
+                params.classArchivePath,
+                classPathStamp,
+                params.classArchiveDump
+            );
+            combineClassPath->archive = classArchive.get();
+        }
+        classPath = std::move(combineClassPath);
         javaClassPath = classPath->getVMClassPath();
         
         //init memory allocator
@@ -46,6 +60,10 @@ namespace RexVM {
         //init Main Thread
         mainThread = std::unique_ptr<VMThread>(VMThread::createOriginVMThread(*this));
         mainThread->setThreadName("main"); //like openjdk
+        if (!params.heapSnapshotPath.empty() && !params.heapSnapshotDump) {
+            //恢复时不执行Java代码 在GC线程启动前完成 新分配的对象还没有连到GC Root上
+            heapSnapshotRestored = restoreHeapSnapshot(*this, *mainThread, params.heapSnapshotPath);
+        }
         garbageCollector->start();
 
         jitManager = std::make_unique<JITManager>(*this);
@@ -69,10 +87,17 @@ namespace RexVM {
     }
 
     void VM::exitVM() const {
+        bootstrapClassLoader->stopPrefetch();
+        if (!params.classListDumpPath.empty()) {
+            bootstrapClassLoader->dumpClassList(params.classListDumpPath);
+        }
         garbageCollector->notify();
         garbageCollector->join();
         stringPool->clear();
         garbageCollector->collectAll();
+        if (classArchive != nullptr && classArchive->dump) {
+            classArchive->writeArchive();
+        }
     }
 
     VM::VM(ApplicationParameter &params) : params(params) {
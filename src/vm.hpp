@@ -9,6 +9,7 @@
 namespace RexVM {
 
     struct ClassPath;
+    struct ClassArchive;
     struct ClassLoader;
     struct StringPool;
     struct NativeManager;
@@ -23,18 +24,24 @@ namespace RexVM {
     constexpr size_t GC_STOP_WAIT_TIME_OUT = 5; //wait 5ms
     constexpr size_t GC_ROOT_RESERVE_SIZE = 8192;
 
-    constexpr size_t JIT_COMPILE_OPTIMIZE_LEVEL = 0;
+    constexpr size_t JIT_COMPILE_OPTIMIZE_LEVEL = 2; //代码生成和IR优化流水线(含向量化)共用 0时不做IR优化
+    constexpr size_t JIT_DEOPT_RECOMPILE_LIMIT = 64;
+    constexpr size_t JIT_DEOPT_DECAY_INVOKE_COUNT = 10000;
 
 #ifdef DEBUG
     constexpr size_t GC_MEMORY_THRESHOLD = 0.5 * 1024 * 1024; //1M
     constexpr size_t GC_SLEEP_TIME = 1; //500ms
 
     constexpr size_t JIT_INVOKE_COUNT_THRESHOLD = 0;
+    constexpr size_t JIT_PROFILE_INVOKE_COUNT_THRESHOLD = 0;
+    constexpr size_t REGISTER_CODE_INVOKE_COUNT_THRESHOLD = 0;
 #else
     constexpr size_t GC_MEMORY_THRESHOLD = 20 * 1024 * 1024; //20MB
     constexpr size_t GC_SLEEP_TIME = 5000; //5000ms
 
     constexpr size_t JIT_INVOKE_COUNT_THRESHOLD = 20;
+    constexpr size_t JIT_PROFILE_INVOKE_COUNT_THRESHOLD = 5;
+    constexpr size_t REGISTER_CODE_INVOKE_COUNT_THRESHOLD = 10;
 #endif
 
 
@@ -50,17 +57,40 @@ namespace RexVM {
         size_t gcCollectStopWaitTimeout{GC_STOP_WAIT_TIME_OUT};
         size_t gcCollectSleepTime{GC_SLEEP_TIME};
 
+        bool intrinsicEnable{true}; //JDK热点方法(String.equals Math.min等)使用内建实现
+        bool superInstructionEnable{false}; //解释器把常见的字节码序列融合为超级指令执行 -XX:+UseSuperInstructions开启
+        bool registerCodeEnable{false}; //方法变热后翻译成寄存器形式解释执行 -XX:+UseRegisterCode开启
+        size_t registerCodeMethodInvokeCountThreshold{REGISTER_CODE_INVOKE_COUNT_THRESHOLD};
+        cstring classArchivePath{}; //类数据共享归档文件 为空则不使用
+        bool classArchiveDump{false}; //只记录jar中加载过的类 退出时写入classArchivePath
+        bool classPrefetchEnable{false}; //在工作线程中提前读取和解析预测会用到的类
+        size_t classPrefetchThreadCount{0}; //0表示按CPU核数选择
+        cstring classListPath{}; //上次运行记录的类列表 用于预测启动时需要加载的类
+        cstring classListDumpPath{}; //退出时把从classpath加载的类名按顺序写入此文件
+        cstring heapSnapshotPath{}; //堆快照文件 存在且未过期时恢复其中的堆 跳过bootstrap
+        bool heapSnapshotDump{false}; //bootstrap执行完后把堆写入heapSnapshotPath
+
         bool jitEnable{true};
         size_t jitCompileMethodInvokeCountThreshold{JIT_INVOKE_COUNT_THRESHOLD};
         size_t jitCompileOptimizeLevel{JIT_COMPILE_OPTIMIZE_LEVEL};
         bool jitLVTOptimize{true};
         bool jitCheckStack{false};
         bool jitSupportException{true};
+        bool jitSpeculate{true}; //编译时做推测优化 推测失败时去优化回解释器
+        size_t jitDeoptRecompileLimit{JIT_DEOPT_RECOMPILE_LIMIT}; //去优化超过此次数后不再编译该方法
+        size_t jitDeoptDecayInvokeCount{JIT_DEOPT_DECAY_INVOKE_COUNT}; //两次去优化之间每调用这么多次 去优化计数减一
+        cstring jitCodeCacheDir{}; //JIT代码缓存目录 为空则不缓存
+        bool jitVectorize{true}; //jitCompileOptimizeLevel大于0时开启LLVM的循环向量化和SLP向量化
+        bool jitProfile{true}; //解释器收集分支和类型profile 供JIT做代码布局和推测
+        size_t jitProfileMethodInvokeCountThreshold{JIT_PROFILE_INVOKE_COUNT_THRESHOLD};
+        bool jitPerfMap{false}; //写 /tmp/perf-<pid>.map 让perf能解析JIT函数的符号
+        bool jitDump{false}; //写 /tmp/jit-<pid>.dump 供perf inject --jit使用 包含JIT函数的机器码
     };
 
     struct VM {
         ApplicationParameter &params;
         std::unique_ptr<ClassPath> classPath;
+        std::unique_ptr<ClassArchive> classArchive;
         std::unique_ptr<OopManager> oopManager;
         std::unique_ptr<ThreadManager> threadManager;
         std::unique_ptr<StringPool> stringPool;
@@ -72,6 +102,8 @@ namespace RexVM {
         std::chrono::system_clock::time_point startTime{std::chrono::system_clock::now()};
         cstring javaHome{};
         cstring javaClassPath{};
+        u8 classPathStamp{}; //classpath和jar的修改时间 大小算出的hash 类归档和堆快照用来判断是否过期
+        bool heapSnapshotRestored{false};
         bool exit{false};
 
         explicit VM(ApplicationParameter &params);
@@ -0,0 +1,142 @@
+//CHA去虚化: 只加载了一个实现时调用点直接绑定 之后加载新的子类 编译代码要失效并重新分派
+//方法先调用到超过JIT阈值 等编译线程编译完再加载新类 输出需要和JDK一致
+public class ChaTest {
+
+    static final int WARM_UP = 500;
+
+    abstract static class Base {
+        abstract int value(int x);
+    }
+
+    static class First extends Base {
+        int value(int x) {
+            return x + 1;
+        }
+    }
+
+    //第一次执行new时才加载
+    static class LateByNew extends Base {
+        int value(int x) {
+            return x * 100;
+        }
+    }
+
+    //通过Class.forName加载
+    static class LateByName extends Base {
+        int value(int x) {
+            return -x;
+        }
+    }
+
+    //不覆盖value 分派结果不变 依赖仍然要失效
+    static class FirstChild extends First {
+    }
+
+    interface Greeter {
+        String greet(String name);
+    }
+
+    static class Hello implements Greeter {
+        public String greet(String name) {
+            return "hello " + name;
+        }
+    }
+
+    static class LateGreeter implements Greeter {
+        public String greet(String name) {
+            return "late " + name;
+        }
+    }
+
+    static int call(Base base, int x) {
+        return base.value(x);
+    }
+
+    static String greet(Greeter greeter, String name) {
+        return greeter.greet(name);
+    }
+
+    //编译代码执行期间加载新的子类 后面的调用点要去优化
+    static int loopWithLoad(Base[] bases, int loadAt) {
+        int sum = 0;
+        for (int i = 0; i < bases.length; i++) {
+            if (i == loadAt) {
+                bases[i + 1] = new LateByNew();
+            }
+            sum += bases[i].value(i);
+        }
+        return sum;
+    }
+
+    static int nullReceiver(Base base) {
+        try {
+            return base.value(1);
+        } catch (NullPointerException e) {
+            return -1000;
+        }
+    }
+
+    static void waitForCompile() {
+        try {
+            Thread.sleep(500);
+        } catch (InterruptedException e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    static void warm(Base first, Greeter hello) {
+        Base[] bases = new Base[8];
+        long sum = 0;
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < WARM_UP; i++) {
+                for (int j = 0; j < bases.length; j++) {
+                    bases[j] = first;
+                }
+                sum += call(first, i);
+                sum += loopWithLoad(bases, -1);
+                sum += nullReceiver(first);
+                sum += greet(hello, "warm").length();
+            }
+            waitForCompile();
+        }
+        System.out.println("warm " + sum);
+    }
+
+    public static void main(String[] args) throws Exception {
+        Base first = new First();
+        Greeter hello = new Hello();
+        warm(first, hello);
+
+        //编译代码中new触发加载 同一次调用里后面的元素已经是新的子类
+        Base[] bases = new Base[8];
+        for (int j = 0; j < bases.length; j++) {
+            bases[j] = first;
+        }
+        System.out.println("loopWithLoad " + loopWithLoad(bases, 3));
+        System.out.println("call LateByNew " + call(bases[4], 7));
+
+        Base byName = (Base) Class.forName("ChaTest$LateByName").newInstance();
+        System.out.println("call LateByName " + call(byName, 7));
+        System.out.println("call First " + call(first, 7));
+
+        Base child = new FirstChild();
+        System.out.println("call FirstChild " + call(child, 7));
+
+        System.out.println("nullReceiver " + nullReceiver(null) + " " + nullReceiver(first));
+
+        Greeter late = (Greeter) Class.forName("ChaTest$LateGreeter").newInstance();
+        System.out.println(greet(late, "a") + ", " + greet(hello, "b"));
+
+        //失效后重新变热 再编译的代码对所有已加载的类都正确
+        Base[] all = {first, bases[4], byName, child};
+        long sum = 0;
+        for (int i = 0; i < WARM_UP; i++) {
+            sum += call(all[i % all.length], i);
+        }
+        waitForCompile();
+        for (int i = 0; i < WARM_UP; i++) {
+            sum += call(all[i % all.length], i);
+        }
+        System.out.println("recompiled " + sum);
+    }
+}
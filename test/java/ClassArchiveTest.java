@@ -0,0 +1,69 @@
+import java.util.ArrayList;
+import java.util.List;
+import java.util.TreeMap;
+import java.util.function.Function;
+
+//类从jar和归档中加载的结果要一致 输出需要和JDK一致
+//run_java_tests.sh会把测试类打成jar 按 正常启动 / -Xshare:dump / 使用归档 / 归档过期 分别运行
+public class ClassArchiveTest {
+
+    interface Shape {
+        double area();
+    }
+
+    static class Square implements Shape {
+        final double side;
+
+        Square(double side) {
+            this.side = side;
+        }
+
+        public double area() {
+            return side * side;
+        }
+    }
+
+    static class Circle implements Shape {
+        final double radius;
+
+        Circle(double radius) {
+            this.radius = radius;
+        }
+
+        public double area() {
+            return 3 * radius * radius;
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        List<Shape> shapes = new ArrayList<>();
+        for (int i = 1; i <= 4; i++) {
+            shapes.add(i % 2 == 0 ? new Square(i) : new Circle(i));
+        }
+        double total = 0;
+        for (Shape shape : shapes) {
+            total += shape.area();
+        }
+        System.out.println("total " + total);
+
+        TreeMap<String, Integer> names = new TreeMap<>();
+        for (Shape shape : shapes) {
+            names.merge(shape.getClass().getSimpleName(), 1, Integer::sum);
+        }
+        System.out.println("names " + names);
+
+        Function<Integer, String> describe = i -> "item" + i;
+        System.out.println("lambda " + describe.apply(7));
+
+        Class<?> loaded = Class.forName("ClassArchiveTest$Square");
+        System.out.println("forName " + loaded.getName() + " " + Shape.class.isAssignableFrom(loaded)
+                           + " " + (loaded.getClassLoader() == ClassArchiveTest.class.getClassLoader()));
+        System.out.println("jdk " + Class.forName("java.util.concurrent.ConcurrentHashMap").getSimpleName());
+        try {
+            Class.forName("ClassArchiveTest$Missing");
+            System.out.println("missing found");
+        } catch (ClassNotFoundException e) {
+            System.out.println("missing " + e.getMessage());
+        }
+    }
+}
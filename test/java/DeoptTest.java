@@ -0,0 +1,157 @@
+//推测优化失败时去优化回解释器: 类型profile 空指针检查 类型检查 晚出现的分支
+//方法先调用到超过JIT阈值 等编译线程编译完再让推测失败 输出需要和JDK一致
+public class DeoptTest {
+
+    static final int WARM_UP = 500;
+
+    interface Shape {
+        int area();
+    }
+
+    static class Square implements Shape {
+        final int side;
+
+        Square(int side) {
+            this.side = side;
+        }
+
+        public int area() {
+            return side * side;
+        }
+    }
+
+    static class Rect implements Shape {
+        final int w;
+        final int h;
+
+        Rect(int w, int h) {
+            this.w = w;
+            this.h = h;
+        }
+
+        public int area() {
+            return w * h;
+        }
+    }
+
+    static class Holder {
+        int value;
+
+        Holder(int value) {
+            this.value = value;
+        }
+    }
+
+    //profile中只有Square 推测接收者类型
+    static int area(Shape shape) {
+        return shape.area();
+    }
+
+    //去优化时操作数栈上有long和double 局部变量中也有 解释器要拿到完整的状态
+    static double mixedStack(Shape shape, long base, double scale) {
+        long local = base * 3;
+        double d = scale + 0.5;
+        return base + local * shape.area() + d * shape.area();
+    }
+
+    static int field(Holder holder) {
+        try {
+            return holder.value;
+        } catch (NullPointerException e) {
+            return -1;
+        }
+    }
+
+    static int cast(Object object) {
+        try {
+            return ((Square) object).side;
+        } catch (ClassCastException e) {
+            return -2;
+        }
+    }
+
+    static int arrayLength(int[] array) {
+        try {
+            return array.length;
+        } catch (NullPointerException e) {
+            return -3;
+        }
+    }
+
+    //warm阶段n总是小于limit 之后才走另一个分支
+    static long lateBranch(int n, int limit) {
+        long sum = 0;
+        for (int i = 0; i < n; i++) {
+            if (i >= limit) {
+                sum += (long) i * i;
+            } else {
+                sum += i;
+            }
+        }
+        return sum;
+    }
+
+    //类型在两种之间来回切换 超过去优化次数上限后不再编译 结果仍然正确
+    static int flipFlop(Shape shape) {
+        return shape.area() + 1;
+    }
+
+    static void waitForCompile() {
+        try {
+            Thread.sleep(500);
+        } catch (InterruptedException e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    public static void main(String[] args) {
+        Shape square = new Square(3);
+        Shape rect = new Rect(2, 5);
+        Holder holder = new Holder(42);
+        int[] array = new int[7];
+
+        long sum = 0;
+        double dsum = 0;
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < WARM_UP; i++) {
+                sum += area(square);
+                dsum += mixedStack(square, i, 1.25);
+                sum += field(holder);
+                sum += cast(square);
+                sum += arrayLength(array);
+                sum += lateBranch(i % 10, 100);
+                sum += flipFlop(square);
+            }
+            waitForCompile();
+        }
+        System.out.println("warm " + sum + " " + dsum);
+
+        System.out.println("area " + area(rect) + " " + area(square));
+        System.out.println("mixedStack " + mixedStack(rect, 1L << 40, 2.5) + " " + mixedStack(square, 7, 0.25));
+        System.out.println("field " + field(null) + " " + field(holder));
+        System.out.println("cast " + cast("not a square") + " " + cast(square));
+        System.out.println("arrayLength " + arrayLength(null) + " " + arrayLength(array));
+        System.out.println("lateBranch " + lateBranch(200, 100) + " " + lateBranch(5, 100));
+
+        //去优化之后再次变热 重新编译的代码在去优化过的位置不再推测
+        sum = 0;
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < WARM_UP; i++) {
+                sum += area((i & 1) == 0 ? square : rect);
+                sum += field((i % 3) == 0 ? null : holder);
+                sum += lateBranch(i % 150, 100);
+            }
+            waitForCompile();
+        }
+        System.out.println("recompiled " + sum);
+
+        sum = 0;
+        for (int i = 0; i < 100; i++) {
+            Shape shape = (i & 1) == 0 ? square : rect;
+            for (int j = 0; j < 50; j++) {
+                sum += flipFlop(shape);
+            }
+        }
+        System.out.println("flipFlop " + sum);
+    }
+}
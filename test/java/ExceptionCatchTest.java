@@ -0,0 +1,103 @@
+//异常表在方法第一次执行时解析 catch的类在第一次匹配时加载 输出需要和JDK一致
+public class ExceptionCatchTest {
+
+    static class BaseException extends RuntimeException {
+        BaseException(String message) {
+            super(message);
+        }
+    }
+
+    static class LeafException extends BaseException {
+        LeafException(String message) {
+            super(message);
+        }
+    }
+
+    //只在catch中出现 第一次匹配前不会被加载
+    static class NeverThrownException extends RuntimeException {
+    }
+
+    interface Thrower {
+        default String run(int kind) {
+            try {
+                throwKind(kind);
+                return "none";
+            } catch (LeafException e) {
+                return "leaf:" + e.getMessage();
+            } catch (BaseException e) {
+                return "base:" + e.getMessage();
+            }
+        }
+    }
+
+    static void throwKind(int kind) {
+        switch (kind) {
+            case 1:
+                throw new LeafException("one");
+            case 2:
+                throw new BaseException("two");
+            case 3:
+                throw new IllegalStateException("three");
+            default:
+        }
+    }
+
+    static String nested(int kind) {
+        StringBuilder builder = new StringBuilder();
+        try {
+            try {
+                throwKind(kind);
+            } catch (NeverThrownException e) {
+                builder.append("never");
+            } finally {
+                builder.append("finally;");
+            }
+        } catch (BaseException e) {
+            builder.append("outer:").append(e.getClass().getSimpleName());
+        } catch (RuntimeException e) {
+            builder.append("runtime:").append(e.getMessage());
+        }
+        return builder.toString();
+    }
+
+    static int manyHandlers(int kind) {
+        //较大的异常表会建立pc索引
+        int r = 0;
+        for (int i = 0; i < 3; i++) {
+            try {
+                r += 1;
+                throwKind(kind);
+            } catch (LeafException e) {
+                r += 10;
+            } catch (BaseException e) {
+                r += 100;
+            } catch (IllegalStateException e) {
+                r += 1000;
+            }
+            try {
+                r += 2;
+                int[] array = new int[kind];
+                r += array[1];
+            } catch (ArrayIndexOutOfBoundsException e) {
+                r += 20;
+            } catch (NegativeArraySizeException e) {
+                r += 200;
+            }
+        }
+        return r;
+    }
+
+    public static void main(String[] args) {
+        Thrower thrower = new Thrower() {
+        };
+        for (int kind = 0; kind <= 2; kind++) {
+            System.out.println("default method " + kind + " " + thrower.run(kind));
+        }
+        for (int kind = 0; kind <= 3; kind++) {
+            System.out.println("nested " + kind + " " + nested(kind));
+        }
+        for (int kind = 0; kind <= 3; kind++) {
+            System.out.println("manyHandlers " + kind + " " + manyHandlers(kind));
+        }
+    }
+}
@@ -0,0 +1,62 @@
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+import java.util.IdentityHashMap;
+import java.util.Map;
+
+//从堆快照恢复后 bootstrap创建的对象必须和正常启动时表现一致 输出需要和JDK一致
+//run_java_tests.sh会按 正常启动 / dump快照 / 从快照恢复 / 快照过期 分别运行
+public class HeapSnapshotTest {
+
+    public static void main(String[] args) throws Exception {
+        //intern字符串: 枚举的name和Boolean.toString返回bootstrap中类常量池里的字面量
+        //恢复后放回String Pool 之后ldc同样内容的字面量必须是同一个对象
+        System.out.println("intern Thread.State " + (Thread.State.RUNNABLE.name() == "RUNNABLE"));
+        System.out.println("intern Boolean " + (Boolean.toString(true) == "true") + " " + (String.valueOf(false) == "false"));
+        System.out.println("intern new " + (new String("snapshot").intern() == "snapshot"));
+
+        //mirror重新绑定: 静态字段中的Class对象和当前类加载器中的mirror是同一个对象
+        System.out.println("mirror Integer.TYPE " + (Integer.TYPE == int.class) + " " + Integer.TYPE.getName() + " " + Integer.TYPE.isPrimitive());
+        System.out.println("mirror Void.TYPE " + (Void.TYPE == void.class));
+        System.out.println("mirror forName " + (Class.forName("java.lang.System") == System.class));
+        System.out.println("mirror getClass " + ("abc".getClass() == String.class) + " " + (Boolean.TRUE.getClass() == Boolean.class));
+        System.out.println("mirror superclass " + (Integer.class.getSuperclass() == Number.class));
+        Method length = String.class.getMethod("length");
+        System.out.println("mirror method " + length.getName() + " " + length.invoke("snapshot"));
+        Field value = Integer.class.getDeclaredField("value");
+        value.setAccessible(true);
+        System.out.println("mirror field " + value.getName() + " " + value.get(Integer.valueOf(42)));
+
+        //identity hash: sun.reflect.Reflection在bootstrap中建立以Class为key的HashMap(Class.hashCode是identity hash)
+        //恢复后hash变化的话查不到过滤规则 System.security和Reflection的字段就会暴露出来
+        boolean securityVisible = false;
+        for (Field field : System.class.getDeclaredFields()) {
+            if (field.getName().equals("security")) {
+                securityVisible = true;
+            }
+        }
+        System.out.println("identity filter System.security visible " + securityVisible);
+
+        //恢复的对象的identity hash在后续使用中保持不变
+        Object[] bootstrapObjects = {Integer.TYPE, System.class, Thread.currentThread(), Boolean.TRUE, System.out, "RUNNABLE"};
+        int[] identityHashes = new int[bootstrapObjects.length];
+        Map<Object, Integer> identityMap = new IdentityHashMap<>();
+        for (int i = 0; i < bootstrapObjects.length; i++) {
+            identityHashes[i] = System.identityHashCode(bootstrapObjects[i]);
+            identityMap.put(bootstrapObjects[i], i);
+        }
+        System.gc();
+        boolean stable = true;
+        for (int i = 0; i < bootstrapObjects.length; i++) {
+            Object object = bootstrapObjects[i];
+            stable &= identityMap.get(object) == i;
+            stable &= System.identityHashCode(object) == identityHashes[i];
+            stable &= object.hashCode() == object.hashCode();
+        }
+        System.out.println("identity stable " + stable + " " + identityMap.size());
+
+        //恢复后的main线程和System.out
+        System.out.println("thread " + Thread.currentThread().getName() + " " + Thread.currentThread().getState()
+                           + " " + Thread.currentThread().getThreadGroup().getName());
+        System.out.println("property " + System.getProperty("java.specification.version"));
+    }
+}
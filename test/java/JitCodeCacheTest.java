@@ -0,0 +1,111 @@
+import java.util.ArrayList;
+import java.util.List;
+
+//JIT代码缓存: 第一次运行编译并写入缓存 之后的运行直接链接缓存的目标文件 输出需要和JDK一致
+//缓存的目标文件中常量 字符串 类和方法指针都是外部符号 换一个进程后要绑定到新的地址
+public class JitCodeCacheTest {
+
+    static final int WARM_UP = 200;
+
+    static int staticField = 7;
+
+    interface Shape {
+        int area();
+    }
+
+    static class Square implements Shape {
+        final int side;
+
+        Square(int side) {
+            this.side = side;
+        }
+
+        public int area() {
+            return side * side;
+        }
+    }
+
+    static class Rect implements Shape {
+        final int w;
+        final int h;
+
+        Rect(int w, int h) {
+            this.w = w;
+            this.h = h;
+        }
+
+        public int area() {
+            return w * h;
+        }
+    }
+
+    static int loop(int n) {
+        int r = staticField;
+        for (int i = 0; i < n; i++) {
+            r = r * 31 + i;
+            if ((r & 3) == 0) {
+                r ^= i;
+            }
+        }
+        return r;
+    }
+
+    static double doubles(double a, int n) {
+        double r = 0;
+        for (int i = 1; i <= n; i++) {
+            r += a / i;
+        }
+        return r;
+    }
+
+    static String strings(int i) {
+        return "item-" + i + ":" + (i % 3 == 0 ? "fizz" : "none");
+    }
+
+    static int shapes(Shape[] shapes) {
+        int sum = 0;
+        for (Shape shape : shapes) {
+            sum += shape.area();
+        }
+        return sum;
+    }
+
+    static int exceptions(int[] values, int index) {
+        try {
+            return values[index];
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -1;
+        }
+    }
+
+    static List<Integer> allocate(int n) {
+        List<Integer> list = new ArrayList<>();
+        for (int i = 0; i < n; i++) {
+            list.add(i * i);
+        }
+        return list;
+    }
+
+    public static void main(String[] args) {
+        Shape[] shapeArray = {new Square(3), new Rect(2, 5), new Square(4)};
+        int[] values = {1, 2, 3};
+        long sum = 0;
+        double dsum = 0;
+        String last = "";
+        for (int i = 0; i < WARM_UP; i++) {
+            sum += loop(i);
+            dsum += doubles(1.5, i % 10);
+            last = strings(i);
+            sum += shapes(shapeArray);
+            sum += exceptions(values, i % 5);
+            sum += allocate(i % 8).size();
+        }
+        System.out.println("sum " + sum);
+        System.out.println("dsum " + dsum);
+        System.out.println("last " + last);
+        System.out.println("loop " + loop(1000));
+        System.out.println("shapes " + shapes(shapeArray));
+        System.out.println("exceptions " + exceptions(values, 1) + " " + exceptions(values, 9));
+        System.out.println("allocate " + allocate(5));
+    }
+}
@@ -0,0 +1,191 @@
+//寄存器形式解释器和栈解释器的对照 输出需要和JDK一致
+//每个方法调用WARM_UP次 超过registerCodeMethodInvokeCountThreshold后走寄存器形式
+public class RegisterCodeTest {
+
+    static final int WARM_UP = 50;
+
+    static int staticField = 3;
+    int instanceField = 5;
+
+    //分支 循环 int运算
+    static int intBranches(int a, int b) {
+        int r = 0;
+        if (a > b) {
+            r += a - b;
+        } else if (a == b) {
+            r += 100;
+        } else {
+            r -= b - a;
+        }
+        for (int i = 0; i < 10; i++) {
+            if ((i & 1) == 0) {
+                r += i * a;
+            } else {
+                r ^= i << (b & 31);
+            }
+        }
+        while (r > 1000) {
+            r >>= 1;
+        }
+        return r + (a >>> 3) + (a % 7) + (b / 3);
+    }
+
+    static long longMath(long a, long b) {
+        long r = a * b + (a << 40) - (b >> 3) + (a >>> 60);
+        if (a < b) {
+            r = -r;
+        }
+        long q = 0;
+        if (b != 0) {
+            q = a / b;
+        }
+        return r ^ (r % 13) ^ q;
+    }
+
+    static double floatMath(float f, double d) {
+        double r = 0;
+        if (f < 1.5f) {
+            r += f * 2;
+        }
+        if (d >= f) {
+            r += d / f;
+        }
+        //NaN参与比较时fcmpl和fcmpg结果不同
+        if (!(d > 0)) {
+            r -= 1;
+        }
+        if (!(d < 0)) {
+            r += 1;
+        }
+        return r + (int) d + (long) f + (float) d % 3;
+    }
+
+    static int conversions(int i, long l, double d) {
+        return (byte) i + (char) i + (short) i + (int) l + (int) d + (int) (float) l + (int) (d * 1e12);
+    }
+
+    static int arrays(int[] a, long[] b, byte[] c, char[] d) {
+        int r = 0;
+        for (int i = 0; i < a.length; i++) {
+            a[i] = a[i] * 3 + i;
+            r += a[i];
+        }
+        b[0] += r;
+        c[1] = (byte) (c[1] + 200);
+        d[2] = (char) (d[2] - 1);
+        return r + (int) b[0] + c[1] + d[2];
+    }
+
+    //翻译后的块中抛出异常 由本方法的catch处理 处理器在栈解释器中执行
+    static String caughtInside(int a, int b, int[] array, int index) {
+        try {
+            int q = a / b;
+            return "q=" + q + " v=" + array[index];
+        } catch (ArithmeticException e) {
+            return "arithmetic";
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return "bounds";
+        } catch (NullPointerException e) {
+            return "npe";
+        }
+    }
+
+    static long divide(long a, long b) {
+        return a / b + a % b;
+    }
+
+    static int load(int[] array, int index) {
+        return array[index] + 1;
+    }
+
+    //异常从寄存器形式的方法传播到调用方
+    static String propagated(long a, long b, int[] array, int index) {
+        try {
+            return "divide=" + divide(a, b) + " load=" + load(array, index);
+        } catch (ArithmeticException e) {
+            return "arithmetic";
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return "bounds";
+        } catch (NullPointerException e) {
+            return "npe";
+        }
+    }
+
+    //包含调用 字段访问 switch的块回到栈解释器执行
+    int fallbackBlocks(int a) {
+        int r = a + 1;
+        r += instanceField;
+        staticField += 1;
+        switch (r & 3) {
+            case 0:
+                r += 10;
+                break;
+            case 1:
+                r -= 10;
+                break;
+            default:
+                r *= 2;
+        }
+        r += Math.abs(-a);
+        for (int i = 0; i < 5; i++) {
+            r += i;
+        }
+        instanceField = r & 7;
+        return r;
+    }
+
+    //条件表达式的值跨块留在操作数栈上 整个方法不翻译
+    static int ternaryJoin(int a, int b) {
+        return (a > b ? a : b) + (a == 0 ? 1 : 2);
+    }
+
+    static int recursive(int n) {
+        if (n <= 1) {
+            return 1;
+        }
+        return n + recursive(n - 1);
+    }
+
+    public static void main(String[] args) {
+        long intSum = 0;
+        long longSum = 0;
+        double floatSum = 0;
+        long conversionSum = 0;
+        long arraySum = 0;
+        long fallbackSum = 0;
+        long ternarySum = 0;
+        long recursiveSum = 0;
+        RegisterCodeTest test = new RegisterCodeTest();
+        for (int i = 0; i < WARM_UP; i++) {
+            intSum += intBranches(i * 37 - 500, i - 25);
+            longSum += longMath(i * 0x123456789L, i - 7);
+            floatSum += floatMath(i * 0.25f, i * 1.5 - 20);
+            conversionSum += conversions(i * 12345, i * 0x1_0000_0001L, i * -3.75);
+            arraySum += arrays(new int[]{i, 2, 3}, new long[]{i}, new byte[]{1, (byte) i}, new char[]{'a', 'b', (char) i});
+            fallbackSum += test.fallbackBlocks(i);
+            ternarySum += ternaryJoin(i, 25);
+            recursiveSum += recursive(i % 10);
+        }
+        System.out.println("intBranches " + intSum);
+        System.out.println("longMath " + longSum);
+        System.out.println("floatMath " + floatSum);
+        System.out.println("conversions " + conversionSum);
+        System.out.println("arrays " + arraySum);
+        System.out.println("fallbackBlocks " + fallbackSum + " " + staticField + " " + test.instanceField);
+        System.out.println("ternaryJoin " + ternarySum);
+        System.out.println("recursive " + recursiveSum);
+        System.out.println("special " + floatMath(Float.NaN, Double.NaN) + " " + floatMath(0f, Double.POSITIVE_INFINITY)
+                           + " " + conversions(Integer.MIN_VALUE, Long.MAX_VALUE, Double.NaN)
+                           + " " + intBranches(Integer.MIN_VALUE, -1) + " " + longMath(Long.MIN_VALUE, -1));
+
+        int[] array = {1, 2, 3};
+        for (int i = 0; i < WARM_UP; i++) {
+            caughtInside(i, 1, array, 0);
+            propagated(i, 1, array, 0);
+        }
+        System.out.println(caughtInside(7, 2, array, 2) + " " + caughtInside(7, 0, array, 0) + " "
+                           + caughtInside(7, 1, array, 3) + " " + caughtInside(7, 1, null, 0));
+        System.out.println(propagated(7, 2, array, 2) + " " + propagated(7, 0, array, 0) + " "
+                           + propagated(7, 1, array, -1) + " " + propagated(7, 1, null, 0));
+    }
+}
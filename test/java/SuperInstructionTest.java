@@ -0,0 +1,94 @@
+//覆盖超级指令替换的指令序列 输出需要和JDK一致
+//aload_0;getfield aload_0;invokespecial iload;iload;if_icmpge aload;arraylength iinc;goto
+public class SuperInstructionTest {
+
+    private int value;
+    private long total;
+
+    SuperInstructionTest(int value) {
+        super();
+        this.value = value;
+    }
+
+    int getValue() {
+        return value;
+    }
+
+    private int twice() {
+        return value * 2;
+    }
+
+    int callPrivate() {
+        return this.twice();
+    }
+
+    static int countBelow(int limit, int step) {
+        int count = 0;
+        for (int i = 0; i < limit; i += step) {
+            count++;
+        }
+        return count;
+    }
+
+    static int nestedLoops(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = i; j < n; j++) {
+                sum += i ^ j;
+            }
+        }
+        return sum;
+    }
+
+    static int wideLocals(int a, int b, int c, int d, int e, int f) {
+        //第4个以后的int局部变量使用iload index
+        int hit = 0;
+        if (e >= f) {
+            hit |= 1;
+        }
+        if (a >= b) {
+            hit |= 2;
+        }
+        if (c >= d) {
+            hit |= 4;
+        }
+        return hit;
+    }
+
+    static int arrayLengths(int[] a, long[] b, Object[] c, int[][] d) {
+        int[] local = a;
+        return a.length + b.length + c.length + d.length + local.length;
+    }
+
+    static String nullArrayLength(int[] array) {
+        try {
+            return "length " + array.length;
+        } catch (NullPointerException e) {
+            return "NPE";
+        }
+    }
+
+    long accumulate(int n) {
+        for (int i = 0; i < n; i++) {
+            total += this.value + i;
+        }
+        return this.total;
+    }
+
+    public static void main(String[] args) {
+        SuperInstructionTest test = new SuperInstructionTest(7);
+        System.out.println("getValue " + test.getValue());
+        System.out.println("callPrivate " + test.callPrivate());
+        for (int step = 1; step <= 4; step++) {
+            System.out.println("countBelow " + step + " " + countBelow(100, step));
+        }
+        System.out.println("countBelow empty " + countBelow(0, 1));
+        System.out.println("countBelow negative " + countBelow(-5, 1));
+        System.out.println("nestedLoops " + nestedLoops(50));
+        System.out.println("wideLocals " + wideLocals(1, 2, 3, 3, 9, 8) + " " + wideLocals(5, 2, 1, 3, 8, 9));
+        System.out.println("arrayLengths " + arrayLengths(new int[3], new long[5], new Object[7], new int[2][4]));
+        System.out.println("nullArrayLength " + nullArrayLength(new int[4]) + " " + nullArrayLength(null));
+        System.out.println("accumulate " + test.accumulate(10) + " " + test.accumulate(1000));
+        System.out.println("minValue " + countBelow(Integer.MIN_VALUE, 1) + " " + wideLocals(Integer.MIN_VALUE, Integer.MAX_VALUE, 0, 0, 0, 0));
+    }
+}
@@ -0,0 +1,197 @@
+#!/usr/bin/env bash
+# 解释器和持久化格式的端到端测试 需要JDK8
+# 先用JDK运行test/java下的程序得到期望输出 再用rex按不同参数运行 标准输出必须一致
+# 用法: JAVA_HOME=<jdk8> test/run_java_tests.sh <rex可执行文件> [测试类名...]
+set -u
+
+if [ $# -lt 1 ]; then
+    echo "usage: JAVA_HOME=<jdk8> $0 <rex> [TestClass...]"
+    exit 2
+fi
+REX=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+shift
+if [ -z "${JAVA_HOME:-}" ] || [ ! -x "$JAVA_HOME/bin/javac" ]; then
+    echo "JAVA_HOME must point to a JDK 8"
+    exit 2
+fi
+
+TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(mktemp -d "${TMPDIR:-/tmp}/rex_java_test.XXXXXX")
+CLASSES=$WORK_DIR/classes
+mkdir -p "$CLASSES"
+"$JAVA_HOME/bin/javac" -source 8 -target 8 -nowarn -d "$CLASSES" "$TEST_DIR"/java/*.java || exit 1
+# 类归档只保存jar中的类 测试类也打一份jar
+TEST_JAR=$WORK_DIR/tests.jar
+"$JAVA_HOME/bin/jar" cf "$TEST_JAR" -C "$CLASSES" . || exit 1
+
+if [ $# -gt 0 ]; then
+    TESTS=("$@")
+else
+    TESTS=()
+    for source in "$TEST_DIR"/java/*Test.java; do
+        TESTS+=("$(basename "$source" .java)")
+    done
+fi
+
+# 栈解释器(-Xint)是基准 每种解释器组合 不做推测的JIT和默认配置(可能开启JIT)都要得到同样的输出
+VARIANTS=(
+    "-Xint"
+    "-Xint -XX:+UseSuperInstructions"
+    "-Xint -XX:+UseRegisterCode"
+    "-Xint -XX:+UseSuperInstructions -XX:+UseRegisterCode"
+    "-XX:-JitSpeculate"
+    ""
+)
+
+FAILED=0
+
+# debug+JIT构建退出时会打印编译统计 不属于程序输出
+# REX_CLASSPATH可以换成测试类的jar
+runRex() {
+    "$REX" -cp "${REX_CLASSPATH:-$CLASSES}" "$@" 2>"$WORK_DIR/stderr" | grep -v -E '^jit (compile success|code cache hit)'
+    return "${PIPESTATUS[0]}"
+}
+
+report() {
+    local name=$1
+    local expectedFile=$2
+    local actualFile=$3
+    if diff -u "$expectedFile" "$actualFile" >"$WORK_DIR/diff"; then
+        echo "[ OK ] $name"
+    else
+        echo "[FAIL] $name"
+        cat "$WORK_DIR/diff"
+        cat "$WORK_DIR/stderr"
+        FAILED=$((FAILED + 1))
+    fi
+}
+
+fail() {
+    echo "[FAIL] $1"
+    cat "$WORK_DIR/stderr"
+    FAILED=$((FAILED + 1))
+}
+
+# 把文件中offset处的一个字节取反
+flipByte() {
+    local file=$1
+    local offset=$2
+    local byte
+    byte=$(od -An -tu1 -j"$offset" -N1 "$file" | tr -d ' ')
+    # shellcheck disable=SC2059
+    printf "\\$(printf '%03o' $((255 - byte)))" | dd of="$file" bs=1 seek="$offset" count=1 conv=notrunc 2>/dev/null
+}
+
+# 堆快照: dump 恢复 过期(stamp不一致)三种情况下输出都要和JDK一致
+heapSnapshotTest() {
+    local test=$1
+    local snapshot=$WORK_DIR/$test.snapshot
+    local expected=$WORK_DIR/$test.expected
+    local actual=$WORK_DIR/$test.actual
+
+    runRex -XX:HeapSnapshotFile="$snapshot" -XX:+DumpHeapSnapshot "$test" >"$actual"
+    report "$test snapshot dump" "$expected" "$actual"
+    if [ ! -s "$snapshot" ]; then
+        fail "$test snapshot dump: no snapshot written"
+        return
+    fi
+
+    runRex -XX:HeapSnapshotFile="$snapshot" "$test" >"$actual"
+    report "$test snapshot restore" "$expected" "$actual"
+    if grep -q "heap snapshot" "$WORK_DIR/stderr"; then
+        fail "$test snapshot restore: snapshot was not used"
+    fi
+
+    # SnapshotHeader的stamp从第8个字节开始
+    flipByte "$snapshot" 8
+    runRex -XX:HeapSnapshotFile="$snapshot" "$test" >"$actual"
+    report "$test snapshot stale" "$expected" "$actual"
+    if ! grep -q "heap snapshot is stale or corrupted" "$WORK_DIR/stderr"; then
+        fail "$test snapshot stale: stale snapshot was not rejected"
+    fi
+}
+
+# 类归档: 从jar加载并dump 使用归档 过期(stamp不一致)三种情况下输出都要和JDK一致
+classArchiveTest() {
+    local test=$1
+    local archive=$WORK_DIR/$test.jsa
+    local expected=$WORK_DIR/$test.expected
+    local actual=$WORK_DIR/$test.actual
+    local REX_CLASSPATH=$TEST_JAR
+
+    runRex -XX:SharedArchiveFile="$archive" -Xshare:dump "$test" >"$actual"
+    report "$test archive dump" "$expected" "$actual"
+    if [ ! -s "$archive" ]; then
+        fail "$test archive dump: no archive written"
+        return
+    fi
+
+    runRex -XX:SharedArchiveFile="$archive" "$test" >"$actual"
+    report "$test archive use" "$expected" "$actual"
+    if grep -q "class archive" "$WORK_DIR/stderr"; then
+        fail "$test archive use: archive was not used"
+    fi
+
+    # ArchiveHeader的stamp从第8个字节开始
+    flipByte "$archive" 8
+    runRex -XX:SharedArchiveFile="$archive" "$test" >"$actual"
+    report "$test archive stale" "$expected" "$actual"
+    if ! grep -q "class archive is stale or corrupted" "$WORK_DIR/stderr"; then
+        fail "$test archive stale: stale archive was not rejected"
+    fi
+}
+
+# JIT代码缓存: 写入缓存 使用缓存 JIT参数变化(缓存key不同)三种情况下输出都要和JDK一致
+# rex没有开启JIT时不会生成目标文件 只比较输出
+jitCodeCacheTest() {
+    local test=$1
+    local cacheDir=$WORK_DIR/$test.jitcache
+    local expected=$WORK_DIR/$test.expected
+    local actual=$WORK_DIR/$test.actual
+
+    runRex -XX:JitCodeCacheDir="$cacheDir" "$test" >"$actual"
+    report "$test code cache write" "$expected" "$actual"
+    local objectCount
+    objectCount=$(find "$cacheDir" -name '*.o' 2>/dev/null | wc -l)
+    if [ "$objectCount" -eq 0 ]; then
+        echo "[SKIP] $test code cache: no object written, rex built without JIT"
+        return
+    fi
+
+    # 推测优化依赖编译时的profile 重新编译的方法可能生成新的目标文件 这里只比较输出
+    runRex -XX:JitCodeCacheDir="$cacheDir" "$test" >"$actual"
+    report "$test code cache use" "$expected" "$actual"
+
+    runRex -XX:JitCodeCacheDir="$cacheDir" -XX:-JitVectorize "$test" >"$actual"
+    report "$test code cache other key" "$expected" "$actual"
+    if [ "$(find "$cacheDir" -name '*.o' | wc -l)" -le "$objectCount" ]; then
+        fail "$test code cache other key: objects compiled with other options were reused"
+    fi
+}
+
+for test in "${TESTS[@]}"; do
+    "$JAVA_HOME/bin/java" -cp "$CLASSES" "$test" >"$WORK_DIR/$test.expected" 2>/dev/null
+    for variant in "${VARIANTS[@]}"; do
+        # shellcheck disable=SC2086
+        runRex $variant "$test" >"$WORK_DIR/$test.actual"
+        report "$test ${variant:-default}" "$WORK_DIR/$test.expected" "$WORK_DIR/$test.actual"
+    done
+    case "$test" in
+        HeapSnapshotTest)
+            heapSnapshotTest "$test"
+            ;;
+        ClassArchiveTest)
+            classArchiveTest "$test"
+            ;;
+        JitCodeCacheTest)
+            jitCodeCacheTest "$test"
+            ;;
+    esac
+done
+
+if [ "$FAILED" -ne 0 ]; then
+    echo "$FAILED failed, output kept in $WORK_DIR"
+    exit 1
+fi
+rm -rf "$WORK_DIR"
+echo "all passed"
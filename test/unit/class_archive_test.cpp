@@ -0,0 +1,101 @@
+#include "unit_test.hpp"
+#include <filesystem>
+#include <fstream>
+#include "utils/class_archive.hpp"
+#include "utils/class_path.hpp"
+#include "utils/file_utils.hpp"
+#include "os_platform.hpp"
+
+namespace RexVM::Test {
+
+    constexpr u8 ARCHIVE_TEST_STAMP = 0x1234;
+
+    cstring writeTestArchive(const cview name, const u8 stamp) {
+        const auto path = getTempPath(name);
+        ClassArchive archive(path, stamp, true);
+        archive.recordClass("java/lang/Object.class", 0, "object bytes");
+        archive.recordClass("com/example/Main.class", 1, cview("main\0bytes", 10));
+        archive.recordClass("a/A.class", 1, "");
+        archive.writeArchive();
+        return path;
+    }
+
+    cstring getArchiveBytes(const ClassArchive &archive, const cview name) {
+        const auto entry = archive.findClass(name);
+        if (entry == nullptr) {
+            return "<missing>";
+        }
+        const auto bytes = archive.getBytes(*entry);
+        return {reinterpret_cast<const char *>(bytes->data), bytes->length};
+    }
+
+    TEST_CASE(classArchiveRoundTrip) {
+        const auto path = writeTestArchive("round_trip.jsa", ARCHIVE_TEST_STAMP);
+        const ClassArchive archive(path, ARCHIVE_TEST_STAMP, false);
+        CHECK(archive.isMapped());
+        CHECK(archive.classCount == 3);
+        CHECK(getArchiveBytes(archive, "java/lang/Object.class") == "object bytes");
+        CHECK(getArchiveBytes(archive, "com/example/Main.class") == cstring("main\0bytes", 10));
+        CHECK(getArchiveBytes(archive, "a/A.class").empty());
+        CHECK(archive.findClass("java/lang/String.class") == nullptr);
+        CHECK(archive.findClass("com/example/Main.clas") == nullptr);
+        const auto entry = archive.findClass("com/example/Main.class");
+        CHECK(entry != nullptr && entry->classPathIndex == 1);
+    }
+
+    TEST_CASE(classArchiveRejectsStaleStamp) {
+        //classpath或VM可执行文件变化后stamp不同 整个归档作废
+        const auto path = writeTestArchive("stale.jsa", ARCHIVE_TEST_STAMP);
+        const ClassArchive archive(path, ARCHIVE_TEST_STAMP + 1, false);
+        CHECK(!archive.isMapped());
+        CHECK(archive.findClass("java/lang/Object.class") == nullptr);
+    }
+
+    TEST_CASE(classArchiveRejectsTruncatedFile) {
+        const auto path = writeTestArchive("truncated.jsa", ARCHIVE_TEST_STAMP);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+        const ClassArchive archive(path, ARCHIVE_TEST_STAMP, false);
+        CHECK(!archive.isMapped());
+
+        const auto headerOnly = writeTestArchive("header_only.jsa", ARCHIVE_TEST_STAMP);
+        std::filesystem::resize_file(headerOnly, sizeof(ArchiveHeader) + sizeof(ArchiveEntry));
+        const ClassArchive headerOnlyArchive(headerOnly, ARCHIVE_TEST_STAMP, false);
+        CHECK(!headerOnlyArchive.isMapped());
+    }
+
+    TEST_CASE(writeFileAtomicallyReplacesFile) {
+        const auto path = getTempPath("atomic.txt");
+        CHECK(writeFileAtomically(path, [](std::ostream &os) { os << "first"; }));
+        CHECK(writeFileAtomically(path, [](std::ostream &os) { os << "second"; }));
+        std::ifstream is(path);
+        cstring content;
+        is >> content;
+        CHECK(content == "second");
+        CHECK(!std::filesystem::exists(cformat("{}.{}", path, getProcessId())));
+    }
+
+    TEST_CASE(writeFileAtomicallyCleansUpOnFailure) {
+        //写入失败时不替换原文件 也不留下临时文件
+        const auto path = getTempPath("atomic_fail.txt");
+        CHECK(writeFileAtomically(path, [](std::ostream &os) { os << "keep"; }));
+        CHECK(!writeFileAtomically(path, [](std::ostream &os) {
+            os << "partial";
+            os.setstate(std::ios::badbit);
+        }));
+        std::ifstream is(path);
+        cstring content;
+        is >> content;
+        CHECK(content == "keep");
+        CHECK(!std::filesystem::exists(cformat("{}.{}", path, getProcessId())));
+
+        const auto missingDir = getTempPath("missing_dir/file.txt");
+        CHECK(!writeFileAtomically(missingDir, [](std::ostream &os) { os << "x"; }));
+        CHECK(!std::filesystem::exists(missingDir));
+    }
+
+    TEST_CASE(vmBuildStampIsStable) {
+        CHECK(getVMBuildStamp() != 0);
+        CHECK(getVMBuildStamp() == getVMBuildStamp());
+    }
+
+}
@@ -0,0 +1,70 @@
+#include "unit_test.hpp"
+#include <cstring>
+#include "vm.hpp"
+#include "heap_snapshot.hpp"
+//VM的析构函数需要完整类型
+#include "utils/class_path.hpp"
+#include "utils/class_archive.hpp"
+#include "class_loader.hpp"
+#include "string_pool.hpp"
+#include "thread.hpp"
+#include "memory.hpp"
+#include "garbage_collect.hpp"
+#include "jit_manager.hpp"
+
+namespace RexVM::Test {
+
+    //只测文件头的校验 完整的dump和恢复需要JDK 见test/run_java_tests.sh中的HeapSnapshotTest
+    SnapshotHeader createSnapshotHeader(const VM &vm) {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, "REXHEAP1", sizeof(header.magic));
+        header.stamp = getHeapSnapshotStamp(vm);
+        return header;
+    }
+
+    bool isValid(const VM &vm, const SnapshotHeader &header) {
+        return isHeapSnapshotHeaderValid(vm, reinterpret_cast<const u1 *>(&header), sizeof(SnapshotHeader));
+    }
+
+    TEST_CASE(heapSnapshotAcceptsCurrentStamp) {
+        ApplicationParameter params;
+        VM vm(params);
+        vm.javaHome = "/opt/jdk8";
+        vm.classPathStamp = 42;
+        CHECK(isValid(vm, createSnapshotHeader(vm)));
+    }
+
+    TEST_CASE(heapSnapshotRejectsStaleStamp) {
+        ApplicationParameter params;
+        VM vm(params);
+        vm.javaHome = "/opt/jdk8";
+        vm.classPathStamp = 42;
+        const auto header = createSnapshotHeader(vm);
+
+        //classpath中的jar变化
+        vm.classPathStamp = 43;
+        CHECK(!isValid(vm, header));
+        vm.classPathStamp = 42;
+
+        //换了JAVA_HOME
+        vm.javaHome = "/opt/other-jdk8";
+        CHECK(!isValid(vm, header));
+        vm.javaHome = "/opt/jdk8";
+
+        //其他VM写出的快照
+        auto otherBuild = header;
+        otherBuild.stamp ^= 1;
+        CHECK(!isValid(vm, otherBuild));
+        CHECK(isValid(vm, header));
+    }
+
+    TEST_CASE(heapSnapshotRejectsBadHeader) {
+        ApplicationParameter params;
+        VM vm(params);
+        auto header = createSnapshotHeader(vm);
+        CHECK(!isHeapSnapshotHeaderValid(vm, reinterpret_cast<const u1 *>(&header), sizeof(SnapshotHeader) - 1));
+        header.magic[7] = '0';
+        CHECK(!isValid(vm, header));
+    }
+
+}
@@ -0,0 +1,71 @@
+#ifdef LLVM_JIT
+#include "unit_test.hpp"
+#include <filesystem>
+#include <fstream>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include "jit/llvm_jit_object_cache.hpp"
+
+namespace RexVM::Test {
+
+    constexpr u8 CACHE_TEST_METHOD_KEY = 0x0123456789abcdefULL;
+    constexpr cview CACHE_TEST_OBJECT = "\x7f" "ELF cached object";
+
+    cstring createCacheDir(const cview name) {
+        const auto dir = getTempPath(name);
+        std::filesystem::remove_all(dir);
+        return dir;
+    }
+
+    TEST_CASE(jitObjectCacheRoundTrip) {
+        const auto dir = createCacheDir("jit_cache_round_trip");
+        llvm::LLVMContext context;
+        llvm::Module module(JITObjectCache::getModuleIdentifier(CACHE_TEST_METHOD_KEY, 42), context);
+        {
+            JITObjectCache cache(dir);
+            CHECK(!cache.containsMethod(CACHE_TEST_METHOD_KEY));
+            CHECK(cache.getObject(&module) == nullptr);
+            cache.notifyObjectCompiled(&module, llvm::MemoryBufferRef(CACHE_TEST_OBJECT, "object"));
+            CHECK(cache.containsMethod(CACHE_TEST_METHOD_KEY));
+            CHECK(cache.containsObject(module.getModuleIdentifier()));
+        }
+
+        //另一个VM启动时扫描目录得到已缓存的方法
+        JITObjectCache cache(dir);
+        CHECK(cache.containsMethod(CACHE_TEST_METHOD_KEY));
+        const auto object = cache.getObject(&module);
+        CHECK(object != nullptr && object->getBuffer().str() == CACHE_TEST_OBJECT);
+        CHECK(cache.hitCnt == 1);
+    }
+
+    TEST_CASE(jitObjectCacheMissesOtherBuildOrIR) {
+        //VM可执行文件 LLVM版本 CPU或JIT参数变化时methodKey不同 IR变化时irHash不同 都不会命中旧的目标文件
+        const auto dir = createCacheDir("jit_cache_stale");
+        llvm::LLVMContext context;
+        llvm::Module module(JITObjectCache::getModuleIdentifier(CACHE_TEST_METHOD_KEY, 42), context);
+        JITObjectCache cache(dir);
+        cache.notifyObjectCompiled(&module, llvm::MemoryBufferRef(CACHE_TEST_OBJECT, "object"));
+
+        llvm::Module otherBuild(JITObjectCache::getModuleIdentifier(CACHE_TEST_METHOD_KEY ^ 1, 42), context);
+        CHECK(!cache.containsMethod(CACHE_TEST_METHOD_KEY ^ 1));
+        CHECK(cache.getObject(&otherBuild) == nullptr);
+        llvm::Module otherIR(JITObjectCache::getModuleIdentifier(CACHE_TEST_METHOD_KEY, 43), context);
+        CHECK(!cache.containsObject(otherIR.getModuleIdentifier()));
+        CHECK(cache.getObject(&otherIR) == nullptr);
+        CHECK(cache.hitCnt == 0);
+    }
+
+    TEST_CASE(jitObjectCacheIgnoresForeignFiles) {
+        //目录中的临时文件和其他文件不计入已缓存的方法
+        const auto dir = createCacheDir("jit_cache_foreign");
+        std::filesystem::create_directories(dir);
+        std::ofstream(cformat("{}/{}.o.1234", dir, JITObjectCache::getModuleIdentifier(CACHE_TEST_METHOD_KEY, 1)));
+        std::ofstream(cformat("{}/readme.txt", dir));
+        std::ofstream(cformat("{}/short.o", dir));
+        JITObjectCache cache(dir);
+        CHECK(!cache.containsMethod(CACHE_TEST_METHOD_KEY));
+        CHECK(cache.methodKeys.empty());
+    }
+
+}
+#endif
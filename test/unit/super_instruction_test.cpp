@@ -0,0 +1,60 @@
+#include "unit_test.hpp"
+#include "opcode.hpp"
+
+namespace RexVM::Test {
+
+    constexpr u1 op(OpCodeEnum opCode) {
+        return CAST_U1(opCode);
+    }
+
+    TEST_CASE(superInstructionReplacesOnlyFirstOpCode) {
+        const u1 code[] = {
+            op(OpCodeEnum::ALOAD_0), op(OpCodeEnum::GETFIELD), 0x00, 0x02,                           //0
+            op(OpCodeEnum::ILOAD_1), op(OpCodeEnum::ILOAD), 0x02, op(OpCodeEnum::IF_ICMPGE), 0x00, 0x0C, //4
+            op(OpCodeEnum::IINC), 0x01, 0x01, op(OpCodeEnum::GOTO), 0xFF, 0xF7,                         //10
+            op(OpCodeEnum::ALOAD_2), op(OpCodeEnum::ARRAYLENGTH),                                        //16
+            op(OpCodeEnum::RETURN),                                                                      //18
+        };
+        const auto superCode = createSuperInstructionCode(code, sizeof(code));
+        CHECK(superCode != nullptr);
+        if (superCode == nullptr) {
+            return;
+        }
+        CHECK(superCode[0] == op(OpCodeEnum::SUPER_ALOAD_0_GETFIELD));
+        CHECK(superCode[4] == op(OpCodeEnum::SUPER_ILOAD_1_ILOAD_IF_ICMPGE));
+        CHECK(superCode[10] == op(OpCodeEnum::SUPER_IINC_GOTO));
+        CHECK(superCode[16] == op(OpCodeEnum::SUPER_ALOAD_2_ARRAYLENGTH));
+        //其余字节(后续指令和操作数)不变 pc和跳转目标都保持原样
+        for (size_t pc = 0; pc < sizeof(code); ++pc) {
+            if (pc != 0 && pc != 4 && pc != 10 && pc != 16) {
+                CHECK(superCode[pc] == code[pc]);
+            }
+        }
+    }
+
+    TEST_CASE(superInstructionSkipsSwitchOperands) {
+        //tableswitch的offset里恰好是 aload_0 getfield 的字节 按指令长度跳过 不能匹配
+        const u1 code[] = {
+            op(OpCodeEnum::TABLESWITCH), 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x14, //default
+            0x00, 0x00, 0x00, 0x00, //low
+            0x00, 0x00, 0x00, 0x00, //high
+            0x00, 0x00, op(OpCodeEnum::ALOAD_0), op(OpCodeEnum::GETFIELD),
+            op(OpCodeEnum::RETURN),
+        };
+        CHECK(createSuperInstructionCode(code, sizeof(code)) == nullptr);
+    }
+
+    TEST_CASE(superInstructionIgnoresTruncatedSequence) {
+        //序列的后半部分超出代码范围时不替换
+        const u1 code[] = {
+            op(OpCodeEnum::ILOAD_0), op(OpCodeEnum::ILOAD_1),
+        };
+        CHECK(createSuperInstructionCode(code, sizeof(code)) == nullptr);
+        const u1 tail[] = {
+            op(OpCodeEnum::NOP), op(OpCodeEnum::ALOAD_0),
+        };
+        CHECK(createSuperInstructionCode(tail, sizeof(tail)) == nullptr);
+    }
+
+}
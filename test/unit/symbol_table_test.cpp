@@ -0,0 +1,76 @@
+#include "unit_test.hpp"
+#include <thread>
+#include <atomic>
+#include "symbol_table.hpp"
+#include "utils/format.hpp"
+
+namespace RexVM::Test {
+
+    TEST_CASE(symbolTableInternReturnsSameSymbol) {
+        SymbolTable symbolTable;
+        const auto name = symbolTable.intern("java/lang/Object");
+        CHECK(name->view() == "java/lang/Object");
+        CHECK(symbolTable.intern(cstring("java/lang/") + "Object") == name);
+        CHECK(symbolTable.find("java/lang/Object") == name);
+        CHECK(symbolTable.find("java/lang/String") == nullptr);
+        CHECK(symbolTable.intern("") == symbolTable.find(""));
+    }
+
+    TEST_CASE(symbolTableFindAfterGrow) {
+        SymbolTable symbolTable;
+        constexpr size_t count = SYMBOL_TABLE_INIT_CAPACITY * 3;
+        std::vector<const Symbol *> symbols;
+        for (size_t i = 0; i < count; ++i) {
+            symbols.emplace_back(symbolTable.intern(cformat("symbol_{}", i)));
+        }
+        CHECK(symbolTable.tables.size() > 1);
+        size_t mismatch = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (symbolTable.find(cformat("symbol_{}", i)) != symbols[i]) {
+                ++mismatch;
+            }
+        }
+        CHECK(mismatch == 0);
+    }
+
+    TEST_CASE(symbolTableConcurrentFindAndIntern) {
+        //查找不加锁 写入和扩容的同时查找 已驻留的Symbol必须一直能找到
+        SymbolTable symbolTable;
+        const auto stable = symbolTable.intern("stable");
+        std::atomic_bool stop{false};
+        std::atomic_size_t wrongFind{0};
+        std::vector<std::thread> readers;
+        for (size_t i = 0; i < 4; ++i) {
+            readers.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    if (symbolTable.find("stable") != stable) {
+                        ++wrongFind;
+                    }
+                    if (const auto symbol = symbolTable.find("writer_100"); symbol != nullptr && symbol->view() != "writer_100") {
+                        ++wrongFind;
+                    }
+                }
+            });
+        }
+        std::vector<std::thread> writers;
+        for (size_t i = 0; i < 2; ++i) {
+            writers.emplace_back([&symbolTable] {
+                for (size_t j = 0; j < SYMBOL_TABLE_INIT_CAPACITY * 2; ++j) {
+                    if (symbolTable.intern(cformat("writer_{}", j))->view() != cformat("writer_{}", j)) {
+                        return;
+                    }
+                }
+            });
+        }
+        for (auto &writer : writers) {
+            writer.join();
+        }
+        stop = true;
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        CHECK(wrongFind == 0);
+        CHECK(symbolTable.symbolCount == SYMBOL_TABLE_INIT_CAPACITY * 2 + 1);
+    }
+
+}
@@ -0,0 +1,55 @@
+#include "unit_test.hpp"
+#include <cstring>
+#include <filesystem>
+#include "utils/format.hpp"
+#include "os_platform.hpp"
+
+namespace RexVM::Test {
+
+    std::vector<TestCase> &getTestCases() {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    TestRegister::TestRegister(const char *name, const TestFunction function) {
+        getTestCases().emplace_back(TestCase{name, function});
+    }
+
+    size_t failureCount{0};
+
+    void reportFailure(const char *file, const int line, const char *expression) {
+        ++failureCount;
+        cprintlnErr("    {}:{}: CHECK({}) failed", file, line, expression);
+    }
+
+    cstring getTempPath(const cview name) {
+        const auto dir = std::filesystem::temp_directory_path() / cformat("rex_test_{}", getProcessId());
+        std::error_code errorCode;
+        std::filesystem::create_directories(dir, errorCode);
+        return (dir / name).string();
+    }
+
+}
+
+int main(const int argc, char *argv[]) {
+    using namespace RexVM::Test;
+    const auto filter = argc > 1 ? argv[1] : "";
+    size_t runCount = 0;
+    size_t failedCount = 0;
+    for (const auto &[name, function] : getTestCases()) {
+        if (strncmp(name, filter, strlen(filter)) != 0) {
+            continue;
+        }
+        const auto before = failureCount;
+        function();
+        ++runCount;
+        if (failureCount != before) {
+            ++failedCount;
+            RexVM::cprintln("[FAIL] {}", name);
+        } else {
+            RexVM::cprintln("[ OK ] {}", name);
+        }
+    }
+    RexVM::cprintln("{} tests, {} failed", runCount, failedCount);
+    return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#ifndef UNIT_TEST_HPP
+#define UNIT_TEST_HPP
+#include <vector>
+#include "basic.hpp"
+
+//不依赖JDK的单元测试 xmake build rex_test && xmake run rex_test [用例名前缀]
+//VM编译时关闭了异常 CHECK失败只记录 用例继续执行
+namespace RexVM::Test {
+
+    using TestFunction = void (*)();
+
+    struct TestCase {
+        const char *name;
+        TestFunction function;
+    };
+
+    std::vector<TestCase> &getTestCases();
+
+    struct TestRegister {
+        explicit TestRegister(const char *name, TestFunction function);
+    };
+
+    void reportFailure(const char *file, int line, const char *expression);
+
+    //临时目录下的文件路径 每个进程独立 用例结束后不删除 方便排查
+    cstring getTempPath(cview name);
+
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const RexVM::Test::TestRegister name##Register(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) { \
+            RexVM::Test::reportFailure(__FILE__, __LINE__, #expression); \
+        } \
+    } while (false)
+
+#endif
@@ -67,3 +67,34 @@ if get_config("llvm-jit") then
 end
 
 target_end()
+
+-- 单元测试 不依赖JDK: xmake build rex_test && xmake run rex_test
+-- 需要JDK的端到端测试见 test/run_java_tests.sh
+target("rex_test")
+    set_kind("binary")
+    set_default(false)
+    add_includedirs(
+        "third_party/miniz",
+        "third_party/fmt/include",
+        "third_party/emhash",
+        "src",
+        "test/unit"
+    )
+    add_files(
+        "src/*.cpp|main.cpp",
+        "src/utils/*.cpp",
+        "src/native/*.cpp",
+        "src/native/core/*.cpp",
+        "src/native/misc/*.cpp",
+        "src/native/sun/*.cpp",
+        "src/native/rex/*.cpp",
+        "test/unit/*.cpp",
+
+        "third_party/miniz/miniz.c"
+    )
+
+if get_config("llvm-jit") then
+    add_files("src/jit/*.cpp")
+end
+
+target_end()